@@ -535,6 +535,24 @@ namespace quda
       */
     void unpackGhost(const void *ghost_spinor, const int dim, const QudaDirection dir, const qudaStream_t &stream);
 
+    /**
+       @brief Compress the host-staged halo in a given dimension and
+       direction and initiate its sending (see halo_compress.h).  A
+       previous send from the same buffer that has not been retired
+       is waited on first, since its buffer is overwritten.
+       @param[in] dim The dimension we are sending
+       @param[in] dir The direction we are sending (0=backwards,1=forwards)
+    */
+    void sendCompressed(int dim, int dir);
+
+    /**
+       @brief Decompress a received host-staged halo into the pinned
+       receive buffer, ready for the scatter (or zero-copy read)
+       @param[in] dim The dimension we received
+       @param[in] dir The direction we received from (0=backwards,1=forwards)
+    */
+    void recvDecompress(int dim, int dir);
+
     /**
        @brief Copies the ghost to the host from the device, prior to
        communication.
@@ -593,6 +611,20 @@ namespace quda
     */
     void commsWait(int d, const qudaStream_t &stream, bool gdr_send = false, bool gdr_recv = false);
 
+    /**
+       @brief Start the exchange of all host-staged halos with a
+       single neighborhood collective.  All halos must have been
+       gathered to the host before calling this.  Halos are always
+       sent uncompressed on this path.
+    */
+    void neighborExchangeStart();
+
+    /**
+       @brief Wait for the neighborhood collective halo exchange to
+       complete, after which the halos may be scattered.
+    */
+    void neighborExchangeWait();
+
     /**
        @brief Unpacks the ghost from host to device after
        communication has finished.
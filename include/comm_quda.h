@@ -336,6 +336,12 @@ extern "C" {
   */
   bool comm_gdr_blacklist();
 
+  /**
+     @brief Query if halo exchange with neighborhood collectives is
+     enabled (global setting, QUDA_ENABLE_NEIGHBOR_COLLECTIVE=1)
+  */
+  bool comm_neighbor_exchange_enabled();
+
   /**
      Create a persistent message handler for a relative send
      @param buffer Buffer from which message will be sent
@@ -376,7 +382,37 @@ extern "C" {
   MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displacement[],
 						    size_t blksize, int nblocks, size_t stride);
 
+  /**
+     Create a message handler that exchanges the halos in all
+     partitioned dimensions and directions with a single neighborhood
+     collective (MPI_Neighbor_alltoallv), so that the MPI library can
+     schedule and aggregate the transfers.  The send and receive
+     buffers share the same layout.  The handle is started, waited on
+     and freed like a point-to-point message handle.
+     @param send_buffer Buffer from which the halos are sent
+     @param recv_buffer Buffer into which the halos are received
+     @param offset Byte offset of the halo for each dimension and
+     direction (0 - backwards, 1 forwards), where for the send buffer
+     the direction is the one we send to, and for the receive buffer
+     the one we receive from
+     @param bytes Size of the halo in each dimension in bytes
+     (dimensions that are not partitioned are ignored)
+  */
+  MsgHandle *comm_declare_neighbor_exchange(void *send_buffer, void *recv_buffer, const size_t offset[][2],
+                                            const size_t bytes[]);
+
   void comm_free(MsgHandle *&mh);
+
+  /**
+     Change the size of the message sent by a persistent send handle
+     declared with comm_declare_send_relative, comm_declare_send_displaced
+     or comm_declare_send_rank, keeping its buffer and peer.  The handle
+     must not be in flight.
+     @param mh Message handle to resize
+     @param nbytes New size of the message in bytes
+  */
+  void comm_resize_send(MsgHandle *mh, size_t nbytes);
+
   void comm_start(MsgHandle *mh);
   void comm_wait(MsgHandle *mh);
   int comm_query(MsgHandle *mh);
@@ -390,6 +426,14 @@ extern "C" {
   void comm_allreduce_xor(uint64_t *data);
   void comm_broadcast(void *data, size_t nbytes);
   void comm_barrier(void);
+
+  /**
+     @brief Return a pointer to the MPI communicator that underlies
+     the current communicator, e.g., for use with MPI-IO.
+     @return Pointer to the MPI_Comm, or nullptr if QUDA was built
+     without MPI
+   */
+  void *comm_mpi_handle();
   void comm_abort(int status);
   void comm_abort_(int status);
 
@@ -10,9 +10,11 @@
 #include <csignal>
 
 #include <comm_key.h>
+#include <halo_compress.h>
 
 #include <algorithm>
 #include <numeric>
+#include <vector>
 
 #if defined(MPI_COMMS) || defined(QMP_COMMS)
 #include <mpi.h>
@@ -97,6 +99,43 @@ static inline bool advance_coords(int ndim, const int *dims, int *x)
 //   typedef int (*QudaCommsMap)(const int *coords, void *fdata);
 Topology *comm_create_topology(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data, int my_rank);
 
+/**
+   Map data used by the topology-aware rank mapping
+   comm_topology_rank_from_coords.  The caller sets the grid and
+   (optionally) the local lattice dimensions, and the rank table is
+   filled by comm_build_topology_map once the hostnames of all ranks
+   are known.
+ */
+struct TopologyMapData {
+  int ndim;
+  int dims[QUDA_MAX_DIM];
+  int local_dims[QUDA_MAX_DIM]; // local lattice dimensions, used to weight each dimension by its face volume
+  std::vector<int> ranks;       // rank at each (lexicographic) grid coordinate
+};
+
+/**
+   Topology-aware rank mapping: the ranks on each node are assigned
+   to a contiguous sub-block of the process grid, whose shape is
+   chosen to minimize the inter-node face volume.
+   @param coords Process grid coordinates
+   @param fdata Pointer to TopologyMapData
+   @return The rank at the given coordinates
+ */
+int comm_topology_rank_from_coords(const int *coords, void *fdata);
+
+/**
+   Fill the rank table of the topology-aware mapping from the
+   gathered hostnames, and report the inter-node face bytes of the
+   chosen mapping compared to the default lexicographic mapping.  If
+   the ranks are not evenly distributed across the nodes, or no
+   node-local block divides the process grid, we fall back to the
+   lexicographic mapping.
+   @param map_data The map data to fill
+   @param hostname_recv_buf Hostnames of all ranks (128 bytes per rank)
+   @param size Number of ranks
+ */
+void comm_build_topology_map(TopologyMapData &map_data, const char *hostname_recv_buf, int size);
+
 inline void comm_destroy_topology(Topology *topo)
 {
   delete[] topo->ranks;
@@ -460,6 +499,21 @@ struct Communicator {
     return gdr_enabled;
   }
 
+  bool neighbor_exchange_enabled = false;
+  bool neighbor_exchange_init = false;
+
+  bool comm_neighbor_exchange_enabled()
+  {
+#ifdef MPI_COMMS
+    if (!neighbor_exchange_init) {
+      char *enable_neighbor_env = getenv("QUDA_ENABLE_NEIGHBOR_COLLECTIVE");
+      if (enable_neighbor_env && strcmp(enable_neighbor_env, "1") == 0) { neighbor_exchange_enabled = true; }
+      neighbor_exchange_init = true;
+    }
+#endif
+    return neighbor_exchange_enabled;
+  }
+
   bool blacklist = false;
   bool blacklist_init = false;
 
@@ -512,13 +566,17 @@ struct Communicator {
 
   void comm_init_common(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data)
   {
-    Topology *topo = comm_create_topology(ndim, dims, rank_from_coords, map_data, comm_rank());
-    comm_set_default_topology(topo);
-
     // determine which GPU this rank will use
     char *hostname_recv_buf = (char *)safe_malloc(128 * comm_size());
     comm_gather_hostname(hostname_recv_buf);
 
+    // the topology-aware mapping depends on which ranks share a node
+    if (rank_from_coords == comm_topology_rank_from_coords)
+      comm_build_topology_map(*static_cast<TopologyMapData *>(map_data), hostname_recv_buf, comm_size());
+
+    Topology *topo = comm_create_topology(ndim, dims, rank_from_coords, map_data, comm_rank());
+    comm_set_default_topology(topo);
+
     if (gpuid < 0) {
       int device_count = quda::device::get_device_count();
       if (device_count == 0) { errorQuda("No devices found"); }
@@ -593,6 +651,7 @@ struct Communicator {
       strcat(config_string, std::to_string(comm_gdr_enabled()).c_str());
       strcat(config_string, ",nvshmem=");
       strcat(config_string, std::to_string(comm_nvshmem_enabled()).c_str());
+      if (quda::halo_compress::enabled()) strcat(config_string, ",compress=1");
       config_init = true;
     }
 
@@ -669,6 +728,37 @@ struct Communicator {
   MPI_Comm MPI_COMM_HANDLE;
 #endif
 
+#if defined(MPI_COMMS)
+  /**
+     Distributed graph communicator connecting each rank to its halo
+     neighbors, used for neighborhood collective halo exchange.  The
+     graph is reference counted: the communicator holds one reference
+     to the current graph and each message handle declared on it holds
+     another, so that a graph replaced after a change of partitioning
+     is only freed once the last handle using it has been freed.
+   */
+  struct NeighborGraph {
+    MPI_Comm comm;   /**< The graph communicator */
+    int partitioned; /**< Bit mask of the partitioned dimensions the graph was built for */
+    int refs;        /**< Number of references held to the graph */
+  };
+
+  NeighborGraph *neighbor_graph = nullptr;
+
+  /**
+     @brief Return the graph communicator for the current partitioning,
+     creating it if needed.  The returned graph carries an additional
+     reference which must be dropped with comm_release_neighbor_graph.
+   */
+  NeighborGraph *comm_acquire_neighbor_graph();
+
+  /**
+     @brief Drop a reference to a graph communicator, freeing it when
+     no references remain
+   */
+  static void comm_release_neighbor_graph(NeighborGraph *&graph);
+#endif
+
 #if defined(QMP_COMMS)
   QMP_comm_t QMP_COMM_HANDLE;
 
@@ -739,20 +829,23 @@ struct Communicator {
   MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displacement[], size_t blksize, int nblocks,
                                                     size_t stride);
 
+  /**
+   * Declare a message handle for the exchange of all halos with a
+   * single neighborhood collective (see comm_quda.h)
+   */
+  MsgHandle *comm_declare_neighbor_exchange(void *send_buffer, void *recv_buffer, const size_t offset[][2],
+                                            const size_t bytes[]);
+
   void comm_free(MsgHandle *&mh);
 
+  void comm_resize_send(MsgHandle *mh, size_t nbytes);
+
   void comm_start(MsgHandle *mh);
 
   void comm_wait(MsgHandle *mh);
 
   int comm_query(MsgHandle *mh);
 
-  template <typename T> T deterministic_reduce(T *array, int n)
-  {
-    std::sort(array, array + n); // sort reduction into ascending order for deterministic reduction
-    return std::accumulate(array, array + n, 0.0);
-  }
-
   void comm_allreduce(double *data);
 
   void comm_allreduce_max(double *data);
@@ -301,6 +301,12 @@ namespace quda {
     */
     static Dirac* create(const DiracParam &param);
 
+    /**
+       @brief accessor for the gauge field the operator is built from
+       (the fat links for improved staggered, null for coarse operators)
+    */
+    virtual const cudaGaugeField *getGaugeField() const { return gauge; }
+
     /**
        @brief accessor for Kappa (mass parameter)
     */
@@ -1272,13 +1278,6 @@ public:
 
     virtual QudaDiracType getDiracType() const { return QUDA_STAGGERED_DIRAC; }
 
-    /**
-     * @brief Get the fine gauge field for MG setup.
-     *
-     * @return gauge field
-     */
-    virtual const cudaGaugeField *getGaugeField() const { return gauge; }
-
     /**
      * @brief Create the coarse staggered operator.
      *
@@ -1697,8 +1696,10 @@ public:
     /**
        @brief Initialize the coarse gauge fields.  Location is
        determined by gpu_setup variable.
+       @param[in] infile If non-empty, load the fields previously
+       saved with save() from this prefix rather than constructing them
     */
-    void initializeCoarse();
+    void initializeCoarse(const std::string &infile = "");
 
     /**
        @brief Create the CPU or GPU coarse gauge fields on demand
@@ -1737,8 +1738,10 @@ public:
        @param[in] param Parameters defining this operator
        @param[in] gpu_setup Whether to do the setup on GPU or CPU
        @param[in] mapped Set to true to put Y and X fields in mapped memory
+       @param[in] infile If non-empty, load the coarse fields saved
+       with save() from this prefix instead of constructing them
      */
-    DiracCoarse(const DiracParam &param, bool gpu_setup=true, bool mapped=false);
+    DiracCoarse(const DiracParam &param, bool gpu_setup = true, bool mapped = false, const std::string &infile = "");
 
     /**
        @param[in] param Parameters defining this operator
@@ -1762,6 +1765,15 @@ public:
     DiracCoarse(const DiracCoarse &dirac, const DiracParam &param);
     virtual ~DiracCoarse();
 
+    /**
+       @brief Save the coarse link, clover, inverse clover and
+       preconditioned link fields to native files named
+       prefix_Y, prefix_X, prefix_Xinv and prefix_Yhat.  These can be
+       reloaded by passing the prefix to the constructor.
+       @param[in] prefix The file prefix
+     */
+    void save(const std::string &prefix) const;
+
     virtual bool isCoarse() const { return true; }
 
     /**
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <quda.h>
 #include <quda_internal.h>
 #include <timer.h>
 #include <dirac_quda.h>
 #include <color_spinor_field.h>
+#include <eigenvector_store.h>
 
 namespace quda
 {
@@ -46,6 +48,7 @@ namespace quda
     int num_converged;
     int num_locked;
     int num_keep;
+    double a_max; /** Chebyshev upper bound, as given, estimated or restored from a checkpoint */
 
     std::vector<double> residua;
 
@@ -58,6 +61,9 @@ namespace quda
 
     QudaPrecision save_prec;
 
+    /** Lazily loaded eigenvectors, used in place of an explicit eigenspace when set */
+    std::unique_ptr<EigenvectorStore> evec_store;
+
   public:
     /**
        @brief Constructor for base Eigensolver class
@@ -290,11 +296,12 @@ namespace quda
                  const std::vector<Complex> &evals, bool accumulate = false)
     {
       // FIXME add support for mixed-precison dot product to avoid this copy
-      if (src.Precision() != evecs[0]->Precision() && !tmp1) {
-        ColorSpinorParam param(*evecs[0]);
-        tmp1 = new ColorSpinorField(param);
+      ColorSpinorParam evec_param(evecs.empty() && evec_store ? evec_store->Param() : ColorSpinorParam(*evecs[0]));
+      if (src.Precision() != evec_param.Precision() && !tmp1) {
+        evec_param.create = QUDA_NULL_FIELD_CREATE;
+        tmp1 = new ColorSpinorField(evec_param);
       }
-      ColorSpinorField *src_tmp = src.Precision() != evecs[0]->Precision() ? tmp1 : const_cast<ColorSpinorField *>(&src);
+      ColorSpinorField *src_tmp = src.Precision() != evec_param.Precision() ? tmp1 : const_cast<ColorSpinorField *>(&src);
       blas::copy(*src_tmp, src); // no-op if these alias
       std::vector<ColorSpinorField *> src_ {src_tmp};
       std::vector<ColorSpinorField *> sol_ {&sol};
@@ -367,6 +374,55 @@ namespace quda
       computeEvals(mat, evecs, evals, n_conv);
     }
 
+    /**
+       @brief Use a lazily loaded eigenvector store in place of an
+       explicit eigenspace.  When set, loadFromFile, computeEvals and
+       deflate accept an empty set of eigenvectors, and stream the
+       eigenvectors from the store instead.
+       @param[in] store The eigenvector store, ownership of which is transferred to the eigensolver
+    */
+    void setEigenvectorStore(EigenvectorStore *store) { evec_store.reset(store); }
+
+    /**
+       @brief Return the checkpoint file prefix set with
+       QUDA_EIG_CHECKPOINT, or an empty string if checkpointing is
+       disabled.  When set, the restarted solvers write the state
+       needed to resume (the retained Krylov space, the projected
+       matrix and the restart counters) every
+       QUDA_EIG_CHECKPOINT_INTERVAL restarts (default 10), and resume
+       from the most recent checkpoint with matching parameters that
+       was computed with the same operator (gauge field checksum, mass
+       parameters and operator type).  Two
+       checkpoint slots are alternated, so that a job that is killed
+       while writing a checkpoint can resume from the previous one, and
+       the checkpoint is removed once the solver has converged.
+     */
+    static const std::string &checkpointPrefix();
+
+    /**
+       @brief Write a checkpoint at the end of a restart, if one is due
+       @param[in] vecs The vectors holding the Krylov space state
+       @param[in] data Solver specific host state
+    */
+    void saveCheckpoint(const std::vector<ColorSpinorField *> &vecs, const std::vector<double> &data);
+
+    /**
+       @brief Restore the most recent checkpoint, if any.  The restart
+       counters and the Chebyshev bound are restored (the latter
+       without modifying eig_param), the leading vectors of vecs are
+       loaded and data is filled with the solver specific host state.
+       @param[in,out] vecs The vectors to load the Krylov space state into
+       @param[out] data Solver specific host state
+       @param[in] data_length The expected length of data
+       @return Whether a checkpoint was loaded
+    */
+    bool loadCheckpoint(std::vector<ColorSpinorField *> &vecs, std::vector<double> &data, size_t data_length);
+
+    /**
+       @brief Remove the checkpoint files once they are no longer needed
+    */
+    void removeCheckpoint();
+
     /**
        @brief Load and check eigenpairs from file
        @param[in] mat Matrix operator
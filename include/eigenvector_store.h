@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <color_spinor_field.h>
+#include <field_io.h>
+
+namespace quda
+{
+
+  /**
+     @brief EigenvectorStore is a lazily loaded deflation space that is
+     backed by a memory-mapped native eigenvector file (see
+     field_io.h).  Eigenvectors are copied into device fields on
+     demand, and are cached in device memory up to a budget set with
+     QUDA_DEFLATION_CACHE_SIZE (in MiB).  If the eigenspace fits in
+     the budget every vector is loaded once.  Otherwise the lowest
+     modes are kept resident, and the remaining vectors are streamed
+     through a small set of slots in blocks, so that eigenspaces that
+     exceed the host and device memory can be used for deflation.
+   */
+  class EigenvectorStore
+  {
+    native_io::MappedFile file;
+    ColorSpinorParam param;        /** Parameters of the device fields */
+    const int n_vec;               /** Number of eigenvectors in the store */
+    int n_resident;                /** Number of leading vectors that stay resident once loaded */
+    int n_stream;                  /** Number of slots used to stream the remaining vectors */
+    std::vector<ColorSpinorField *> slot;  /** Device fields of the cache */
+    std::vector<int> slot_vec;             /** Vector held by each slot, -1 if empty */
+    std::vector<unsigned long> slot_use;   /** Last block request each slot was used in */
+    std::vector<int> vec_slot;             /** Slot holding each vector, -1 if not cached */
+    unsigned long clock = 0;
+    ColorSpinorField *host = nullptr; /** Host staging field */
+    size_t hits = 0;
+    size_t misses = 0;
+
+    /**
+       @brief Copy a vector from the file into a cache slot
+     */
+    void load(int i, int s);
+
+  public:
+    /**
+       @brief Return the cache budget in bytes set by
+       QUDA_DEFLATION_CACHE_SIZE, or zero if the store is disabled
+     */
+    static size_t cache_bytes();
+
+    /**
+       @brief Return whether deflation spaces should be streamed from
+       file rather than loaded up front
+     */
+    static bool enabled() { return cache_bytes() > 0; }
+
+    /**
+       @brief Constructor for the EigenvectorStore class
+       @param[in] filename The native eigenvector file
+       @param[in] param Parameters of the device eigenvector fields
+       @param[in] n_vec Number of eigenvectors to use from the file
+     */
+    EigenvectorStore(const std::string &filename, const ColorSpinorParam &param, int n_vec);
+
+    EigenvectorStore(const EigenvectorStore &) = delete;
+    EigenvectorStore &operator=(const EigenvectorStore &) = delete;
+
+    ~EigenvectorStore();
+
+    /**
+       @return The number of eigenvectors in the store
+     */
+    int size() const { return n_vec; }
+
+    /**
+       @return Parameters of the device eigenvector fields
+     */
+    const ColorSpinorParam &Param() const { return param; }
+
+    /**
+       @brief Return the end of the largest block starting at begin
+       that can be held in the cache at once
+       @param[in] begin The first vector of the block
+     */
+    int block_end(int begin) const { return begin < n_resident ? n_resident : std::min(n_vec, begin + n_stream); }
+
+    /**
+       @brief Return the device fields of a block of eigenvectors,
+       loading any that are not cached.  The fields remain valid until
+       the next call.
+       @param[in] begin The first vector of the block
+       @param[in] end One past the last vector of the block (at most block_end(begin))
+       @return The device fields
+     */
+    std::vector<ColorSpinorField *> block(int begin, int end);
+  };
+
+} // namespace quda
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <string>
+#include <enum_quda.h>
+
+/**
+   @file field_io.h
+
+   @brief Native parallel binary I/O for gauge fields and sets of
+   color-spinor fields, that does not depend on QIO.  A file consists
+   of a fixed-size header followed by the raw field data, stored
+   field by field, with the sites of each field in global
+   lexicographic order (x fastest) and the degrees of freedom of each
+   site in the same order used by QIO: [color][color][complex] for
+   gauge fields and [spin][color][complex] for vector fields.  For
+   single-parity fields the lattice is the checkerboarded lattice,
+   again matching the QIO convention.
+
+   Each rank reads or writes its local sub-block directly at the
+   computed file offsets: with a single collective MPI-IO call per
+   field when QUDA is built with MPI, and with pread / pwrite of
+   contiguous runs otherwise.  Reading converts between the file and
+   host precision if these differ.
+
+   The format that is written by VectorIO::save and
+   write_gauge_field is selected with the environment variable
+   QUDA_IO_FORMAT=native|qio, which defaults to qio if QUDA is built
+   with QIO, and native otherwise.  Native files are detected
+   automatically on loading.
+
+   Saved sets of vector fields (e.g., eigenvectors or multigrid
+   near-null vectors) may be compressed, selected with
+   QUDA_IO_COMPRESS, a comma-separated list of
+   - none: raw data in the host precision (default)
+   - blockfloat16 / blockfloat8: each site is stored as a single
+     float scale and 16- or 8-bit integers relative to it
+   - lowrank=tol: store an orthonormal basis of the set and the
+     coefficients of each vector in it, dropping directions with
+     relative residual below tol
+   The relative reconstruction error is measured when saving, stored
+   in the header and reported when loading.  Gauge fields are always
+   stored raw.
+
+   Native saves may be made asynchronous by setting a host staging
+   budget with QUDA_IO_ASYNC_SIZE (in MiB).  The data are then copied
+   into staging buffers and written by a background thread, and the
+   save returns once the file has been created.  Use wait() (or
+   waitForIOQuda) to ensure all files are complete, which is also
+   where a failed background write is reported; loading or
+   overwriting a file that is being written waits automatically.
+ */
+
+namespace quda
+{
+
+  namespace native_io
+  {
+
+    /**
+       @brief Return whether a file is in the native format.  This is
+       a collective call: the file header is read by rank 0 and the
+       result broadcast.
+       @param[in] filename The file to query
+       @return Whether the file exists and is in the native format
+     */
+    bool is_native(const std::string &filename);
+
+    /**
+       @brief Return whether fields should be saved in the native
+       format (set with QUDA_IO_FORMAT).
+     */
+    bool save_native();
+
+    /**
+       @brief Wait until all asynchronous saves have been written on
+       all ranks.  A write that failed in the background is raised as
+       an error here.  This is a collective call.
+     */
+    void wait();
+
+    /**
+       @brief Read a set of vector fields from a native file
+       @param[in] filename The file to read
+       @param[out] V Array of host field pointers, one per field
+       @param[in] precision Precision of the host fields
+       @param[in] X Local lattice dimensions (checkerboarded for single-parity fields)
+       @param[in] subset Site subset of the fields
+       @param[in] parity Parity of the fields if single parity
+       @param[in] nColor Number of colors
+       @param[in] nSpin Number of spins
+       @param[in] Nvec Number of fields
+     */
+    void read_spinor_field(const std::string &filename, void *V[], QudaPrecision precision, const int *X,
+                           QudaSiteSubset subset, QudaParity parity, int nColor, int nSpin, int Nvec);
+
+    /**
+       @brief Write a set of vector fields to a native file
+       @param[in] filename The file to write
+       @param[in] V Array of host field pointers, one per field
+       @param[in] precision Precision of the host fields (and file)
+       @param[in] X Local lattice dimensions (checkerboarded for single-parity fields)
+       @param[in] subset Site subset of the fields
+       @param[in] parity Parity of the fields if single parity
+       @param[in] nColor Number of colors
+       @param[in] nSpin Number of spins
+       @param[in] Nvec Number of fields
+       @param[in] compress Whether to apply the QUDA_IO_COMPRESS encoding (otherwise the data are stored raw)
+     */
+    void write_spinor_field(const std::string &filename, void *V[], QudaPrecision precision, const int *X,
+                            QudaSiteSubset subset, QudaParity parity, int nColor, int nSpin, int Nvec,
+                            bool compress = true);
+
+    /**
+       @brief Read a QDP-ordered host gauge field from a native file
+       @param[in] filename The file to read
+       @param[out] gauge Array of the host link fields
+       @param[in] precision Precision of the host gauge field
+       @param[in] X Local lattice dimensions
+       @param[in] nColor Number of colors (rows of each link matrix)
+       @param[in] geometry Number of link fields
+     */
+    void read_gauge_field(const std::string &filename, void *gauge[], QudaPrecision precision, const int *X,
+                          int nColor = 3, int geometry = 4);
+
+    /**
+       @brief Write a QDP-ordered host gauge field to a native file
+       @param[in] filename The file to write
+       @param[in] gauge Array of the host link fields
+       @param[in] precision Precision of the host gauge field (and file)
+       @param[in] X Local lattice dimensions
+       @param[in] nColor Number of colors (rows of each link matrix)
+       @param[in] geometry Number of link fields
+     */
+    void write_gauge_field(const std::string &filename, void *gauge[], QudaPrecision precision, const int *X,
+                           int nColor = 3, int geometry = 4);
+
+    /**
+       @brief Read-only memory mapping of a native file, from which
+       individual fields are read on demand.  Each rank only touches
+       the pages that hold its own sub-block of the fields it reads,
+       so files much larger than the host memory can be used.
+     */
+    class MappedFile
+    {
+      const std::string filename;
+      int fd;
+      void *map;
+      size_t map_bytes;
+      int n_field;
+      QudaPrecision precision;
+      QudaSiteSubset subset;
+      int site_len;
+      int encoding;
+      int dims[4];
+
+    public:
+      /**
+         @brief Map a native file.  This is a collective call if
+         asynchronous saves are enabled, since any outstanding write
+         of the file is completed first.
+         @param[in] filename The file to map
+       */
+      MappedFile(const std::string &filename);
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      ~MappedFile();
+
+      /**
+         @return Number of fields in the file
+       */
+      int Nfield() const { return n_field; }
+
+      /**
+         @return Precision of the file
+       */
+      QudaPrecision Precision() const { return precision; }
+
+      /**
+         @brief Read a single field from the file
+         @param[in] i Index of the field to read
+         @param[out] V Host field pointer
+         @param[in] precision Precision of the host field
+         @param[in] X Local lattice dimensions (checkerboarded for single-parity fields)
+         @param[in] subset Site subset of the field
+         @param[in] site_len Number of real numbers per site
+       */
+      void read(int i, void *V, QudaPrecision precision, const int *X, QudaSiteSubset subset, int site_len) const;
+    };
+
+  } // namespace native_io
+
+} // namespace quda
@@ -837,11 +837,29 @@ namespace quda {
      @param[in] mini Whether to compute a mini checksum or global checksum.
      A mini checksum only computes over a subset of the lattice
      sites and is to be used for online comparisons, e.g., checking
-     a field has changed with a global update algorithm.
+     a field has changed with a global update algorithm.  Device
+     fields are copied to the host in double precision first.
      @return checksum value
   */
   uint64_t Checksum(const GaugeField &u, bool mini=false);
 
+  /**
+     @brief Save a gauge field of any geometry and number of colors to
+     a native file (see field_io.h), through a QDP-ordered host copy
+     @param[in] filename The file to write
+     @param[in] u The field to save
+   */
+  void saveGaugeField(const std::string &filename, const GaugeField &u);
+
+  /**
+     @brief Load a gauge field saved with saveGaugeField.  The field
+     must have been allocated with matching dimensions, geometry and
+     number of colors.
+     @param[in] filename The file to read
+     @param[out] u The field to load into
+   */
+  void loadGaugeField(const std::string &filename, GaugeField &u);
+
   /**
      @brief Helper function for determining if the reconstruct of the fields is the same.
      @param[in] a Input field
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <enum_quda.h>
+
+/**
+   @file halo_compress.h
+
+   @brief Host-side compression of halo messages that are staged
+   through the pinned ghost buffers.  Compression is applied to the
+   packed ghost zone immediately before the message is posted, and
+   reversed on the receiving rank after the message has arrived.  It
+   is configured at run time with the environment variable
+   QUDA_HALO_COMPRESS, which takes a comma-separated list of entries
+   of the form "mode" (applies to all ghost precisions) or
+   "precision:mode", e.g., QUDA_HALO_COMPRESS=double:byteplane,single:blockfloat.
+
+   Supported modes are
+   - none: no compression (the default)
+   - byteplane: lossless byte-plane transposition, with each byte
+     plane stored raw, run-length encoded or dictionary encoded,
+     whichever is smallest
+   - blockfloat: lossy block-floating-point quantization, with a shared
+     exponent per block of values and mantissas stored at half the
+     width of the input (double and single ghost precision only)
+ */
+
+namespace quda
+{
+
+  namespace halo_compress
+  {
+
+    enum class Mode { NONE, BYTE_PLANE, BLOCK_FLOAT };
+
+    /**
+       @brief Return the compression mode that is to be used for
+       halos of a given ghost precision.
+       @param[in] precision The ghost precision of the field
+       @return The compression mode
+    */
+    Mode mode(QudaPrecision precision);
+
+    /**
+       @brief Return whether halo compression is enabled for any
+       precision.
+    */
+    bool enabled();
+
+    /**
+       @brief Return the size in bytes of the header that is prepended
+       to each compressed message.
+    */
+    constexpr size_t header_bytes() { return 32; }
+
+    /**
+       @brief Return the maximum size of a compressed message.  The
+       compressors fall back to storing the raw data if compression
+       would increase the message size, so this is simply the input
+       size plus the header.
+       @param[in] bytes Size of the uncompressed message
+       @return Maximum compressed message size
+    */
+    constexpr size_t bound(size_t bytes) { return bytes + header_bytes(); }
+
+    /**
+       @brief Compress a halo message.
+       @param[out] dst Destination buffer (must be at least bound(bytes) in size)
+       @param[in] src Uncompressed halo buffer
+       @param[in] bytes Size of the uncompressed halo buffer
+       @param[in] precision The ghost precision of the halo
+       @return The size in bytes of the compressed message, including the header
+    */
+    size_t compress(void *dst, const void *src, size_t bytes, QudaPrecision precision);
+
+    /**
+       @brief Decompress a halo message.  All the information required
+       to decode the message is contained in its header.
+       @param[out] dst Destination halo buffer
+       @param[in] src Compressed message
+       @param[in] bytes Size of the destination halo buffer
+    */
+    void decompress(void *dst, const void *src, size_t bytes);
+
+    /**
+       @brief Print the accumulated compression ratio and the time
+       spent compressing and decompressing halos.
+    */
+    void print_profile();
+
+  } // namespace halo_compress
+
+} // namespace quda
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <enum_quda.h>
+
+/**
+   @file ildg_io.h
+
+   @brief Streaming reader for gauge configurations stored in LIME
+   files in the ILDG or SciDAC single-file formats, that does not
+   depend on QIO.  Each rank reads its own sub-block of the binary
+   record directly, in chunks of bounded size, and each chunk is
+   processed in a single threaded pass that accumulates the SciDAC
+   checksum and converts the big-endian file data into the requested
+   host precision and gauge order.  The local checksums are combined
+   with a single XOR reduction and compared against the checksum
+   record of the file.
+
+   The streaming reader is used by read_gauge_field for LIME files
+   unless QUDA_IO_LIME_READER=qio is set, in which case such files are
+   read through QIO.  The chunk size in MiB may be set with
+   QUDA_IO_CHUNK_SIZE (default 64).
+ */
+
+namespace quda
+{
+
+  namespace ildg_io
+  {
+
+    /**
+       @brief Return whether a file is a LIME file holding a single
+       gauge field that can be read by the streaming reader.  This is
+       a collective call: the file is parsed by rank 0 and the result
+       broadcast.
+       @param[in] filename The file to query
+       @return Whether the file can be read with read_gauge_field
+     */
+    bool is_ildg(const std::string &filename);
+
+    /**
+       @brief Return whether the streaming reader should be used for
+       LIME files (set with QUDA_IO_LIME_READER=native|qio)
+     */
+    bool use_native_reader();
+
+    /**
+       @brief Read a gauge field from an ILDG or SciDAC LIME file into
+       a host gauge field in a single pass, verifying the SciDAC
+       checksum if present.
+       @param[in] filename The file to read
+       @param[out] gauge Host gauge field: the four link fields for
+       QDP order, or the single site-major array for MILC order
+       @param[in] precision Precision of the host gauge field
+       @param[in] X Local lattice dimensions
+       @param[in] order Host gauge order (QUDA_QDP_GAUGE_ORDER or QUDA_MILC_GAUGE_ORDER)
+     */
+    void read_gauge_field(const std::string &filename, void *gauge[], QudaPrecision precision, const int *X,
+                          QudaGaugeFieldOrder order = QUDA_QDP_GAUGE_ORDER);
+
+  } // namespace ildg_io
+
+} // namespace quda
@@ -240,6 +240,16 @@ namespace quda {
     */
     static void *ghost_pinned_recv_buffer_hd[2];
 
+    /**
+       Double buffered static pinned send buffers used for compressed halos
+    */
+    static void *ghost_compress_send_buffer_h[2];
+
+    /**
+       Double buffered static pinned recv buffers used for compressed halos
+    */
+    static void *ghost_compress_recv_buffer_h[2];
+
     /**
        Remove ghost pointer for sending to
     */
@@ -328,6 +338,15 @@ namespace quda {
     /** Local pointers to the device ghost_recv buffer */
     void *from_face_dim_dir_d[2][QUDA_MAX_DIM][2];
 
+    /** Local pointers to the compressed pinned send buffer */
+    void *my_face_compress_dim_dir_h[2][QUDA_MAX_DIM][2];
+
+    /** Local pointers to the compressed pinned recv buffer */
+    void *from_face_compress_dim_dir_h[2][QUDA_MAX_DIM][2];
+
+    /** Whether host-staged halos are compressed (see halo_compress.h) */
+    bool ghost_compress;
+
     /** Message handles for receiving from forwards */
     MsgHandle *mh_recv_fwd[2][QUDA_MAX_DIM];
 
@@ -352,6 +371,24 @@ namespace quda {
     /** Message handles for rdma sending to backwards */
     MsgHandle *mh_send_rdma_back[2][QUDA_MAX_DIM];
 
+    /** Message handles for receiving compressed halos from forwards */
+    MsgHandle *mh_recv_compress_fwd[2][QUDA_MAX_DIM];
+
+    /** Message handles for receiving compressed halos from backwards */
+    MsgHandle *mh_recv_compress_back[2][QUDA_MAX_DIM];
+
+    /** Message handles for sending compressed halos forwards (resized per message since the size varies) */
+    MsgHandle *mh_send_compress_fwd[2][QUDA_MAX_DIM];
+
+    /** Message handles for sending compressed halos backwards (resized per message since the size varies) */
+    MsgHandle *mh_send_compress_back[2][QUDA_MAX_DIM];
+
+    /** Whether a compressed send has been started and not yet retired through commsQuery or commsWait */
+    bool send_compress_active[2][QUDA_MAX_DIM][2];
+
+    /** Message handles for exchanging all host-staged halos with a single neighborhood collective */
+    MsgHandle *mh_neighbor[2];
+
     /** Peer-to-peer message handler for signaling event posting */
     static MsgHandle *mh_send_p2p_fwd[2][QUDA_MAX_DIM];
 
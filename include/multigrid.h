@@ -108,6 +108,12 @@ namespace quda {
     /** Whether to use tensor cores (if available) */
     bool use_mma;
 
+    /** File prefix of the persisted hierarchy (empty if disabled) */
+    std::string hierarchy_file;
+
+    /** Whether to load the hierarchy from hierarchy_file rather than construct it */
+    bool hierarchy_load;
+
     /**
        This is top level instantiation done when we start creating the multigrid operator.
      */
@@ -136,7 +142,8 @@ namespace quda {
       location(param.location[level]),
       setup_location(param.setup_location[level]),
       transfer_type(param.transfer_type[level]),
-      use_mma(param.use_mma == QUDA_BOOLEAN_TRUE)
+      use_mma(param.use_mma == QUDA_BOOLEAN_TRUE),
+      hierarchy_load(false)
     {
       // set the block size
       for (int i = 0; i < QUDA_MAX_DIM; i++) geoBlockSize[i] = param.geo_block_size[level][i];
@@ -172,7 +179,9 @@ namespace quda {
       location(param.mg_global.location[level]),
       setup_location(param.mg_global.setup_location[level]),
       transfer_type(param.mg_global.transfer_type[level]),
-      use_mma(param.use_mma)
+      use_mma(param.use_mma),
+      hierarchy_file(param.hierarchy_file),
+      hierarchy_load(param.hierarchy_load)
     {
       // set the block size
       for (int i = 0; i < QUDA_MAX_DIM; i++) geoBlockSize[i] = param.mg_global.geo_block_size[level][i];
@@ -332,6 +341,27 @@ namespace quda {
     */
     void dumpNullVectors() const;
 
+    /**
+       @brief Save the complete hierarchy to disk: the null-space
+       vectors, the block-orthonormalized prolongator, the coarse link
+       fields and the staggered KD inverse.  Will recurse saving all
+       levels.  The hierarchy is reloaded in place of the setup when
+       param.hierarchy_file is set to the same prefix and
+       param.hierarchy_load is set.
+       @param[in] prefix The file prefix of the hierarchy
+    */
+    void saveHierarchy(const std::string &prefix) const;
+
+    /**
+       @return The file of this level's component name in a persisted hierarchy
+       @param[in] prefix The file prefix of the hierarchy
+       @param[in] name The component name
+    */
+    std::string hierarchyFile(const std::string &prefix, const std::string &name) const
+    {
+      return prefix + "_level_" + std::to_string(param.level) + "_" + name;
+    }
+
     /**
        @brief Create the smoothers
     */
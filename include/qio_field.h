@@ -1,5 +1,8 @@
 #pragma once
 
+#include <field_io.h>
+#include <ildg_io.h>
+
 #ifdef HAVE_QIO
 void read_gauge_field(const char *filename, void *gauge[], QudaPrecision prec, const int *X,
 		      int argc, char *argv[]);
@@ -9,27 +12,27 @@ void read_spinor_field(const char *filename, void *V[], QudaPrecision precision,
 void write_spinor_field(const char *filename, void *V[], QudaPrecision precision, const int *X, QudaSiteSubset subset,
                         QudaParity parity, int nColor, int nSpin, int Nvec, int argc, char *argv[]);
 #else
-inline void read_gauge_field(const char *, void *[], QudaPrecision, const int *, int, char *[])
+// without QIO, all I/O uses the native format (see field_io.h), and ILDG / SciDAC gauge files can be read (see ildg_io.h)
+inline void read_gauge_field(const char *filename, void *gauge[], QudaPrecision prec, const int *X, int, char *[])
 {
-  printf("QIO support has not been enabled\n");
-  exit(-1);
+  if (quda::ildg_io::is_ildg(filename))
+    quda::ildg_io::read_gauge_field(filename, gauge, prec, X);
+  else
+    quda::native_io::read_gauge_field(filename, gauge, prec, X);
 }
-inline void write_gauge_field(const char *, void *[], QudaPrecision, const int *, int, char *[])
+inline void write_gauge_field(const char *filename, void *gauge[], QudaPrecision prec, const int *X, int, char *[])
 {
-  printf("QIO support has not been enabled\n");
-  exit(-1);
+  quda::native_io::write_gauge_field(filename, gauge, prec, X);
 }
-inline void read_spinor_field(const char *, void *[], QudaPrecision, const int *, QudaSiteSubset, QudaParity, int, int,
-                              int, int, char *[])
+inline void read_spinor_field(const char *filename, void *V[], QudaPrecision precision, const int *X,
+                              QudaSiteSubset subset, QudaParity parity, int nColor, int nSpin, int Nvec, int, char *[])
 {
-  printf("QIO support has not been enabled\n");
-  exit(-1);
+  quda::native_io::read_spinor_field(filename, V, precision, X, subset, parity, nColor, nSpin, Nvec);
 }
-inline void write_spinor_field(const char *, void *[], QudaPrecision, const int *, QudaSiteSubset, QudaParity, int, int,
-                               int, int, char *[])
+inline void write_spinor_field(const char *filename, void *V[], QudaPrecision precision, const int *X,
+                               QudaSiteSubset subset, QudaParity parity, int nColor, int nSpin, int Nvec, int, char *[])
 {
-  printf("QIO support has not been enabled\n");
-  exit(-1);
+  quda::native_io::write_spinor_field(filename, V, precision, X, subset, parity, nColor, nSpin, Nvec);
 }
 
 #endif
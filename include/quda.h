@@ -907,6 +907,31 @@ extern "C" {
 
   void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata);
 
+  /**
+   * Declare the grid mapping using a built-in topology-aware
+   * assignment of ranks to grid coordinates, in place of a
+   * user-supplied QudaCommsMap.  The ranks that share a node
+   * (determined from their hostnames) are assigned a contiguous
+   * block of the grid, with the block shape chosen to minimize the
+   * inter-node halo volume, so the most heavily communicating
+   * dimensions stay on-node.  The expected inter-node face bytes of
+   * the chosen mapping are reported at QUDA_SUMMARIZE verbosity.
+   * This function should be called prior to initQuda().
+   *
+   * @param nDim   Number of grid dimensions.  "4" is the only supported
+   *               value currently.
+   *
+   * @param dims   Array of grid dimensions.  dims[0]*dims[1]*dims[2]*dims[3]
+   *               must equal the total number of MPI ranks or QMP nodes.
+   *
+   * @param local_dims  Local lattice dimensions on each rank, used to
+   *               weight each dimension by its face volume.  If NULL,
+   *               all dimensions are weighted equally.
+   *
+   * @see initCommsGridQuda
+   */
+  void initCommsGridTopologyQuda(int nDim, const int *dims, const int *local_dims);
+
   /**
    * Initialize the library.  This is a low-level interface that is
    * called by initQuda.  Calling initQudaDevice requires that the
@@ -1059,6 +1084,16 @@ extern "C" {
    */
   void saveGaugeQuda(void *h_gauge, QudaGaugeParam *param);
 
+  /**
+   * Wait until all outstanding asynchronous field saves (enabled
+   * with QUDA_IO_ASYNC_SIZE) have been written to disk.  Gauge
+   * configurations, eigenvectors and multigrid null vectors saved in
+   * the native format are otherwise written in the background.
+   * A write that failed in the background is reported as an error
+   * here.  This is a collective call, and is also called by endQuda.
+   */
+  void waitForIOQuda(void);
+
   /**
    * Load the clover term and/or the clover inverse from the host.
    * Either h_clover or h_clovinv may be set to NULL.
@@ -1163,7 +1198,11 @@ extern "C" {
   /**
    * Setup the multigrid solver, according to the parameters set in param.  It
    * is assumed that the gauge field has already been loaded via
-   * loadGaugeQuda().
+   * loadGaugeQuda().  If QUDA_MG_HIERARCHY=prefix is set, the complete
+   * hierarchy (null-space vectors, prolongators and coarse operators)
+   * is saved to files with this prefix and a key formed from the
+   * gauge field checksum and the setup parameters, and a later setup
+   * with the same key loads the hierarchy instead of rebuilding it.
    * @param param  Contains all metadata regarding host and device
    *               storage and solver parameters
    */
@@ -1187,7 +1226,8 @@ extern "C" {
   void updateMultigridQuda(void *mg_instance, QudaMultigridParam *param);
 
   /**
-   * @brief Dump the null-space vectors to disk
+   * @brief Dump the null-space vectors to disk, and the complete
+   * hierarchy if QUDA_MG_HIERARCHY is set (see newMultigridQuda)
    * @param[in] mg_instance Pointer to the instance of multigrid_solver
    * @param[in] param Contains all metadata regarding host and device
    * storage and solver parameters (QudaMultigridParam::vec_outfile
@@ -1621,6 +1661,30 @@ extern "C" {
    */
   void flushChronoQuda(int index);
 
+  /**
+   * @brief Save the chronological history for the given index, so
+   * that it may be restored by a later session with loadChronoQuda.
+   * The basis vectors are written at their resident precision (at
+   * least single) to the native vector file filename_vecs, followed
+   * by a small metadata record (basis size, precision and field
+   * layout) to filename, which is removed first so that it is only
+   * present once the basis is complete.  This is a collective call.
+   * @param[in] index Index of the chronological history to save
+   * @param[in] filename Path of the basis file
+   */
+  void saveChronoQuda(int index, const char *filename);
+
+  /**
+   * @brief Restore a chronological history saved with saveChronoQuda
+   * into the given index, replacing any existing history.  The basis
+   * is recreated with the precision and layout it was saved with, and
+   * may be loaded on a different process grid.  This is a collective
+   * call.
+   * @param[in] index Index of the chronological history to restore
+   * @param[in] filename Path of the basis file
+   */
+  void loadChronoQuda(int index, const char *filename);
+
 
   /**
   * Create deflation solver resources.
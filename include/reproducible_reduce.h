@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <climits>
+#include <cstddef>
+
+#if defined(QMP_COMMS) || defined(MPI_COMMS)
+#include <mpi.h>
+#endif
+
+/**
+   @file reproducible_reduce.h
+
+   @brief Host helpers for reproducible global sums of doubles.  Each
+   summand is converted to a fixed-point number, relative to the
+   largest exponent of any summand across all ranks, stored as a set
+   of 32-bit limbs held in 64-bit integers.  Integer addition is
+   associative and commutative, so the sum is independent of the
+   order (and hence of the reduction tree used by MPI) by
+   construction.  The global reduction then costs one MPI_MAX
+   allreduce of the exponents and one allreduce of n_limb integers
+   per summand, independent of the number of ranks.
+
+   Bits below 2^(e_max - 32 * n_limb) are truncated, where e_max is
+   the global maximum exponent.  The truncation of each summand only
+   depends on its value and e_max, so it is itself reproducible.
+ */
+
+namespace quda
+{
+
+  namespace reproducible
+  {
+
+    /** Number of limbs used to represent each summand */
+    constexpr int n_limb = 4;
+
+    /** Number of bits stored per limb (the remainder of each 64-bit limb absorbs carries) */
+    constexpr int limb_bits = 32;
+
+    /** Exponent value used to flag a non-finite summand */
+    constexpr int non_finite = INT_MAX;
+
+    /** Exponent value used to flag a zero summand */
+    constexpr int zero = INT_MIN;
+
+    /**
+       @brief Return the exponent e such that |x| < 2^e
+       @param[in] x Summand
+       @return The exponent, or zero / non_finite for these special cases
+     */
+    inline int exponent(double x)
+    {
+      if (!std::isfinite(x)) return non_finite;
+      if (x == 0.0) return zero;
+      int e;
+      std::frexp(x, &e);
+      return e;
+    }
+
+    /**
+       @brief Convert a summand to fixed point relative to 2^e, where
+       |x| < 2^e.  All limbs take the sign of x.
+       @param[out] limb The fixed-point representation
+       @param[in] x Summand
+       @param[in] e Exponent (maximum over all summands)
+     */
+    inline void to_fixed(int64_t *limb, double x, int e)
+    {
+      double r = e == zero ? 0.0 : std::ldexp(x, -e);
+      for (int k = 0; k < n_limb; k++) {
+        r = std::ldexp(r, limb_bits);
+        limb[k] = static_cast<int64_t>(r);
+        r -= limb[k];
+      }
+    }
+
+    /**
+       @brief Propagate carries so that all but the leading limb lie
+       in [0, 2^limb_bits).  This gives a unique representation of
+       each fixed-point number.
+       @param[in,out] limb The fixed-point number
+     */
+    inline void normalize(int64_t *limb)
+    {
+      constexpr int64_t base = static_cast<int64_t>(1) << limb_bits;
+      for (int k = n_limb - 1; k > 0; k--) {
+        int64_t carry = limb[k] >= 0 ? limb[k] / base : -((-limb[k] + base - 1) / base);
+        limb[k] -= carry * base;
+        limb[k - 1] += carry;
+      }
+    }
+
+    /**
+       @brief Convert a fixed-point number back to a double
+       @param[in] limb The fixed-point number (normalized on return)
+       @param[in] e Exponent that the fixed-point number is relative to
+       @return The value as a double
+     */
+    inline double from_fixed(int64_t *limb, int e)
+    {
+      if (e == zero) return 0.0;
+      normalize(limb);
+      double value = 0.0;
+      for (int k = n_limb - 1; k >= 0; k--) value = std::ldexp(value + static_cast<double>(limb[k]), -limb_bits);
+      return std::ldexp(value, e);
+    }
+
+    /**
+       @brief Accumulate count fixed-point numbers, the body of the
+       custom MPI reduction operator.
+       @param[in] in Input fixed-point numbers
+       @param[in,out] inout Accumulated fixed-point numbers
+       @param[in] count Number of fixed-point numbers
+     */
+    inline void accumulate(const int64_t *in, int64_t *inout, int count)
+    {
+      for (int i = 0; i < count; i++) {
+        for (int k = 0; k < n_limb; k++) inout[i * n_limb + k] += in[i * n_limb + k];
+        normalize(inout + i * n_limb);
+      }
+    }
+
+#if defined(QMP_COMMS) || defined(MPI_COMMS)
+    /**
+       @brief Reproducible sum reduction of an array of doubles over a
+       communicator, used by the MPI and QMP communicators when
+       QUDA_DETERMINISTIC_REDUCE=1.  The result is bitwise identical
+       regardless of the reduction order used by the MPI library.
+       @param[in,out] data The array to be summed
+       @param[in] size Length of the array
+       @param[in] comm The communicator to reduce over
+     */
+    void allreduce(double *data, size_t size, MPI_Comm comm);
+#endif
+
+  } // namespace reproducible
+
+} // namespace quda
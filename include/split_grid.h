@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
+
 #include <quda.h>
 #include <comm_quda.h>
 #include <communicator_quda.h>
@@ -13,6 +16,73 @@ int comm_rank_from_coords(const int *coords);
 namespace quda
 {
 
+  namespace split_grid
+  {
+
+    /**
+       Persistent buffers and message handles used to redistribute
+       fields of a given size between the full grid and the split
+       grid.  These are cached across calls, so repeated
+       redistribution (e.g., for each batch of sources in
+       invertMultiSrcQuda) does not allocate pinned memory or declare
+       new message handles.  Each message is split into chunks of at
+       most chunk_bytes, so that unpacking of early replicates can
+       overlap with the transfer of the remainder, and so messages
+       larger than the MPI count limit are supported.
+    */
+    struct Exchange {
+      size_t bytes = 0;                 // bytes per replicate
+      size_t chunk_bytes = 0;           // maximum bytes per message
+      int n_chunks = 0;                 // messages per replicate
+      std::vector<void *> send_buffer;  // one per distinct field sent
+      std::vector<void *> recv_buffer;  // one per replicate
+      std::vector<MsgHandle *> mh_send; // [replicate * n_chunks + chunk]
+      std::vector<MsgHandle *> mh_recv; // [replicate * n_chunks + chunk]
+      bool init = false;                // whether the message handles have been declared
+    };
+
+    /**
+       @brief Return the cached exchange for a given split, allocating
+       the buffers if this is the first use.
+       @param[in] comm_key The split-grid key
+       @param[in] join Whether this is a join (true) or a split (false)
+       @param[in] bytes Bytes per replicate
+       @param[in] n_send Number of distinct send buffers
+       @param[in] n_replicates Number of replicates
+       @return The exchange
+    */
+    Exchange &get_exchange(const CommKey &comm_key, bool join, size_t bytes, int n_send, int n_replicates);
+
+    /**
+       @brief Declare the chunked persistent sends and receives for a
+       given replicate
+       @param[in,out] ex The exchange
+       @param[in] i The replicate index
+       @param[in] send_buffer Buffer that replicate i is sent from
+       @param[in] dst_rank Rank that replicate i is sent to
+       @param[in] send_tag Tag used for sending
+       @param[in] src_rank Rank that replicate i is received from
+       @param[in] recv_tag Tag used for receiving
+    */
+    void declare(Exchange &ex, int i, void *send_buffer, int dst_rank, int send_tag, int src_rank, int recv_tag);
+
+    /** @brief Start the receive of replicate i */
+    void start_recv(Exchange &ex, int i);
+
+    /** @brief Start the send of replicate i */
+    void start_send(Exchange &ex, int i);
+
+    /** @brief Query whether all chunks of replicate i have been received */
+    bool recv_complete(Exchange &ex, int i);
+
+    /** @brief Wait for the send of replicate i to complete */
+    void wait_send(Exchange &ex, int i);
+
+    /** @brief Free all cached buffers and message handles */
+    void destroy();
+
+  } // namespace split_grid
+
   template <class Field>
   void inline split_field(Field &collect_field, std::vector<Field *> &v_base_field, const CommKey &comm_key,
                           QudaPCType pc_type = QUDA_4D_PC)
@@ -41,32 +111,42 @@ namespace quda
       = comm_grid_dim / processor_dim; // How many such sub-partitions are there? partition_dim == comm_key
 
     int n_replicates = product(comm_key);
-    std::vector<void *> v_send_buffer_h(n_replicates, nullptr);
-    std::vector<MsgHandle *> v_mh_send(n_replicates, nullptr);
 
     int n_fields = v_base_field.size();
     if (n_fields == 0) { errorQuda("split_field: input field vec has zero size."); }
 
     const auto meta = v_base_field[0];
+    size_t bytes = meta->TotalBytes();
+
+    // replicate i sends field i % n_fields, so each distinct field only needs to be packed once
+    int n_send = std::min(n_fields, n_replicates);
+    auto &ex = split_grid::get_exchange(comm_key, false, bytes, n_send, n_replicates);
+
+    if (!ex.init) {
+      for (int i = 0; i < n_replicates; i++) {
+        auto partition_idx = coordinate_from_index(i, comm_key); // Which partition to send to?
+        auto processor_idx = comm_grid_idx / partition_dim;      // Which processor in that partition to send to?
+        auto dst_idx = partition_idx * processor_dim + processor_idx;
+        int dst_rank = comm_rank_from_coords(dst_idx.data());
+
+        // Here partition_idx means which partition of the field we are receiving, and src_idx where it comes from
+        auto src_idx = (comm_grid_idx % processor_dim) * partition_dim + partition_idx;
+        int src_rank = comm_rank_from_coords(src_idx.data());
+
+        // tag = src_rank * total_rank + dst_rank
+        split_grid::declare(ex, i, ex.send_buffer[i % n_send], dst_rank, rank * total_rank + dst_rank, src_rank,
+                            src_rank * total_rank + rank);
+      }
+      ex.init = true;
+    }
 
-    // Send cycles
-    for (int i = 0; i < n_replicates; i++) {
-      auto partition_idx = coordinate_from_index(i, comm_key); // Which partition to send to?
-      auto processor_idx = comm_grid_idx / partition_dim;      // Which processor in that partition to send to?
-
-      auto dst_idx = partition_idx * processor_dim + processor_idx;
-
-      int dst_rank = comm_rank_from_coords(dst_idx.data());
-      int tag = rank * total_rank + dst_rank; // tag = src_rank * total_rank + dst_rank
-
-      size_t bytes = meta->TotalBytes();
-
-      v_send_buffer_h[i] = pinned_malloc(bytes);
-
-      v_base_field[i % n_fields]->copy_to_buffer(v_send_buffer_h[i]);
+    // prepost all receives so that incoming replicates land directly in the persistent buffers
+    for (int i = 0; i < n_replicates; i++) split_grid::start_recv(ex, i);
 
-      v_mh_send[i] = comm_declare_send_rank(v_send_buffer_h[i], dst_rank, tag, bytes);
-      comm_start(v_mh_send[i]);
+    // Send cycles: pack each field and send it to all replicates that use it
+    for (int k = 0; k < n_send; k++) {
+      v_base_field[k]->copy_to_buffer(ex.send_buffer[k]);
+      for (int i = k; i < n_replicates; i += n_send) split_grid::start_send(ex, i);
     }
 
     using param_type = typename Field::param_type;
@@ -76,45 +156,26 @@ namespace quda
 
     CommKey field_dim = {meta->full_dim(0), meta->full_dim(1), meta->full_dim(2), meta->full_dim(3)};
 
-    // Receive cycles
-    for (int i = 0; i < n_replicates; i++) {
-      auto partition_idx
-        = coordinate_from_index(i, comm_key); // Here this means which partition of the field we are working on.
-      auto src_idx
-        = (comm_grid_idx % processor_dim) * partition_dim + partition_idx; // And where does this partition comes from?
-
-      int src_rank = comm_rank_from_coords(src_idx.data());
-      int tag = src_rank * total_rank + rank;
-
-      size_t bytes = buffer_field->TotalBytes();
-
-      void *recv_buffer_h = pinned_malloc(bytes);
+    // Receive cycles: unpack the partitions in the order they arrive, overlapping with the remaining transfers
+    std::vector<bool> received(n_replicates, false);
+    for (int n_received = 0; n_received < n_replicates;) {
+      for (int i = 0; i < n_replicates; i++) {
+        if (received[i] || !split_grid::recv_complete(ex, i)) continue;
 
-      auto mh_recv = comm_declare_recv_rank(recv_buffer_h, src_rank, tag, bytes);
+        buffer_field->copy_from_buffer(ex.recv_buffer[i]);
 
-      comm_start(mh_recv);
-      comm_wait(mh_recv);
+        auto partition_idx = coordinate_from_index(i, comm_key);
+        auto offset = partition_idx * field_dim;
+        quda::copyFieldOffset(collect_field, *buffer_field, offset, pc_type);
 
-      buffer_field->copy_from_buffer(recv_buffer_h);
-
-      comm_free(mh_recv);
-      host_free(recv_buffer_h);
-
-      auto offset = partition_idx * field_dim;
-
-      quda::copyFieldOffset(collect_field, *buffer_field, offset, pc_type);
+        received[i] = true;
+        n_received++;
+      }
     }
 
     delete buffer_field;
 
-    comm_barrier();
-
-    for (auto &p : v_send_buffer_h) {
-      if (p) { host_free(p); }
-    };
-    for (auto &p : v_mh_send) {
-      if (p) { comm_free(p); }
-    };
+    for (int i = 0; i < n_replicates; i++) split_grid::wait_send(ex, i);
   }
 
   template <class Field>
@@ -132,13 +193,33 @@ namespace quda
       = comm_grid_dim / processor_dim; // The full field needs to be partitioned according to the communicator grid.
 
     int n_replicates = product(comm_key);
-    std::vector<void *> v_send_buffer_h(n_replicates, nullptr);
-    std::vector<MsgHandle *> v_mh_send(n_replicates, nullptr);
 
     int n_fields = v_base_field.size();
     if (n_fields == 0) { errorQuda("join_field: output field vec has zero size."); }
 
     const auto &meta = *(v_base_field[0]);
+    size_t bytes = meta.TotalBytes();
+
+    auto &ex = split_grid::get_exchange(comm_key, true, bytes, n_replicates, n_replicates);
+
+    if (!ex.init) {
+      for (int i = 0; i < n_replicates; i++) {
+        auto partition_idx = coordinate_from_index(i, comm_key);
+        auto dst_idx = (comm_grid_idx % processor_dim) * partition_dim + partition_idx;
+        int dst_rank = comm_rank_from_coords(dst_idx.data());
+
+        auto processor_idx = comm_grid_idx / partition_dim;
+        auto src_idx = partition_idx * processor_dim + processor_idx;
+        int src_rank = comm_rank_from_coords(src_idx.data());
+
+        split_grid::declare(ex, i, ex.send_buffer[i], dst_rank, rank * total_rank + dst_rank, src_rank,
+                            src_rank * total_rank + rank);
+      }
+      ex.init = true;
+    }
+
+    // prepost all receives so that incoming replicates land directly in the persistent buffers
+    for (int i = 0; i < n_replicates; i++) split_grid::start_recv(ex, i);
 
     using param_type = typename Field::param_type;
 
@@ -149,58 +230,31 @@ namespace quda
 
     // Send cycles
     for (int i = 0; i < n_replicates; i++) {
-
       auto partition_idx = coordinate_from_index(i, comm_key);
-      auto dst_idx = (comm_grid_idx % processor_dim) * partition_dim + partition_idx;
-
-      int dst_rank = comm_rank_from_coords(dst_idx.data());
-      int tag = rank * total_rank + dst_rank;
-
-      size_t bytes = meta.TotalBytes();
-
       auto offset = partition_idx * field_dim;
       quda::copyFieldOffset(*buffer_field, collect_field, offset, pc_type);
 
-      v_send_buffer_h[i] = pinned_malloc(bytes);
-      buffer_field->copy_to_buffer(v_send_buffer_h[i]);
-
-      v_mh_send[i] = comm_declare_send_rank(v_send_buffer_h[i], dst_rank, tag, bytes);
-
-      comm_start(v_mh_send[i]);
+      buffer_field->copy_to_buffer(ex.send_buffer[i]);
+      split_grid::start_send(ex, i);
     }
 
-    // Receive cycles
-    for (int i = 0; i < n_replicates; i++) {
-
-      auto partition_idx = coordinate_from_index(i, comm_key);
-      auto processor_idx = comm_grid_idx / partition_dim;
-
-      auto src_idx = partition_idx * processor_dim + processor_idx;
-
-      int src_rank = comm_rank_from_coords(src_idx.data());
-      int tag = src_rank * total_rank + rank;
-
-      size_t bytes = buffer_field->TotalBytes();
-
-      void *recv_buffer_h = pinned_malloc(bytes);
-
-      auto mh_recv = comm_declare_recv_rank(recv_buffer_h, src_rank, tag, bytes);
+    delete buffer_field;
 
-      comm_start(mh_recv);
-      comm_wait(mh_recv);
+    // Receive cycles: replicate i is written to field i % n_fields, so only the last replicate for each field
+    // contributes to the result and the others need not be unpacked.  Unpack in the order of arrival.
+    std::vector<bool> received(n_replicates, false);
+    for (int n_received = 0; n_received < n_replicates;) {
+      for (int i = 0; i < n_replicates; i++) {
+        if (received[i] || !split_grid::recv_complete(ex, i)) continue;
 
-      v_base_field[i % n_fields]->copy_from_buffer(recv_buffer_h);
+        if (i + n_fields >= n_replicates) v_base_field[i % n_fields]->copy_from_buffer(ex.recv_buffer[i]);
 
-      comm_free(mh_recv);
-      host_free(recv_buffer_h);
+        received[i] = true;
+        n_received++;
+      }
     }
 
-    delete buffer_field;
-
-    comm_barrier();
-
-    for (auto &p : v_send_buffer_h) { host_free(p); };
-    for (auto &p : v_mh_send) { comm_free(p); };
+    for (int i = 0; i < n_replicates; i++) split_grid::wait_send(ex, i);
   }
 
 } // namespace quda
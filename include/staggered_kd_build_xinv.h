@@ -27,6 +27,13 @@ namespace quda
   void ReorderStaggeredKahlerDiracInverse(GaugeField &xInvFineLayout, const GaugeField &xInvCoarseLayout,
                                           const bool dagger_approximation, const double mass);
 
+  /**
+     @brief Allocate the Kahler-Dirac inverse block for KD operators without building it
+     @param gauge[in] Original fine gauge field
+     @return allocated Xinv
+  */
+  std::unique_ptr<GaugeField> AllocateStaggeredKahlerDiracInverse(const cudaGaugeField &gauge);
+
   /**
      @brief Allocate and build the Kahler-Dirac inverse block for KD operators
      @param gauge[in] Original fine gauge field
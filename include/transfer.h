@@ -171,17 +171,29 @@ namespace quda {
      * @param parity For single-parity fields are these QUDA_EVEN_PARITY or QUDA_ODD_PARITY
      * @param null_precision The precision to store the null-space basis vectors in
      * @param enable_gpu Whether to enable this to run on GPU (as well as CPU)
+     * @param infile If non-empty, load the prolongator saved with save() rather than block orthogonalizing B
      */
     Transfer(const std::vector<ColorSpinorField *> &B, int Nvec, int NblockOrtho, bool blockOrthoTwoPass, int *geo_bs,
-             int spin_bs, QudaPrecision null_precision, const QudaTransferType transfer_type, TimeProfile &profile);
+             int spin_bs, QudaPrecision null_precision, const QudaTransferType transfer_type, TimeProfile &profile,
+             const std::string &infile = "");
 
     /** The destructor for Transfer */
     virtual ~Transfer();
 
     /**
      @brief for resetting the Transfer when the null vectors have changed
+     @param[in] infile If non-empty, load the prolongator saved with
+     save() rather than block orthogonalizing the null vectors
      */
-    void reset();
+    void reset(const std::string &infile = "");
+
+    /**
+     @brief Save the block-orthonormalized prolongator, so that it can
+     be reloaded with reset(filename).  This is a no-op for the
+     staggered KD transfers, which have no prolongator field.
+     @param[in] filename The file to write
+     */
+    void save(const std::string &filename) const;
 
     /**
      * Apply the prolongator
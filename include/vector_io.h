@@ -7,22 +7,25 @@ namespace quda
 
   /**
      @brief VectorIO is a simple wrapper class for loading and saving
-     sets of vector fields using QIO.
+     sets of vector fields using QIO or the native parallel format
+     (see field_io.h).
    */
   class VectorIO
   {
     const std::string filename;
-#ifdef HAVE_QIO
     bool parity_inflate;
-#endif
+    bool exact;
   public:
     /**
        Constructor for VectorIO class
        @param[in] filename The filename associated with this IO object
        @param[in] parity_inflate Whether to inflate single_parity
        field to dual parity fields for I/O
+       @param[in] exact Whether saves must be exact, in which case the
+       native format is used without compression, regardless of
+       QUDA_IO_FORMAT and QUDA_IO_COMPRESS (e.g., for checkpoints)
     */
-    VectorIO(const std::string &filename, bool parity_inflate = false);
+    VectorIO(const std::string &filename, bool parity_inflate = false, bool exact = false);
 
     /**
        @brief Load vectors from filename
@@ -71,6 +71,22 @@ namespace quda {
 
   uint64_t Checksum(const GaugeField &u, bool mini)
   {
+    // the checksum is only implemented for host orders, so device fields are copied to the host first
+    if (u.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      GaugeFieldParam param(u);
+      param.location = QUDA_CPU_FIELD_LOCATION;
+      param.create = QUDA_NULL_FIELD_CREATE;
+      param.reconstruct = QUDA_RECONSTRUCT_NO;
+      param.order = QUDA_QDP_GAUGE_ORDER;
+      param.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+      param.nFace = 0;
+      param.pad = 0;
+      param.setPrecision(QUDA_DOUBLE_PRECISION);
+      cpuGaugeField host(param);
+      host.copy(u);
+      return Checksum(host, mini);
+    }
+
     uint64_t checksum = 0;
     switch (u.Precision()) {
     case QUDA_DOUBLE_PRECISION: checksum = Checksum<double>(u,mini); break;
@@ -4,6 +4,7 @@
 
 #include <color_spinor_field.h>
 #include <dslash_quda.h>
+#include <halo_compress.h>
 
 static bool zeroCopy = false;
 
@@ -975,8 +976,15 @@ namespace quda
       (from_face_d[0] != ghost_recv_buffer_d[0]) || (from_face_d[1] != ghost_recv_buffer_d[1]) || // receive buffers
       ghost_precision_reset; // ghost_precision has changed
 
+    // compression is only applied to host-staged halos, and since
+    // policies may mix GDR and host-staged sends and receives, we
+    // disable it altogether when GDR is enabled
+    bool compress = halo_compress::mode(ghost_precision) != halo_compress::Mode::NONE && !comm_gdr_enabled();
+    comms_reset = comms_reset || compress != ghost_compress;
+
     if (!initComms || comms_reset) {
 
+      ghost_compress = compress;
       LatticeField::createComms();
 
       // reinitialize the ghost receive pointers
@@ -1110,6 +1118,8 @@ namespace quda
         comm_start(mh_recv_p2p_fwd[bufferIndex][dim]);
       } else if (gdr) {
         comm_start(mh_recv_rdma_fwd[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        comm_start(mh_recv_compress_fwd[bufferIndex][dim]);
       } else {
         comm_start(mh_recv_fwd[bufferIndex][dim]);
       }
@@ -1119,6 +1129,8 @@ namespace quda
         comm_start(mh_recv_p2p_back[bufferIndex][dim]);
       } else if (gdr) {
         comm_start(mh_recv_rdma_back[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        comm_start(mh_recv_compress_back[bufferIndex][dim]);
       } else {
         comm_start(mh_recv_back[bufferIndex][dim]);
       }
@@ -1137,7 +1149,9 @@ namespace quda
     if (gdr && !comm_gdr_enabled()) errorQuda("Requesting GDR comms but GDR is not enabled");
 
     if (!comm_peer2peer_enabled(dir, dim)) {
-      if (dir == 0)
+      if (!gdr && ghost_compress)
+        sendCompressed(dim, dir);
+      else if (dir == 0)
         if (gdr)
           comm_start(mh_send_rdma_back[bufferIndex][dim]);
         else
@@ -1170,6 +1184,28 @@ namespace quda
     }
   }
 
+  void ColorSpinorField::sendCompressed(int dim, int dir)
+  {
+    MsgHandle *mh = dir == 0 ? mh_send_compress_back[bufferIndex][dim] : mh_send_compress_fwd[bufferIndex][dim];
+    bool &active = send_compress_active[bufferIndex][dim][dir];
+
+    // the previous send from this buffer may not have been retired through commsQuery or commsWait
+    if (active) comm_wait(mh);
+
+    // the gather (or zero-copy pack) has completed, so the halo is ready in the pinned send buffer
+    size_t bytes = halo_compress::compress(my_face_compress_dim_dir_h[bufferIndex][dim][dir],
+                                           my_face_dim_dir_h[bufferIndex][dim][dir], ghost_face_bytes[dim], ghost_precision);
+    comm_resize_send(mh, bytes);
+    comm_start(mh);
+    active = true;
+  }
+
+  void ColorSpinorField::recvDecompress(int dim, int dir)
+  {
+    halo_compress::decompress(from_face_dim_dir_h[bufferIndex][dim][dir], from_face_compress_dim_dir_h[bufferIndex][dim][dir],
+                              ghost_face_bytes[dim]);
+  }
+
   void ColorSpinorField::commsStart(int dir, const qudaStream_t &stream, bool gdr_send, bool gdr_recv)
   {
     recvStart(dir, stream, gdr_recv);
@@ -1200,6 +1236,8 @@ namespace quda
         if (!complete_send_back[dim]) complete_send_back[dim] = comm_query(mh_send_p2p_back[bufferIndex][dim]);
       } else if (gdr_send) {
         if (!complete_send_back[dim]) complete_send_back[dim] = comm_query(mh_send_rdma_back[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        if (!complete_send_back[dim]) complete_send_back[dim] = comm_query(mh_send_compress_back[bufferIndex][dim]);
       } else {
         if (!complete_send_back[dim]) complete_send_back[dim] = comm_query(mh_send_back[bufferIndex][dim]);
       }
@@ -1209,11 +1247,16 @@ namespace quda
         if (!complete_recv_fwd[dim]) complete_recv_fwd[dim] = comm_query(mh_recv_p2p_fwd[bufferIndex][dim]);
       } else if (gdr_recv) {
         if (!complete_recv_fwd[dim]) complete_recv_fwd[dim] = comm_query(mh_recv_rdma_fwd[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        if (!complete_recv_fwd[dim]) complete_recv_fwd[dim] = comm_query(mh_recv_compress_fwd[bufferIndex][dim]);
       } else {
         if (!complete_recv_fwd[dim]) complete_recv_fwd[dim] = comm_query(mh_recv_fwd[bufferIndex][dim]);
       }
 
       if (complete_recv_fwd[dim] && complete_send_back[dim]) {
+        if (ghost_compress && !gdr_send && !comm_peer2peer_enabled(0, dim))
+          send_compress_active[bufferIndex][dim][0] = false;
+        if (ghost_compress && !gdr_recv && !comm_peer2peer_enabled(1, dim)) recvDecompress(dim, 1);
         complete_send_back[dim] = false;
         complete_recv_fwd[dim] = false;
         return 1;
@@ -1226,6 +1269,8 @@ namespace quda
         if (!complete_send_fwd[dim]) complete_send_fwd[dim] = comm_query(mh_send_p2p_fwd[bufferIndex][dim]);
       } else if (gdr_send) {
         if (!complete_send_fwd[dim]) complete_send_fwd[dim] = comm_query(mh_send_rdma_fwd[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        if (!complete_send_fwd[dim]) complete_send_fwd[dim] = comm_query(mh_send_compress_fwd[bufferIndex][dim]);
       } else {
         if (!complete_send_fwd[dim]) complete_send_fwd[dim] = comm_query(mh_send_fwd[bufferIndex][dim]);
       }
@@ -1235,11 +1280,16 @@ namespace quda
         if (!complete_recv_back[dim]) complete_recv_back[dim] = comm_query(mh_recv_p2p_back[bufferIndex][dim]);
       } else if (gdr_recv) {
         if (!complete_recv_back[dim]) complete_recv_back[dim] = comm_query(mh_recv_rdma_back[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        if (!complete_recv_back[dim]) complete_recv_back[dim] = comm_query(mh_recv_compress_back[bufferIndex][dim]);
       } else {
         if (!complete_recv_back[dim]) complete_recv_back[dim] = comm_query(mh_recv_back[bufferIndex][dim]);
       }
 
       if (complete_recv_back[dim] && complete_send_fwd[dim]) {
+        if (ghost_compress && !gdr_send && !comm_peer2peer_enabled(1, dim))
+          send_compress_active[bufferIndex][dim][1] = false;
+        if (ghost_compress && !gdr_recv && !comm_peer2peer_enabled(0, dim)) recvDecompress(dim, 0);
         complete_send_fwd[dim] = false;
         complete_recv_back[dim] = false;
         return 1;
@@ -1269,6 +1319,9 @@ namespace quda
         qudaEventSynchronize(ipcCopyEvent[bufferIndex][0][dim]);
       } else if (gdr_send) {
         comm_wait(mh_send_rdma_back[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        comm_wait(mh_send_compress_back[bufferIndex][dim]);
+        send_compress_active[bufferIndex][dim][0] = false;
       } else {
         comm_wait(mh_send_back[bufferIndex][dim]);
       }
@@ -1279,6 +1332,9 @@ namespace quda
         qudaEventSynchronize(ipcRemoteCopyEvent[bufferIndex][1][dim]);
       } else if (gdr_recv) {
         comm_wait(mh_recv_rdma_fwd[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        comm_wait(mh_recv_compress_fwd[bufferIndex][dim]);
+        recvDecompress(dim, 1);
       } else {
         comm_wait(mh_recv_fwd[bufferIndex][dim]);
       }
@@ -1291,6 +1347,9 @@ namespace quda
         qudaEventSynchronize(ipcCopyEvent[bufferIndex][1][dim]);
       } else if (gdr_send) {
         comm_wait(mh_send_rdma_fwd[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        comm_wait(mh_send_compress_fwd[bufferIndex][dim]);
+        send_compress_active[bufferIndex][dim][1] = false;
       } else {
         comm_wait(mh_send_fwd[bufferIndex][dim]);
       }
@@ -1301,12 +1360,29 @@ namespace quda
         qudaEventSynchronize(ipcRemoteCopyEvent[bufferIndex][0][dim]);
       } else if (gdr_recv) {
         comm_wait(mh_recv_rdma_back[bufferIndex][dim]);
+      } else if (ghost_compress) {
+        comm_wait(mh_recv_compress_back[bufferIndex][dim]);
+        recvDecompress(dim, 0);
       } else {
         comm_wait(mh_recv_back[bufferIndex][dim]);
       }
     }
   }
 
+  void ColorSpinorField::neighborExchangeStart()
+  {
+    if (Location() == QUDA_CPU_FIELD_LOCATION) errorQuda("Host field not supported");
+    if (!mh_neighbor[bufferIndex]) errorQuda("Neighborhood collective halo exchange not enabled");
+    comm_start(mh_neighbor[bufferIndex]);
+  }
+
+  void ColorSpinorField::neighborExchangeWait()
+  {
+    if (Location() == QUDA_CPU_FIELD_LOCATION) errorQuda("Host field not supported");
+    if (!mh_neighbor[bufferIndex]) errorQuda("Neighborhood collective halo exchange not enabled");
+    comm_wait(mh_neighbor[bufferIndex]);
+  }
+
   void ColorSpinorField::scatter(int dim_dir, const qudaStream_t &stream)
   {
     if (Location() == QUDA_CPU_FIELD_LOCATION) errorQuda("Host field not supported");
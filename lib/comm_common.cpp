@@ -1,6 +1,8 @@
 #include <unistd.h> // for gethostname()
 #include <assert.h>
 #include <limits>
+#include <cstring>
+#include <vector>
 
 #include <quda_internal.h>
 #include <communicator_quda.h>
@@ -128,6 +130,184 @@ Topology *comm_create_topology(int ndim, const int *dims, QudaCommsMap rank_from
   return topo;
 }
 
+int comm_topology_rank_from_coords(const int *coords, void *fdata)
+{
+  auto *md = static_cast<TopologyMapData *>(fdata);
+  return md->ranks[index(md->ndim, md->dims, coords)];
+}
+
+/**
+   Number of face sites in each dimension, or unit weights if the
+   local lattice dimensions are not known
+ */
+static void topology_face_sites(const TopologyMapData &md, double face[QUDA_MAX_DIM])
+{
+  bool known = true;
+  double volume = 1.0;
+  for (int d = 0; d < md.ndim; d++) {
+    known = known && md.local_dims[d] > 0;
+    volume *= md.local_dims[d];
+  }
+  for (int d = 0; d < md.ndim; d++) face[d] = known ? volume / md.local_dims[d] : 1.0;
+}
+
+/**
+   Total number of face sites, summed over all ranks and directions,
+   that are exchanged between different nodes for a given rank table.
+ */
+static double topology_inter_node_faces(const TopologyMapData &md, const std::vector<int> &ranks,
+                                        const std::vector<int> &node_of_rank)
+{
+  double face[QUDA_MAX_DIM];
+  topology_face_sites(md, face);
+
+  double faces = 0.0;
+  int x[QUDA_MAX_DIM] = {};
+  do {
+    int node = node_of_rank[ranks[index(md.ndim, md.dims, x)]];
+    for (int d = 0; d < md.ndim; d++) {
+      if (md.dims[d] == 1) continue;
+      for (int dir = -1; dir <= 1; dir += 2) {
+        int y[QUDA_MAX_DIM];
+        for (int i = 0; i < md.ndim; i++) y[i] = x[i];
+        y[d] = (x[d] + dir + md.dims[d]) % md.dims[d];
+        if (node_of_rank[ranks[index(md.ndim, md.dims, y)]] != node) faces += face[d];
+      }
+    }
+  } while (advance_coords(md.ndim, md.dims, x));
+
+  return faces;
+}
+
+/**
+   Advance to the next candidate node-local block, with 1 <= b[d] <= dims[d]
+ */
+static bool advance_block(int ndim, const int *dims, int *b)
+{
+  for (int d = ndim - 1; d >= 0; d--) {
+    if (b[d] < dims[d]) {
+      b[d]++;
+      return true;
+    }
+    b[d] = 1;
+  }
+  return false;
+}
+
+void comm_build_topology_map(TopologyMapData &md, const char *hostname_recv_buf, int size)
+{
+  // group the ranks by node, with nodes ordered by their lowest rank
+  std::vector<int> node_of_rank(size);
+  std::vector<int> local_rank(size);
+  std::vector<int> node_size;
+  for (int r = 0; r < size; r++) {
+    node_of_rank[r] = -1;
+    for (int s = 0; s < r; s++) {
+      if (!strncmp(&hostname_recv_buf[128 * r], &hostname_recv_buf[128 * s], 128)) {
+        node_of_rank[r] = node_of_rank[s];
+        break;
+      }
+    }
+    if (node_of_rank[r] < 0) {
+      node_of_rank[r] = node_size.size();
+      node_size.push_back(0);
+    }
+    local_rank[r] = node_size[node_of_rank[r]]++;
+  }
+
+  const int nodes = node_size.size();
+  const int ranks_per_node = size / nodes;
+  bool uniform = true;
+  for (auto n : node_size) uniform = uniform && n == ranks_per_node;
+
+  double face[QUDA_MAX_DIM];
+  topology_face_sites(md, face);
+
+  // find the node-local block of ranks that minimizes the inter-node face volume
+  int block[QUDA_MAX_DIM];
+  bool found = false;
+  double min_cost = std::numeric_limits<double>::max();
+  if (uniform) {
+    int b[QUDA_MAX_DIM];
+    for (int d = 0; d < md.ndim; d++) b[d] = 1;
+    do {
+      int volume = 1;
+      bool divides = true;
+      for (int d = 0; d < md.ndim; d++) {
+        volume *= b[d];
+        divides = divides && md.dims[d] % b[d] == 0;
+      }
+      if (!divides || volume != ranks_per_node) continue;
+
+      // each rank on the block boundary has one off-node neighbor in that direction
+      double cost = 0.0;
+      for (int d = 0; d < md.ndim; d++)
+        if (md.dims[d] > 1 && b[d] < md.dims[d]) cost += 2.0 * (ranks_per_node / b[d]) * face[d];
+
+      if (cost < min_cost) {
+        min_cost = cost;
+        for (int d = 0; d < md.ndim; d++) block[d] = b[d];
+        found = true;
+      }
+    } while (advance_block(md.ndim, md.dims, b));
+  }
+
+  int grid_size = 1;
+  for (int d = 0; d < md.ndim; d++) grid_size *= md.dims[d];
+  std::vector<int> lex_ranks(grid_size);
+  for (int i = 0; i < grid_size; i++) lex_ranks[i] = i;
+
+  if (!found) {
+    warningQuda("Ranks are not evenly distributed over a node-local block of the process grid, using lexicographic "
+                "mapping");
+    md.ranks = lex_ranks;
+    return;
+  }
+
+  int node_dims[QUDA_MAX_DIM];
+  for (int d = 0; d < md.ndim; d++) node_dims[d] = md.dims[d] / block[d];
+
+  md.ranks.resize(grid_size);
+  for (int r = 0; r < size; r++) {
+    int node_coords[QUDA_MAX_DIM];
+    int local_coords[QUDA_MAX_DIM];
+    int n = node_of_rank[r];
+    int l = local_rank[r];
+    for (int d = md.ndim - 1; d >= 0; d--) {
+      node_coords[d] = n % node_dims[d];
+      n /= node_dims[d];
+      local_coords[d] = l % block[d];
+      l /= block[d];
+    }
+
+    int x[QUDA_MAX_DIM];
+    for (int d = 0; d < md.ndim; d++) x[d] = node_coords[d] * block[d] + local_coords[d];
+    md.ranks[index(md.ndim, md.dims, x)] = r;
+  }
+
+  if (getVerbosity() >= QUDA_SUMMARIZE) {
+    double faces = topology_inter_node_faces(md, md.ranks, node_of_rank);
+    double lex_faces = topology_inter_node_faces(md, lex_ranks, node_of_rank);
+
+    char block_string[64];
+    int n = snprintf(block_string, sizeof(block_string), "%d", block[0]);
+    for (int d = 1; d < md.ndim; d++) n += snprintf(block_string + n, sizeof(block_string) - n, "x%d", block[d]);
+    printfQuda("Topology-aware rank mapping: %d nodes with %d ranks per node, node block = %s\n", nodes,
+               ranks_per_node, block_string);
+
+    bool known = true;
+    for (int d = 0; d < md.ndim; d++) known = known && md.local_dims[d] > 0;
+    if (known) {
+      // report bytes for a double-precision spin-projected Wilson halo (12 reals per site)
+      constexpr double site_bytes = 12 * sizeof(double);
+      printfQuda("Inter-node face bytes per double-precision Wilson halo exchange = %e (lexicographic mapping = %e)\n",
+                 faces * site_bytes, lex_faces * site_bytes);
+    } else {
+      printfQuda("Inter-node faces per halo exchange = %g (lexicographic mapping = %g)\n", faces, lex_faces);
+    }
+  }
+}
+
 void comm_abort(int status)
 {
 #ifdef HOST_DEBUG
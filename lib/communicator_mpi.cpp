@@ -1,4 +1,5 @@
 #include <communicator_quda.h>
+#include <reproducible_reduce.h>
 
 #define MPI_CHECK(mpi_call)                                                                                            \
   do {                                                                                                                 \
@@ -30,6 +31,44 @@ struct MsgHandle_s {
      determine whether we need to free the datatype or not.
    */
   bool custom;
+
+  /**
+     Whether this handle is a neighborhood collective over the halo
+     graph communicator rather than a point-to-point message.
+   */
+  bool neighbor;
+
+  /**
+     Whether the neighborhood collective request is persistent
+     (MPI-4), or whether it is posted as a non-blocking collective on
+     each comm_start.
+   */
+  bool persistent;
+
+  /**
+     Per-neighbor send counts, send displacements, receive counts and
+     receive displacements of the neighborhood collective (these must
+     outlive the request).
+   */
+  int *counts;
+  int degree;
+  void *send_buffer;
+  void *recv_buffer;
+
+  /**
+     The graph communicator the neighborhood collective is declared
+     on, of which this handle holds a reference.
+   */
+  Communicator::NeighborGraph *graph;
+
+  /**
+     The buffer, size, peer and tag of a point-to-point send, kept so
+     that the size of the message can be changed (comm_resize_send).
+   */
+  void *buffer;
+  size_t nbytes;
+  int rank;
+  int tag;
 };
 
 Communicator::Communicator(int nDim, const int *commDims, QudaCommsMap rank_from_coords, void *map_data,
@@ -84,6 +123,7 @@ Communicator::Communicator(Communicator &other, const int *comm_split) : globalR
 Communicator::~Communicator()
 {
   comm_finalize();
+  if (neighbor_graph) comm_release_neighbor_graph(neighbor_graph);
   if (!user_set_comm_handle) { MPI_Comm_free(&MPI_COMM_HANDLE); }
 }
 
@@ -133,6 +173,11 @@ MsgHandle *Communicator::comm_declare_send_rank(void *buffer, int rank, int tag,
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
   MPI_CHECK(MPI_Send_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_HANDLE, &(mh->request)));
   mh->custom = false;
+  mh->neighbor = false;
+  mh->buffer = buffer;
+  mh->nbytes = nbytes;
+  mh->rank = rank;
+  mh->tag = tag;
 
   return mh;
 }
@@ -145,6 +190,7 @@ MsgHandle *Communicator::comm_declare_recv_rank(void *buffer, int rank, int tag,
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
   MPI_CHECK(MPI_Recv_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_HANDLE, &(mh->request)));
   mh->custom = false;
+  mh->neighbor = false;
 
   return mh;
 }
@@ -167,6 +213,11 @@ MsgHandle *Communicator::comm_declare_send_displaced(void *buffer, const int dis
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
   MPI_CHECK(MPI_Send_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_HANDLE, &(mh->request)));
   mh->custom = false;
+  mh->neighbor = false;
+  mh->buffer = buffer;
+  mh->nbytes = nbytes;
+  mh->rank = rank;
+  mh->tag = tag;
 
   return mh;
 }
@@ -189,6 +240,7 @@ MsgHandle *Communicator::comm_declare_receive_displaced(void *buffer, const int
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
   MPI_CHECK(MPI_Recv_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_HANDLE, &(mh->request)));
   mh->custom = false;
+  mh->neighbor = false;
 
   return mh;
 }
@@ -215,6 +267,7 @@ MsgHandle *Communicator::comm_declare_strided_send_displaced(void *buffer, const
   MPI_CHECK(MPI_Type_vector(nblocks, blksize, stride, MPI_BYTE, &(mh->datatype)));
   MPI_CHECK(MPI_Type_commit(&(mh->datatype)));
   mh->custom = true;
+  mh->neighbor = false;
 
   MPI_CHECK(MPI_Send_init(buffer, 1, mh->datatype, rank, tag, MPI_COMM_HANDLE, &(mh->request)));
 
@@ -243,21 +296,161 @@ MsgHandle *Communicator::comm_declare_strided_receive_displaced(void *buffer, co
   MPI_CHECK(MPI_Type_vector(nblocks, blksize, stride, MPI_BYTE, &(mh->datatype)));
   MPI_CHECK(MPI_Type_commit(&(mh->datatype)));
   mh->custom = true;
+  mh->neighbor = false;
 
   MPI_CHECK(MPI_Recv_init(buffer, 1, mh->datatype, rank, tag, MPI_COMM_HANDLE, &(mh->request)));
 
   return mh;
 }
 
+/**
+ * Return the distributed graph communicator used for neighborhood
+ * collective halo exchange, creating it if the partitioning has
+ * changed.  Each partitioned dimension contributes two edges in each
+ * direction.  The destinations are ordered (forwards, backwards)
+ * while the sources are ordered (backwards, forwards), so that when
+ * both neighbors are the same rank (a dimension of length two) the
+ * k-th message sent to that rank still matches the k-th receive from
+ * it: what we send forwards is what the neighbor receives from its
+ * backwards neighbor.
+ */
+Communicator::NeighborGraph *Communicator::comm_acquire_neighbor_graph()
+{
+  Topology *topo = comm_default_topology();
+  int ndim = comm_ndim(topo);
+
+  int partitioned = 0;
+  for (int d = 0; d < ndim; d++) partitioned |= (comm_dim_partitioned(d) ? 1 : 0) << d;
+
+  if (neighbor_graph && neighbor_graph->partitioned != partitioned) comm_release_neighbor_graph(neighbor_graph);
+
+  if (!neighbor_graph) {
+    std::vector<int> sources;
+    std::vector<int> destinations;
+    for (int d = 0; d < ndim; d++) {
+      if (!(partitioned & (1 << d))) continue;
+      int disp[QUDA_MAX_DIM] = {};
+      disp[d] = -1;
+      int back = comm_rank_displaced(topo, disp);
+      disp[d] = +1;
+      int fwd = comm_rank_displaced(topo, disp);
+
+      destinations.push_back(fwd);
+      destinations.push_back(back);
+      sources.push_back(back);
+      sources.push_back(fwd);
+    }
+
+    neighbor_graph = new NeighborGraph;
+    MPI_CHECK(MPI_Dist_graph_create_adjacent(MPI_COMM_HANDLE, sources.size(), sources.data(), MPI_UNWEIGHTED,
+                                             destinations.size(), destinations.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+                                             0, &(neighbor_graph->comm)));
+    neighbor_graph->partitioned = partitioned;
+    neighbor_graph->refs = 1;
+  }
+
+  neighbor_graph->refs++;
+  return neighbor_graph;
+}
+
+void Communicator::comm_release_neighbor_graph(NeighborGraph *&graph)
+{
+  if (--graph->refs == 0) {
+    MPI_CHECK(MPI_Comm_free(&(graph->comm)));
+    delete graph;
+  }
+  graph = nullptr;
+}
+
+MsgHandle *Communicator::comm_declare_neighbor_exchange(void *send_buffer, void *recv_buffer,
+                                                        const size_t offset[][2], const size_t bytes[])
+{
+  NeighborGraph *graph = comm_acquire_neighbor_graph();
+
+  Topology *topo = comm_default_topology();
+  int ndim = comm_ndim(topo);
+
+  int n = 0;
+  for (int d = 0; d < ndim; d++)
+    if (graph->partitioned & (1 << d)) n += 2;
+
+  MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  mh->custom = false;
+  mh->neighbor = true;
+  mh->counts = static_cast<int *>(safe_malloc(4 * n * sizeof(int)));
+  mh->degree = n;
+  mh->send_buffer = send_buffer;
+  mh->recv_buffer = recv_buffer;
+  mh->graph = graph;
+
+  int *send_counts = mh->counts;
+  int *send_displs = mh->counts + n;
+  int *recv_counts = mh->counts + 2 * n;
+  int *recv_displs = mh->counts + 3 * n;
+
+  int k = 0;
+  for (int d = 0; d < ndim; d++) {
+    if (!(graph->partitioned & (1 << d))) continue;
+    if (bytes[d] + offset[d][1] > static_cast<size_t>(std::numeric_limits<int>::max()))
+      errorQuda("Halo size %lu exceeds neighborhood collective limit", bytes[d]);
+
+    for (int j = 0; j < 2; j++) { // see comm_acquire_neighbor_graph for the edge ordering
+      send_counts[k + j] = bytes[d];
+      send_displs[k + j] = offset[d][1 - j];
+      recv_counts[k + j] = bytes[d];
+      recv_displs[k + j] = offset[d][j];
+    }
+    k += 2;
+  }
+
+#if MPI_VERSION >= 4
+  MPI_CHECK(MPI_Neighbor_alltoallv_init(send_buffer, send_counts, send_displs, MPI_BYTE, recv_buffer, recv_counts,
+                                        recv_displs, MPI_BYTE, graph->comm, MPI_INFO_NULL, &(mh->request)));
+  mh->persistent = true;
+#else
+  mh->request = MPI_REQUEST_NULL;
+  mh->persistent = false;
+#endif
+
+  return mh;
+}
+
 void Communicator::comm_free(MsgHandle *&mh)
 {
-  MPI_CHECK(MPI_Request_free(&(mh->request)));
+  if (!mh->neighbor || mh->persistent) {
+    MPI_CHECK(MPI_Request_free(&(mh->request)));
+  } else if (mh->request != MPI_REQUEST_NULL) {
+    MPI_CHECK(MPI_Wait(&(mh->request), MPI_STATUS_IGNORE));
+  }
   if (mh->custom) MPI_CHECK(MPI_Type_free(&(mh->datatype)));
+  if (mh->neighbor) {
+    host_free(mh->counts);
+    comm_release_neighbor_graph(mh->graph);
+  }
   host_free(mh);
   mh = nullptr;
 }
 
-void Communicator::comm_start(MsgHandle *mh) { MPI_CHECK(MPI_Start(&(mh->request))); }
+void Communicator::comm_resize_send(MsgHandle *mh, size_t nbytes)
+{
+  if (mh->custom || mh->neighbor) errorQuda("Only point-to-point sends can be resized");
+  if (nbytes == mh->nbytes) return;
+  // a persistent request has a fixed count, so re-initialize it in place
+  MPI_CHECK(MPI_Request_free(&(mh->request)));
+  MPI_CHECK(MPI_Send_init(mh->buffer, nbytes, MPI_BYTE, mh->rank, mh->tag, MPI_COMM_HANDLE, &(mh->request)));
+  mh->nbytes = nbytes;
+}
+
+void Communicator::comm_start(MsgHandle *mh)
+{
+  if (mh->neighbor && !mh->persistent) {
+    int n = mh->degree;
+    MPI_CHECK(MPI_Ineighbor_alltoallv(mh->send_buffer, mh->counts, mh->counts + n, MPI_BYTE, mh->recv_buffer,
+                                      mh->counts + 2 * n, mh->counts + 3 * n, MPI_BYTE, mh->graph->comm, &(mh->request)));
+  } else {
+    MPI_CHECK(MPI_Start(&(mh->request)));
+  }
+}
 
 void Communicator::comm_wait(MsgHandle *mh) { MPI_CHECK(MPI_Wait(&(mh->request), MPI_STATUS_IGNORE)); }
 
@@ -276,11 +469,7 @@ void Communicator::comm_allreduce(double *data)
     MPI_CHECK(MPI_Allreduce(data, &recvbuf, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_HANDLE));
     *data = recvbuf;
   } else {
-    const size_t n = comm_size();
-    double *recv_buf = (double *)safe_malloc(n * sizeof(double));
-    MPI_CHECK(MPI_Allgather(data, 1, MPI_DOUBLE, recv_buf, 1, MPI_DOUBLE, MPI_COMM_HANDLE));
-    *data = deterministic_reduce(recv_buf, n);
-    host_free(recv_buf);
+    quda::reproducible::allreduce(data, 1, MPI_COMM_HANDLE);
   }
 }
 
@@ -306,19 +495,7 @@ void Communicator::comm_allreduce_array(double *data, size_t size)
     memcpy(data, recvbuf, size * sizeof(double));
     delete[] recvbuf;
   } else {
-    size_t n = comm_size();
-    double *recv_buf = new double[size * n];
-    MPI_CHECK(MPI_Allgather(data, size, MPI_DOUBLE, recv_buf, size, MPI_DOUBLE, MPI_COMM_HANDLE));
-
-    double *recv_trans = new double[size * n];
-    for (size_t i = 0; i < n; i++) {
-      for (size_t j = 0; j < size; j++) { recv_trans[j * n + i] = recv_buf[i * size + j]; }
-    }
-
-    for (size_t i = 0; i < size; i++) { data[i] = deterministic_reduce(recv_trans + i * n, n); }
-
-    delete[] recv_buf;
-    delete[] recv_trans;
+    quda::reproducible::allreduce(data, size, MPI_COMM_HANDLE);
   }
 }
 
@@ -1,4 +1,5 @@
 #include <communicator_quda.h>
+#include <reproducible_reduce.h>
 #include <mpi_comm_handle.h>
 
 #define QMP_CHECK(qmp_call)                                                                                            \
@@ -22,6 +23,14 @@
 struct MsgHandle_s {
   QMP_msgmem_t mem;
   QMP_msghandle_t handle;
+
+  /**
+     The buffer, size and peer of a contiguous send, kept so that the
+     size of the message can be changed (comm_resize_send).
+   */
+  void *buffer;
+  size_t nbytes;
+  int rank;
 };
 
 // While we can emulate an all-gather using QMP reductions, this
@@ -183,6 +192,9 @@ MsgHandle *Communicator::comm_declare_send_rank(void *buffer, int rank, int, siz
 
   mh->handle = QMP_comm_declare_send_to(QMP_COMM_HANDLE, mh->mem, rank, 0);
   if (mh->handle == NULL) errorQuda("Unable to allocate QMP message handle");
+  mh->buffer = buffer;
+  mh->nbytes = nbytes;
+  mh->rank = rank;
 
   return mh;
 }
@@ -218,6 +230,9 @@ MsgHandle *Communicator::comm_declare_send_displaced(void *buffer, const int dis
 
   mh->handle = QMP_comm_declare_send_to(QMP_COMM_HANDLE, mh->mem, rank, 0);
   if (mh->handle == NULL) errorQuda("Unable to allocate QMP message handle");
+  mh->buffer = buffer;
+  mh->nbytes = nbytes;
+  mh->rank = rank;
 
   return mh;
 }
@@ -283,6 +298,12 @@ MsgHandle *Communicator::comm_declare_strided_receive_displaced(void *buffer, co
   return mh;
 }
 
+MsgHandle *Communicator::comm_declare_neighbor_exchange(void *, void *, const size_t[][2], const size_t[])
+{
+  errorQuda("Neighborhood collective halo exchange is not supported with QMP");
+  return nullptr;
+}
+
 void Communicator::comm_free(MsgHandle *&mh)
 {
   QMP_free_msghandle(mh->handle);
@@ -291,6 +312,21 @@ void Communicator::comm_free(MsgHandle *&mh)
   mh = nullptr;
 }
 
+void Communicator::comm_resize_send(MsgHandle *mh, size_t nbytes)
+{
+  if (nbytes == mh->nbytes) return;
+  // QMP message memory has a fixed size, so re-declare the handle in place
+  QMP_free_msghandle(mh->handle);
+  QMP_free_msgmem(mh->mem);
+
+  mh->mem = QMP_declare_msgmem(mh->buffer, nbytes);
+  if (mh->mem == NULL) errorQuda("Unable to allocate QMP message memory");
+
+  mh->handle = QMP_comm_declare_send_to(QMP_COMM_HANDLE, mh->mem, mh->rank, 0);
+  if (mh->handle == NULL) errorQuda("Unable to allocate QMP message handle");
+  mh->nbytes = nbytes;
+}
+
 void Communicator::comm_start(MsgHandle *mh) { QMP_CHECK(QMP_start(mh->handle)); }
 
 void Communicator::comm_wait(MsgHandle *mh) { QMP_CHECK(QMP_wait(mh->handle)); }
@@ -302,12 +338,7 @@ void Communicator::comm_allreduce(double *data)
   if (!comm_deterministic_reduce()) {
     QMP_CHECK(QMP_comm_sum_double(QMP_COMM_HANDLE, data));
   } else {
-    // we need to break out of QMP for the deterministic floating point reductions
-    const size_t n = comm_size();
-    double *recv_buf = (double *)safe_malloc(n * sizeof(double));
-    MPI_CHECK(MPI_Allgather(data, 1, MPI_DOUBLE, recv_buf, 1, MPI_DOUBLE, MPI_COMM_HANDLE));
-    *data = deterministic_reduce(recv_buf, n);
-    host_free(recv_buf);
+    quda::reproducible::allreduce(data, 1, MPI_COMM_HANDLE);
   }
 }
 
@@ -320,20 +351,7 @@ void Communicator::comm_allreduce_array(double *data, size_t size)
   if (!comm_deterministic_reduce()) {
     QMP_CHECK(QMP_comm_sum_double_array(QMP_COMM_HANDLE, data, size));
   } else {
-    // we need to break out of QMP for the deterministic floating point reductions
-    size_t n = comm_size();
-    double *recv_buf = new double[size * n];
-    MPI_CHECK(MPI_Allgather(data, size, MPI_DOUBLE, recv_buf, size, MPI_DOUBLE, MPI_COMM_HANDLE));
-
-    double *recv_trans = new double[size * n];
-    for (size_t i = 0; i < n; i++) {
-      for (size_t j = 0; j < size; j++) { recv_trans[j * n + i] = recv_buf[i * size + j]; }
-    }
-
-    for (size_t i = 0; i < size; i++) { data[i] = deterministic_reduce(recv_trans + i * n, n); }
-
-    delete[] recv_buf;
-    delete[] recv_trans;
+    quda::reproducible::allreduce(data, size, MPI_COMM_HANDLE);
   }
 }
 
@@ -71,8 +71,15 @@ MsgHandle *Communicator::comm_declare_strided_receive_displaced(void *, const in
   return nullptr;
 }
 
+MsgHandle *Communicator::comm_declare_neighbor_exchange(void *, void *, const size_t[][2], const size_t[])
+{
+  return nullptr;
+}
+
 void Communicator::comm_free(MsgHandle *&) { }
 
+void Communicator::comm_resize_send(MsgHandle *, size_t) { }
+
 void Communicator::comm_start(MsgHandle *) { }
 
 void Communicator::comm_wait(MsgHandle *) { }
@@ -127,6 +127,8 @@ bool comm_gdr_blacklist() { return get_current_communicator().comm_gdr_blacklist
 
 bool comm_nvshmem_enabled() { return get_current_communicator().comm_nvshmem_enabled(); }
 
+bool comm_neighbor_exchange_enabled() { return get_current_communicator().comm_neighbor_exchange_enabled(); }
+
 MsgHandle *comm_declare_send_rank(void *buffer, int rank, int tag, size_t nbytes)
 {
   return get_current_communicator().comm_declare_send_rank(buffer, rank, tag, nbytes);
@@ -160,8 +162,16 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
                                                                            stride);
 }
 
+MsgHandle *comm_declare_neighbor_exchange(void *send_buffer, void *recv_buffer, const size_t offset[][2],
+                                          const size_t bytes[])
+{
+  return get_current_communicator().comm_declare_neighbor_exchange(send_buffer, recv_buffer, offset, bytes);
+}
+
 void comm_free(MsgHandle *&mh) { get_current_communicator().comm_free(mh); }
 
+void comm_resize_send(MsgHandle *mh, size_t nbytes) { get_current_communicator().comm_resize_send(mh, nbytes); }
+
 void comm_start(MsgHandle *mh) { get_current_communicator().comm_start(mh); }
 
 void comm_wait(MsgHandle *mh) { get_current_communicator().comm_wait(mh); }
@@ -194,6 +204,15 @@ void comm_broadcast(void *data, size_t nbytes) { get_current_communicator().comm
 
 void comm_broadcast_global(void *data, size_t nbytes) { get_default_communicator().comm_broadcast(data, nbytes); }
 
+void *comm_mpi_handle()
+{
+#if defined(QMP_COMMS) || defined(MPI_COMMS)
+  return &get_current_communicator().MPI_COMM_HANDLE;
+#else
+  return nullptr;
+#endif
+}
+
 void comm_barrier(void) { get_current_communicator().comm_barrier(); }
 
 void comm_abort_(int status) { Communicator::comm_abort_(status); };
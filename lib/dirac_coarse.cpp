@@ -5,7 +5,7 @@
 
 namespace quda {
 
-  DiracCoarse::DiracCoarse(const DiracParam &param, bool gpu_setup, bool mapped) :
+  DiracCoarse::DiracCoarse(const DiracParam &param, bool gpu_setup, bool mapped, const std::string &infile) :
     Dirac(param),
     mass(param.mass),
     mu(param.mu),
@@ -30,7 +30,7 @@ namespace quda {
     init_cpu(!gpu_setup),
     mapped(mapped)
   {
-    initializeCoarse();
+    initializeCoarse(infile);
   }
 
   DiracCoarse::DiracCoarse(const DiracParam &param, cpuGaugeField *Y_h, cpuGaugeField *X_h, cpuGaugeField *Xinv_h,
@@ -193,10 +193,32 @@ namespace quda {
     else     Xinv_h = new cpuGaugeField(gParam);
   }
 
-  void DiracCoarse::initializeCoarse()
+  void DiracCoarse::initializeCoarse(const std::string &infile)
   {
     createY(gpu_setup, mapped);
 
+    if (infile.size() > 0) {
+      createYhat(gpu_setup);
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Loading the coarse op from %s\n", infile.c_str());
+      // the ghost zones are exchanged when copying from the host staging fields
+      if (gpu_setup) {
+        loadGaugeField(infile + "_Y", *Y_d);
+        loadGaugeField(infile + "_X", *X_d);
+        loadGaugeField(infile + "_Xinv", *Xinv_d);
+        loadGaugeField(infile + "_Yhat", *Yhat_d);
+        enable_gpu = true;
+        init_gpu = true;
+      } else {
+        loadGaugeField(infile + "_Y", *Y_h);
+        loadGaugeField(infile + "_X", *X_h);
+        loadGaugeField(infile + "_Xinv", *Xinv_h);
+        loadGaugeField(infile + "_Yhat", *Yhat_h);
+        enable_cpu = true;
+        init_cpu = true;
+      }
+      return;
+    }
+
     if (!gpu_setup) {
 
       dirac->createCoarseOp(*Y_h, *X_h, *transfer, kappa, mass, Mu(), MuFactor(), AllowTruncation());
@@ -319,6 +341,23 @@ namespace quda {
     }
   }
 
+  void DiracCoarse::save(const std::string &prefix) const
+  {
+    if (enable_gpu) {
+      saveGaugeField(prefix + "_Y", *Y_d);
+      saveGaugeField(prefix + "_X", *X_d);
+      saveGaugeField(prefix + "_Xinv", *Xinv_d);
+      saveGaugeField(prefix + "_Yhat", *Yhat_d);
+    } else if (enable_cpu) {
+      saveGaugeField(prefix + "_Y", *Y_h);
+      saveGaugeField(prefix + "_X", *X_h);
+      saveGaugeField(prefix + "_Xinv", *Xinv_h);
+      saveGaugeField(prefix + "_Yhat", *Yhat_h);
+    } else {
+      errorQuda("Neither CPU or GPU coarse fields initialized");
+    }
+  }
+
   void DiracCoarse::createPreconditionedCoarseOp(GaugeField &Yhat, GaugeField &Xinv, const GaugeField &Y, const GaugeField &X) {
     calculateYhat(Yhat, Xinv, Y, X, use_mma);
   }
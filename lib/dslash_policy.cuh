@@ -1637,6 +1637,76 @@ namespace quda
     }
   };
 
+  /**
+     Dslash parallelization with host staging for send and receive,
+     where the halos in all dimensions and directions are exchanged
+     with a single persistent neighborhood collective, allowing the
+     MPI library to schedule and aggregate the transfers.  Since the
+     collective covers all halos, peer-to-peer is disabled for this
+     policy and all halos are gathered before the exchange starts.
+  */
+  template <typename Dslash> struct DslashNeighborCollective : DslashPolicyImp<Dslash> {
+
+    void operator()(Dslash &dslash, ColorSpinorField *in, const int volume, const int *faceVolumeCB,
+                    TimeProfile &profile)
+    {
+      profile.TPSTART(QUDA_PROFILE_TOTAL);
+
+      auto &dslashParam = dslash.dslashParam;
+      dslashParam.kernel_type = INTERIOR_KERNEL;
+      dslashParam.threads = volume;
+      dslash.setShmem(0);
+
+      bool p2p_enabled = comm_peer2peer_enabled_global();
+      comm_enable_peer2peer(false);
+
+      const int packIndex = device::get_default_stream_idx();
+      const int parity_src = (in->SiteSubset() == QUDA_PARITY_SITE_SUBSET ? 1 - dslashParam.parity : 0);
+      issuePack(*in, dslash, parity_src, Device, packIndex);
+
+      issueGather(*in, dslash);
+
+      PROFILE(if (dslash_interior_compute) dslash.apply(device::get_default_stream()), profile, QUDA_PROFILE_DSLASH_KERNEL);
+      if (aux_worker) aux_worker->apply(device::get_default_stream());
+
+      bool comms = false;
+      for (int i = 3; i >= 0; i--) comms = comms || dslashParam.commDim[i];
+
+      if (comms) {
+        // the collective can only start once all halos have arrived on the host
+        for (int i = 3; i >= 0; i--) {
+          if (!dslashParam.commDim[i]) continue;
+          for (int dir = 1; dir >= 0; dir--)
+            PROFILE(qudaEventSynchronize(gatherEnd[2 * i + dir]), profile, QUDA_PROFILE_EVENT_SYNCHRONIZE);
+        }
+
+        PROFILE(if (dslash_comms) in->neighborExchangeStart(), profile, QUDA_PROFILE_COMMS_START);
+        PROFILE(if (dslash_comms) in->neighborExchangeWait(), profile, QUDA_PROFILE_COMMS_QUERY);
+
+        const int scatterIndex = getStreamIndex(dslashParam);
+        for (int i = 3; i >= 0; i--) {
+          if (!dslashParam.commDim[i]) continue;
+          for (int dir = 1; dir >= 0; dir--)
+            PROFILE(if (dslash_copy) in->scatter(2 * i + dir, device::get_stream(scatterIndex)), profile,
+                    QUDA_PROFILE_SCATTER);
+        }
+
+        PROFILE(qudaEventRecord(scatterEnd[0], device::get_stream(scatterIndex)), profile, QUDA_PROFILE_EVENT_RECORD);
+        PROFILE(qudaStreamWaitEvent(device::get_default_stream(), scatterEnd[0], 0), profile,
+                QUDA_PROFILE_STREAM_WAIT_EVENT);
+
+        setFusedParam(dslashParam, dslash, faceVolumeCB); // setup for exterior kernel
+        PROFILE(if (dslash_exterior_compute) dslash.apply(device::get_default_stream()), profile, QUDA_PROFILE_DSLASH_KERNEL);
+      }
+
+      completeDslash(*in, dslashParam);
+      in->bufferIndex = (1 - in->bufferIndex);
+
+      comm_enable_peer2peer(p2p_enabled); // restore p2p state
+      profile.TPSTOP(QUDA_PROFILE_TOTAL);
+    }
+  };
+
   // whether we have initialized the dslash policy tuner
   extern bool dslash_policy_init;
 
@@ -1663,6 +1733,7 @@ namespace quda
     QUDA_SHMEM_UBER_PACKFULL_DSLASH,
     QUDA_SHMEM_PACKINTRA_DSLASH,
     QUDA_SHMEM_PACKFULL_DSLASH,
+    QUDA_NEIGHBOR_COLLECTIVE_DSLASH,
     QUDA_DSLASH_POLICY_DISABLED // this MUST be the last element
   };
 
@@ -1726,6 +1797,7 @@ namespace quda
       case QudaDslashPolicy::QUDA_SHMEM_UBER_PACKFULL_DSLASH: return std::make_unique<DslashShmemUberPackFull<Dslash>>();
       case QudaDslashPolicy::QUDA_SHMEM_PACKINTRA_DSLASH: return std::make_unique<DslashShmemPackIntra<Dslash>>();
       case QudaDslashPolicy::QUDA_SHMEM_PACKFULL_DSLASH: return std::make_unique<DslashShmemPackFull<Dslash>>();
+      case QudaDslashPolicy::QUDA_NEIGHBOR_COLLECTIVE_DSLASH: return std::make_unique<DslashNeighborCollective<Dslash>>();
       default: errorQuda("Dslash policy %d not recognized", static_cast<int>(policy));
       }
 
@@ -1814,6 +1886,10 @@ namespace quda
 #endif
             }
 
+            if (dslash_policy == QudaDslashPolicy::QUDA_NEIGHBOR_COLLECTIVE_DSLASH && !comm_neighbor_exchange_enabled())
+              errorQuda("Cannot select neighborhood collective policy %d unless QUDA_ENABLE_NEIGHBOR_COLLECTIVE is set",
+                        static_cast<int>(dslash_policy));
+
             enable_policy(static_cast<QudaDslashPolicy>(policy_));
             first_active_policy = policy_ < first_active_policy ? policy_ : first_active_policy;
             if (policy_list.peek() == ',') policy_list.ignore();
@@ -1853,6 +1929,9 @@ namespace quda
             enable_policy(QudaDslashPolicy::QUDA_SHMEM_PACKINTRA_DSLASH);
             enable_policy(QudaDslashPolicy::QUDA_SHMEM_PACKFULL_DSLASH);
           }
+
+          // if we have neighborhood collectives then compare these against point-to-point exchange
+          if (comm_neighbor_exchange_enabled()) enable_policy(QudaDslashPolicy::QUDA_NEIGHBOR_COLLECTIVE_DSLASH);
         }
         // construct string specifying which policies have been enabled
         for (int i = 0; i < (int)QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED; i++) {
@@ -1917,7 +1996,8 @@ namespace quda
                 i == QudaDslashPolicy::QUDA_SHMEM_UBER_PACKINTRA_DSLASH ||
                 i == QudaDslashPolicy::QUDA_SHMEM_UBER_PACKFULL_DSLASH ||
                 i == QudaDslashPolicy::QUDA_SHMEM_PACKINTRA_DSLASH ||
-                i == QudaDslashPolicy::QUDA_SHMEM_PACKFULL_DSLASH) {
+                i == QudaDslashPolicy::QUDA_SHMEM_PACKFULL_DSLASH ||
+                i == QudaDslashPolicy::QUDA_NEIGHBOR_COLLECTIVE_DSLASH) {
 
               auto dslashImp = DslashFactory<Dslash>::create(i);
               (*dslashImp)(dslash, &(this->in), volume, ghostFace, profile);
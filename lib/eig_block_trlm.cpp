@@ -64,13 +64,13 @@ namespace quda
 
     // Pre-launch checks and preparation
     //---------------------------------------------------------------------------
-    if (getVerbosity() >= QUDA_VERBOSE) queryPrec(kSpace[0]->Precision());
     // Check to see if we are loading eigenvectors
     if (strcmp(eig_param->vec_infile, "") != 0) {
       printfQuda("Loading evecs from file name %s\n", eig_param->vec_infile);
       loadFromFile(mat, kSpace, evals);
       return;
     }
+    if (getVerbosity() >= QUDA_VERBOSE) queryPrec(kSpace[0]->Precision());
 
     // Check for an initial guess. If none present, populate with rands, then
     // orthonormalise
@@ -84,6 +84,13 @@ namespace quda
     // original size before exit.
     prepareKrylovSpace(kSpace, evals);
 
+    // Resume from a checkpoint if present: the kept Ritz vectors and
+    // residual block, the Ritz values, the block arrow matrix and the
+    // matrix norm estimate
+    int arrow_mat_array_size = block_data_length * (n_kr / block_size);
+    std::vector<double> state;
+    bool resumed = loadCheckpoint(kSpace, state, n_kr + 4 * arrow_mat_array_size + 1);
+
     // Check for Chebyshev maximum estimation
     checkChebyOpMax(mat, kSpace);
 
@@ -91,6 +98,16 @@ namespace quda
     double mat_norm = 0.0;
     double epsilon = setEpsilon(kSpace[0]->Precision());
 
+    if (resumed) {
+      auto it = state.begin();
+      std::copy(it, it + n_kr, alpha);
+      it += n_kr;
+      std::copy(it, it + 2 * arrow_mat_array_size, reinterpret_cast<double *>(block_alpha));
+      it += 2 * arrow_mat_array_size;
+      std::copy(it, it + 2 * arrow_mat_array_size, reinterpret_cast<double *>(block_beta));
+      mat_norm = state.back();
+    }
+
     // Print Eigensolver params
     printEigensolverSetup();
     //---------------------------------------------------------------------------
@@ -178,6 +195,19 @@ namespace quda
       // Check for convergence
       if (num_converged >= n_conv) converged = true;
       restart_iter++;
+
+      if (!converged && !checkpointPrefix().empty()) {
+        profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+        std::vector<ColorSpinorField *> vecs(kSpace.begin(), kSpace.begin() + num_keep + block_size);
+        state.assign(alpha, alpha + n_kr);
+        state.insert(state.end(), reinterpret_cast<double *>(block_alpha),
+                     reinterpret_cast<double *>(block_alpha + arrow_mat_array_size));
+        state.insert(state.end(), reinterpret_cast<double *>(block_beta),
+                     reinterpret_cast<double *>(block_beta + arrow_mat_array_size));
+        state.push_back(mat_norm);
+        saveCheckpoint(vecs, state);
+        profile.TPSTART(QUDA_PROFILE_COMPUTE);
+      }
     }
 
     profile.TPSTOP(QUDA_PROFILE_COMPUTE);
@@ -440,13 +440,13 @@ namespace quda
 
     // Pre-launch checks and preparation
     //---------------------------------------------------------------------------
-    if (getVerbosity() >= QUDA_SUMMARIZE) queryPrec(kSpace[0]->Precision());
     // Check to see if we are loading eigenvectors
     if (strcmp(eig_param->vec_infile, "") != 0) {
       printfQuda("Loading evecs from file name %s\n", eig_param->vec_infile);
       loadFromFile(mat, kSpace, evals);
       return;
     }
+    if (getVerbosity() >= QUDA_SUMMARIZE) queryPrec(kSpace[0]->Precision());
 
     // Check for an initial guess. If none present, populate with rands, then
     // orthonormalise
@@ -473,8 +473,19 @@ namespace quda
     //---------------------------------------------------------------------------
     profile.TPSTART(QUDA_PROFILE_COMPUTE);
 
-    // Loop over restart iterations.
+    // Resume from a checkpoint if present: the residual vector, the
+    // compressed Krylov space and the upper Hessenberg matrix
     num_keep = 0;
+    std::vector<ColorSpinorField *> vecs {r[0]};
+    vecs.insert(vecs.end(), kSpace.begin(), kSpace.begin() + n_kr);
+    std::vector<double> state;
+    if (loadCheckpoint(vecs, state, 2 * n_kr * n_kr)) {
+      for (int i = 0; i < n_kr; i++)
+        std::copy(state.begin() + 2 * n_kr * i, state.begin() + 2 * n_kr * (i + 1),
+                  reinterpret_cast<double *>(upperHess[i]));
+    }
+
+    // Loop over restart iterations.
     while (restart_iter < max_restarts && !converged) {
       for (int step = num_keep; step < n_kr; step++) arnoldiStep(kSpace, r, beta, step);
       iter += n_kr - num_keep;
@@ -556,6 +567,18 @@ namespace quda
         if (sqrt(blas::norm2(*r[0])) < epsilon) { errorQuda("IRAM has encountered an invariant subspace..."); }
       }
       restart_iter++;
+
+      if (!converged && !checkpointPrefix().empty()) {
+        profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+        vecs.assign(1, r[0]);
+        vecs.insert(vecs.end(), kSpace.begin(), kSpace.begin() + num_keep);
+        state.clear();
+        for (int i = 0; i < n_kr; i++)
+          state.insert(state.end(), reinterpret_cast<double *>(upperHess[i]),
+                       reinterpret_cast<double *>(upperHess[i] + n_kr));
+        saveCheckpoint(vecs, state);
+        profile.TPSTART(QUDA_PROFILE_COMPUTE);
+      }
     }
 
     profile.TPSTOP(QUDA_PROFILE_COMPUTE);
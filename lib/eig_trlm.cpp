@@ -51,13 +51,13 @@ namespace quda
 
     // Pre-launch checks and preparation
     //---------------------------------------------------------------------------
-    if (getVerbosity() >= QUDA_VERBOSE) queryPrec(kSpace[0]->Precision());
     // Check to see if we are loading eigenvectors
     if (strcmp(eig_param->vec_infile, "") != 0) {
       printfQuda("Loading evecs from file name %s\n", eig_param->vec_infile);
       loadFromFile(mat, kSpace, evals);
       return;
     }
+    if (getVerbosity() >= QUDA_VERBOSE) queryPrec(kSpace[0]->Precision());
 
     // Check for an initial guess. If none present, populate with rands, then
     // orthonormalise
@@ -67,6 +67,11 @@ namespace quda
     // original size before exit.
     prepareKrylovSpace(kSpace, evals);
 
+    // Resume from a checkpoint if present: the kept Ritz vectors and
+    // residual, the arrow matrix and the matrix norm estimate
+    std::vector<double> state;
+    bool resumed = loadCheckpoint(kSpace, state, 2 * n_kr + 1);
+
     // Check for Chebyshev maximum estimation
     checkChebyOpMax(mat, kSpace);
 
@@ -74,6 +79,12 @@ namespace quda
     double mat_norm = 0.0;
     double epsilon = setEpsilon(kSpace[0]->Precision());
 
+    if (resumed) {
+      std::copy(state.begin(), state.begin() + n_kr, alpha);
+      std::copy(state.begin() + n_kr, state.begin() + 2 * n_kr, beta);
+      mat_norm = state[2 * n_kr];
+    }
+
     // Print Eigensolver params
     printEigensolverSetup();
     //---------------------------------------------------------------------------
@@ -157,6 +168,16 @@ namespace quda
       }
 
       restart_iter++;
+
+      if (!converged && !checkpointPrefix().empty()) {
+        profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+        std::vector<ColorSpinorField *> vecs(kSpace.begin(), kSpace.begin() + num_keep + 1);
+        state.assign(alpha, alpha + n_kr);
+        state.insert(state.end(), beta, beta + n_kr);
+        state.push_back(mat_norm);
+        saveCheckpoint(vecs, state);
+        profile.TPSTART(QUDA_PROFILE_COMPUTE);
+      }
     }
 
     profile.TPSTOP(QUDA_PROFILE_COMPUTE);
@@ -5,6 +5,7 @@
 #include <vector>
 #include <algorithm>
 #include <cfloat>
+#include <typeinfo>
 
 #include <quda_internal.h>
 #include <eigensolve_quda.h>
@@ -15,6 +16,7 @@
 #include <util_quda.h>
 #include <tune_quda.h>
 #include <vector_io.h>
+#include <field_io.h>
 #include <eigen_helper.h>
 
 namespace quda
@@ -56,6 +58,7 @@ namespace quda
     num_converged = 0;
     num_locked = 0;
     num_keep = 0;
+    a_max = eig_param->a_max;
 
     save_prec = eig_param->save_prec;
 
@@ -170,10 +173,11 @@ namespace quda
 
   void EigenSolver::checkChebyOpMax(const DiracMatrix &mat, std::vector<ColorSpinorField *> &kSpace)
   {
-    if (eig_param->use_poly_acc && eig_param->a_max <= 0.0) {
+    if (eig_param->use_poly_acc && a_max <= 0.0) {
       // Use part of the kSpace as temps
-      eig_param->a_max = estimateChebyOpMax(mat, *kSpace[block_size + 2], *kSpace[block_size + 1]);
-      if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Chebyshev maximum estimate: %e.\n", eig_param->a_max);
+      a_max = estimateChebyOpMax(mat, *kSpace[block_size + 2], *kSpace[block_size + 1]);
+      eig_param->a_max = a_max;
+      if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Chebyshev maximum estimate: %e.\n", a_max);
     }
   }
 
@@ -208,7 +212,7 @@ namespace quda
       if (eig_param->use_poly_acc) {
         printfQuda("polyDeg %d\n", eig_param->poly_deg);
         printfQuda("a-min %f\n", eig_param->a_min);
-        printfQuda("a-max %f\n", eig_param->a_max);
+        printfQuda("a-max %f\n", a_max);
       }
     }
   }
@@ -281,6 +285,8 @@ namespace quda
       for (unsigned int i = 0; i < kSpace.size() && save_prec < prec; i++) delete vecs_ptr[i];
     }
 
+    if (converged) removeCheckpoint();
+
     // Save TRLM tuning
     saveTuneCache();
 
@@ -293,6 +299,245 @@ namespace quda
     }
   }
 
+  namespace
+  {
+    /**
+       @brief Fixed-size record at the start of a checkpoint state
+       file, followed by the solver specific data
+    */
+    struct CheckpointState {
+      char magic[8];
+      int version;
+      int eig_type;
+      int n_ev;
+      int n_kr;
+      int n_conv;
+      int block_size;
+      int spectrum;
+      int use_poly_acc;
+      int poly_deg;
+      double tol;
+      double a_min;
+      double a_max;
+      int restart_iter;
+      int iter;
+      int num_converged;
+      int num_keep;
+      int num_locked;
+      int n_vec;
+      uint64_t n_data;
+      uint64_t op_key;
+    };
+
+    constexpr char checkpoint_magic[8] = "QUDAEIG";
+    constexpr int checkpoint_version = 2;
+
+    /**
+       @brief Key identifying the operator a checkpoint was computed
+       with: the checksum of its gauge field, its mass parameters and
+       the operator type.  Identical on all ranks.
+    */
+    uint64_t operator_key(const DiracMatrix &mat)
+    {
+      const Dirac &dirac = *mat.Expose();
+      uint64_t key = dirac.getGaugeField() ? Checksum(*dirac.getGaugeField()) : 0;
+
+      // FNV-1a hash of the operator parameters
+      auto hash = [&key](const void *data, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) {
+          key ^= static_cast<const unsigned char *>(data)[i];
+          key *= 0x100000001b3ull;
+        }
+      };
+
+      QudaDiracType type = dirac.getDiracType();
+      QudaMatPCType matpc = dirac.getMatPCType();
+      double kappa = dirac.Kappa();
+      double mass = dirac.Mass();
+      double mu = dirac.Mu();
+      std::string op = typeid(mat).name(); // M, MdagM, ...
+      hash(&type, sizeof(type));
+      hash(&matpc, sizeof(matpc));
+      hash(&kappa, sizeof(kappa));
+      hash(&mass, sizeof(mass));
+      hash(&mu, sizeof(mu));
+      hash(op.data(), op.size());
+      return key;
+    }
+
+    int checkpoint_interval()
+    {
+      static bool init = false;
+      static int interval = 10;
+      if (!init) {
+        char *interval_env = getenv("QUDA_EIG_CHECKPOINT_INTERVAL");
+        if (interval_env) {
+          interval = atoi(interval_env);
+          if (interval <= 0) errorQuda("Invalid QUDA_EIG_CHECKPOINT_INTERVAL=%s", interval_env);
+        }
+        init = true;
+      }
+      return interval;
+    }
+
+    std::string checkpoint_file(int slot, const char *name)
+    {
+      return EigenSolver::checkpointPrefix() + "_" + std::to_string(slot) + "_" + name;
+    }
+  } // namespace
+
+  const std::string &EigenSolver::checkpointPrefix()
+  {
+    static bool init = false;
+    static std::string prefix;
+    if (!init) {
+      char *prefix_env = getenv("QUDA_EIG_CHECKPOINT");
+      if (prefix_env) prefix = prefix_env;
+      init = true;
+    }
+    return prefix;
+  }
+
+  void EigenSolver::saveCheckpoint(const std::vector<ColorSpinorField *> &vecs, const std::vector<double> &data)
+  {
+    if (checkpointPrefix().empty() || restart_iter % checkpoint_interval() != 0 || restart_iter >= max_restarts) return;
+
+    profile.TPSTART(QUDA_PROFILE_IO);
+    // alternate between two slots, invalidating the one being overwritten first
+    int slot = (restart_iter / checkpoint_interval()) % 2;
+    if (comm_rank() == 0) remove(checkpoint_file(slot, "state").c_str());
+
+    VectorIO io(checkpoint_file(slot, "vecs"), false, true);
+    io.save(vecs);
+    native_io::wait();
+
+    uint64_t op_key = operator_key(mat);
+    if (comm_rank() == 0) {
+      CheckpointState state = {};
+      memcpy(state.magic, checkpoint_magic, sizeof(state.magic));
+      state.version = checkpoint_version;
+      state.eig_type = eig_param->eig_type;
+      state.n_ev = n_ev;
+      state.n_kr = n_kr;
+      state.n_conv = n_conv;
+      state.block_size = block_size;
+      state.spectrum = eig_param->spectrum;
+      state.use_poly_acc = eig_param->use_poly_acc;
+      state.poly_deg = eig_param->poly_deg;
+      state.tol = tol;
+      state.a_min = eig_param->a_min;
+      state.a_max = a_max;
+      state.restart_iter = restart_iter;
+      state.iter = iter;
+      state.num_converged = num_converged;
+      state.num_keep = num_keep;
+      state.num_locked = num_locked;
+      state.n_vec = vecs.size();
+      state.n_data = data.size();
+      state.op_key = op_key;
+
+      // write to a temporary file and rename, so the state only appears once complete
+      std::string filename = checkpoint_file(slot, "state");
+      std::string tmp_filename = filename + ".tmp";
+      FILE *fp = fopen(tmp_filename.c_str(), "wb");
+      if (!fp) errorQuda("Unable to open checkpoint file %s", tmp_filename.c_str());
+      if (fwrite(&state, sizeof(state), 1, fp) != 1 || fwrite(data.data(), sizeof(double), data.size(), fp) != data.size())
+        errorQuda("Unable to write checkpoint file %s", tmp_filename.c_str());
+      fclose(fp);
+      if (rename(tmp_filename.c_str(), filename.c_str()) != 0)
+        errorQuda("Unable to rename %s to %s", tmp_filename.c_str(), filename.c_str());
+    }
+    comm_barrier();
+    profile.TPSTOP(QUDA_PROFILE_IO);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Checkpointed eigensolver at restart %d to %s\n", restart_iter,
+                 checkpoint_file(slot, "state").c_str());
+  }
+
+  bool EigenSolver::loadCheckpoint(std::vector<ColorSpinorField *> &vecs, std::vector<double> &data, size_t data_length)
+  {
+    if (checkpointPrefix().empty()) return false;
+
+    // rank 0 picks the most recent valid slot, which is then broadcast with its data
+    uint64_t op_key = operator_key(mat);
+    CheckpointState state = {};
+    int slot = -1;
+    if (comm_rank() == 0) {
+      for (int s = 0; s < 2; s++) {
+        FILE *fp = fopen(checkpoint_file(s, "state").c_str(), "rb");
+        if (!fp) continue;
+        CheckpointState candidate;
+        bool valid = fread(&candidate, sizeof(candidate), 1, fp) == 1;
+        fclose(fp);
+        if (!valid || memcmp(candidate.magic, checkpoint_magic, sizeof(candidate.magic)) != 0
+            || candidate.version != checkpoint_version)
+          continue;
+        if (candidate.eig_type != eig_param->eig_type || candidate.n_ev != n_ev || candidate.n_kr != n_kr
+            || candidate.n_conv != n_conv || candidate.block_size != block_size
+            || candidate.spectrum != eig_param->spectrum || candidate.use_poly_acc != eig_param->use_poly_acc
+            || candidate.poly_deg != eig_param->poly_deg || candidate.tol != tol
+            || candidate.a_min != eig_param->a_min || candidate.n_data != data_length) {
+          warningQuda("Ignoring checkpoint %s with mismatched parameters", checkpoint_file(s, "state").c_str());
+          continue;
+        }
+        if (candidate.op_key != op_key) {
+          warningQuda("Ignoring checkpoint %s of a different operator or gauge field", checkpoint_file(s, "state").c_str());
+          continue;
+        }
+        if (slot < 0 || candidate.restart_iter > state.restart_iter) {
+          state = candidate;
+          slot = s;
+        }
+      }
+    }
+    comm_broadcast(&slot, sizeof(slot));
+    if (slot < 0) return false;
+    comm_broadcast(&state, sizeof(state));
+    if (state.n_vec > static_cast<int>(vecs.size()))
+      errorQuda("Checkpoint holds %d vectors, at most %lu expected", state.n_vec, vecs.size());
+
+    data.resize(data_length);
+    if (comm_rank() == 0) {
+      FILE *fp = fopen(checkpoint_file(slot, "state").c_str(), "rb");
+      if (!fp || fseek(fp, sizeof(state), SEEK_SET) != 0 || fread(data.data(), sizeof(double), data_length, fp) != data_length)
+        errorQuda("Unable to read checkpoint file %s", checkpoint_file(slot, "state").c_str());
+      fclose(fp);
+    }
+    comm_broadcast(data.data(), data_length * sizeof(double));
+
+    profile.TPSTART(QUDA_PROFILE_IO);
+    std::vector<ColorSpinorField *> vecs_load(vecs.begin(), vecs.begin() + state.n_vec);
+    VectorIO io(checkpoint_file(slot, "vecs"));
+    io.load(vecs_load);
+    profile.TPSTOP(QUDA_PROFILE_IO);
+
+    restart_iter = state.restart_iter;
+    iter = state.iter;
+    num_converged = state.num_converged;
+    num_keep = state.num_keep;
+    num_locked = state.num_locked;
+    a_max = state.a_max;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Resuming eigensolver from %s at restart %d with %d converged eigenvalues\n",
+                 checkpoint_file(slot, "state").c_str(), restart_iter, num_converged);
+    return true;
+  }
+
+  void EigenSolver::removeCheckpoint()
+  {
+    if (checkpointPrefix().empty()) return;
+    native_io::wait();
+    if (comm_rank() == 0) {
+      for (int s = 0; s < 2; s++) {
+        remove(checkpoint_file(s, "state").c_str());
+        remove(checkpoint_file(s, "vecs").c_str());
+      }
+    }
+    comm_barrier();
+  }
+
   void EigenSolver::matVec(const DiracMatrix &mat, ColorSpinorField &out, const ColorSpinorField &in)
   {
     if (!tmp1 || !tmp2) {
@@ -318,7 +563,7 @@ namespace quda
 
     // Compute the polynomial accelerated operator.
     double a = eig_param->a_min;
-    double b = eig_param->a_max;
+    double b = a_max;
     double delta = (b - a) / 2.0;
     double theta = (b + a) / 2.0;
     double sigma1 = -delta / theta;
@@ -708,29 +953,40 @@ namespace quda
   void EigenSolver::computeEvals(const DiracMatrix &mat, std::vector<ColorSpinorField *> &evecs,
                                  std::vector<Complex> &evals, int size)
   {
-    if (size > (int)evecs.size())
-      errorQuda("Requesting %d eigenvectors with only storage allocated for %lu", size, evecs.size());
+    bool stream = evecs.empty() && evec_store;
+    int n_evecs = stream ? evec_store->size() : evecs.size();
+    if (size > n_evecs) errorQuda("Requesting %d eigenvectors with only storage allocated for %d", size, n_evecs);
     if (size > (int)evals.size())
       errorQuda("Requesting %d eigenvalues with only storage allocated for %lu", size, evals.size());
 
-    ColorSpinorParam csParamClone(*evecs[0]);
+    ColorSpinorParam csParamClone(stream ? evec_store->Param() : ColorSpinorParam(*evecs[0]));
+    csParamClone.create = QUDA_NULL_FIELD_CREATE;
     std::vector<ColorSpinorField *> temp;
     temp.push_back(new ColorSpinorField(csParamClone));
 
-    for (int i = 0; i < size; i++) {
-      // r = A * v_i
-      matVec(mat, *temp[0], *evecs[i]);
-
-      // lambda_i = v_i^dag A v_i / (v_i^dag * v_i)
-      evals[i] = blas::cDotProduct(*evecs[i], *temp[0]) / sqrt(blas::norm2(*evecs[i]));
-      // Measure ||lambda_i*v_i - A*v_i||
-      Complex n_unit(-1.0, 0.0);
-      blas::caxpby(evals[i], *evecs[i], n_unit, *temp[0]);
-      residua[i] = sqrt(blas::norm2(*temp[0]));
-
-      // If size = n_conv, this routine is called post sort
-      if (getVerbosity() >= QUDA_SUMMARIZE && size == n_conv)
-        printfQuda("Eval[%04d] = (%+.16e,%+.16e) residual = %+.16e\n", i, evals[i].real(), evals[i].imag(), residua[i]);
+    for (int begin = 0; begin < size;) {
+      int end = stream ? std::min(size, evec_store->block_end(begin)) : size;
+      auto block = stream ? evec_store->block(begin, end) : evecs;
+
+      for (int i = begin; i < end; i++) {
+        ColorSpinorField &evec = *block[i - (stream ? begin : 0)];
+
+        // r = A * v_i
+        matVec(mat, *temp[0], evec);
+
+        // lambda_i = v_i^dag A v_i / (v_i^dag * v_i)
+        evals[i] = blas::cDotProduct(evec, *temp[0]) / sqrt(blas::norm2(evec));
+        // Measure ||lambda_i*v_i - A*v_i||
+        Complex n_unit(-1.0, 0.0);
+        blas::caxpby(evals[i], evec, n_unit, *temp[0]);
+        residua[i] = sqrt(blas::norm2(*temp[0]));
+
+        // If size = n_conv, this routine is called post sort
+        if (getVerbosity() >= QUDA_SUMMARIZE && size == n_conv)
+          printfQuda("Eval[%04d] = (%+.16e,%+.16e) residual = %+.16e\n", i, evals[i].real(), evals[i].imag(),
+                     residua[i]);
+      }
+      begin = end;
     }
     delete temp[0];
 
@@ -756,6 +1012,34 @@ namespace quda
     // Perform Sum_i V_i * (L_i)^{-1} * (V_i)^dag * vec = vec_defl
     // for all i computed eigenvectors and values.
 
+    if (evecs.empty() && evec_store) {
+      // Stream the eigenvectors from the store in blocks: the
+      // deflation is linear in the eigenvectors so blocks are
+      // accumulated independently
+      if (n_defl > evec_store->size())
+        errorQuda("Requesting %d eigenvectors with only %d in the store", n_defl, evec_store->size());
+      for (int begin = 0; begin < n_defl;) {
+        int end = std::min(n_defl, evec_store->block_end(begin));
+        auto eig_vecs = evec_store->block(begin, end);
+
+        std::vector<Complex> s((end - begin) * src.size());
+        std::vector<ColorSpinorField *> src_ = const_cast<decltype(src) &>(src);
+        blas::cDotProduct(s.data(), eig_vecs, src_);
+
+        for (int i = begin; i < end; i++)
+          for (auto j = 0u; j < src.size(); j++) s[(i - begin) * src.size() + j] /= evals[i].real();
+
+        if (!accumulate && begin == 0)
+          for (auto &x : sol) blas::zero(*x);
+        blas::caxpy(s.data(), eig_vecs, sol);
+        begin = end;
+      }
+
+      // Save Deflation tuning
+      saveTuneCache();
+      return;
+    }
+
     // Pointers to the required Krylov space vectors,
     // no extra memory is allocated.
     std::vector<ColorSpinorField *> eig_vecs;
@@ -782,6 +1066,12 @@ namespace quda
   void EigenSolver::loadFromFile(const DiracMatrix &mat, std::vector<ColorSpinorField *> &kSpace,
                                  std::vector<Complex> &evals)
   {
+    if (kSpace.empty() && evec_store) {
+      // the eigenvectors are streamed from file on demand
+      computeEvals(mat, kSpace, evals);
+      return;
+    }
+
     // Set suggested parity of fields
     const QudaParity mat_parity = impliedParityFromMatPC(mat.getMatPCType());
     for (int i = 0; i < n_conv; i++) { kSpace[i]->setSuggestedParity(mat_parity); }
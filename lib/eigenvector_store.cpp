@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <eigenvector_store.h>
+
+namespace quda
+{
+
+  size_t EigenvectorStore::cache_bytes()
+  {
+    static bool init = false;
+    static size_t bytes = 0;
+
+    if (!init) {
+      char *cache_env = getenv("QUDA_DEFLATION_CACHE_SIZE");
+      if (cache_env) {
+        long cache = atol(cache_env);
+        if (cache < 0) errorQuda("Invalid QUDA_DEFLATION_CACHE_SIZE=%s", cache_env);
+        bytes = static_cast<size_t>(cache) * 1024 * 1024;
+      }
+      init = true;
+    }
+    return bytes;
+  }
+
+  EigenvectorStore::EigenvectorStore(const std::string &filename, const ColorSpinorParam &param_, int n_vec) :
+    file(filename), param(param_), n_vec(n_vec)
+  {
+    if (param.nDim != 4 && param.nDim != 5) errorQuda("Unexpected field dimension %d", param.nDim);
+    int Ls = param.nDim == 5 ? param.x[4] : 1;
+    if (file.Nfield() < n_vec * Ls)
+      errorQuda("%s contains %d fields, at least %d required", filename.c_str(), file.Nfield(), n_vec * Ls);
+
+    param.create = QUDA_NULL_FIELD_CREATE;
+    size_t field_bytes = static_cast<size_t>(param.nSpin) * param.nColor * 2 * param.Precision();
+    for (int d = 0; d < param.nDim; d++) field_bytes *= param.x[d];
+
+    int capacity = std::max(static_cast<size_t>(1), std::min(static_cast<size_t>(n_vec), cache_bytes() / field_bytes));
+    if (capacity == n_vec) {
+      n_resident = n_vec;
+      n_stream = 0;
+    } else {
+      // keep the lowest modes resident, and stream the rest through an eighth of the cache
+      n_stream = std::max(1, capacity / 8);
+      n_resident = capacity - n_stream;
+    }
+
+    slot.resize(capacity, nullptr);
+    slot_vec.resize(capacity, -1);
+    slot_use.resize(capacity, 0);
+    vec_slot.resize(n_vec, -1);
+
+    ColorSpinorParam host_param(param);
+    host_param.location = QUDA_CPU_FIELD_LOCATION;
+    host_param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    host_param.setPrecision(file.Precision());
+    host = ColorSpinorField::Create(host_param);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Streaming %d eigenvectors from %s: %d resident, %d streamed through %d slots\n", n_vec,
+                 filename.c_str(), n_resident, n_vec - n_resident, n_stream);
+  }
+
+  EigenvectorStore::~EigenvectorStore()
+  {
+    if (getVerbosity() >= QUDA_SUMMARIZE && hits + misses > 0)
+      printfQuda("Eigenvector store: %lu hits, %lu misses (%.1f%% hit rate)\n", hits, misses,
+                 100.0 * hits / (hits + misses));
+    for (auto &s : slot)
+      if (s) delete s;
+    delete host;
+  }
+
+  void EigenvectorStore::load(int i, int s)
+  {
+    if (slot_vec[s] >= 0) vec_slot[slot_vec[s]] = -1;
+    if (!slot[s]) slot[s] = ColorSpinorField::Create(param);
+
+    // 5-d fields are stored as Ls consecutive 4-d fields
+    int Ls = host->Ndim() == 5 ? host->X(4) : 1;
+    size_t stride = host->Volume() / Ls * host->Ncolor() * host->Nspin() * 2 * host->Precision();
+    for (int j = 0; j < Ls; j++)
+      file.read(i * Ls + j, static_cast<char *>(host->V()) + j * stride, host->Precision(), host->X(),
+                host->SiteSubset(), 2 * host->Nspin() * host->Ncolor());
+
+    *slot[s] = *host;
+    slot_vec[s] = i;
+    vec_slot[i] = s;
+  }
+
+  std::vector<ColorSpinorField *> EigenvectorStore::block(int begin, int end)
+  {
+    if (begin < 0 || end > n_vec || begin >= end) errorQuda("Invalid block [%d, %d) of %d vectors", begin, end, n_vec);
+    if (end > block_end(begin)) errorQuda("Block [%d, %d) exceeds the cache capacity", begin, end);
+
+    clock++;
+    std::vector<ColorSpinorField *> fields;
+    fields.reserve(end - begin);
+
+    for (int i = begin; i < end; i++) {
+      int s = vec_slot[i];
+      if (s >= 0) {
+        hits++;
+      } else {
+        misses++;
+        if (i < n_resident) {
+          s = i;
+        } else {
+          // evict the least recently used streaming slot that is not part of this block
+          for (int t = n_resident; t < n_resident + n_stream; t++)
+            if (slot_use[t] != clock && (s < 0 || slot_use[t] < slot_use[s])) s = t;
+        }
+        load(i, s);
+      }
+      slot_use[s] = clock;
+      fields.push_back(slot[s]);
+    }
+
+    return fields;
+  }
+
+} // namespace quda
@@ -0,0 +1,1227 @@
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <functional>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <timer.h>
+#include <field_io.h>
+
+#if defined(QMP_COMMS) || defined(MPI_COMMS)
+#include <mpi.h>
+#define NATIVE_IO_MPI
+#endif
+
+namespace quda
+{
+
+  namespace native_io
+  {
+
+    constexpr char magic[8] = {'Q', 'U', 'D', 'A', 'F', 'L', 'D', '\0'};
+    constexpr int32_t version = 2; // version 2 adds compressed encodings
+    constexpr int32_t endian_check = 0x01020304;
+    constexpr size_t header_bytes = 256;
+    constexpr int n_dim = 4;
+
+    /**
+       The file header, which is zero padded to header_bytes in the file
+     */
+    struct Header {
+      char magic[8];
+      int32_t version;
+      int32_t endian;    // written as endian_check to detect byte-order mismatch
+      int32_t precision; // bytes per real number
+      int32_t ndim;
+      int32_t dims[n_dim]; // global lattice dimensions
+      int32_t subset;
+      int32_t parity;
+      int32_t n_color;
+      int32_t n_spin;
+      int32_t site_len; // real numbers per site
+      int32_t n_field;
+      int32_t encoding; // Encoding of each site record
+      int32_t n_basis;  // number of basis fields of a low-rank file, zero otherwise
+      double error;     // maximum relative reconstruction error measured on saving
+    };
+    static_assert(sizeof(Header) <= header_bytes, "Header exceeds the reserved header size");
+
+    /**
+       Encoding of the site records in the file
+       - RAW: the site's real numbers at the file precision
+       - BLOCK_FLOAT_16 / BLOCK_FLOAT_8: a float scale shared by the
+         site, followed by the real numbers quantized to 16-bit / 8-bit
+         integers relative to that scale, as in the short / int8
+         FloatNOrder formats
+     */
+    enum Encoding { RAW = 0, BLOCK_FLOAT_16 = 1, BLOCK_FLOAT_8 = 2 };
+
+    static const char *encoding_str(int encoding)
+    {
+      switch (encoding) {
+      case RAW: return "raw";
+      case BLOCK_FLOAT_16: return "blockfloat16";
+      case BLOCK_FLOAT_8: return "blockfloat8";
+      default: return "unknown";
+      }
+    }
+
+    /**
+       @brief Return the size in bytes of an encoded site record
+     */
+    static size_t record_bytes(int encoding, int site_len, QudaPrecision precision)
+    {
+      switch (encoding) {
+      case RAW: return site_len * precision;
+      case BLOCK_FLOAT_16: return sizeof(float) + site_len * sizeof(int16_t);
+      case BLOCK_FLOAT_8: return sizeof(float) + site_len * sizeof(int8_t);
+      default: errorQuda("Unknown encoding %d", encoding);
+      }
+      return 0;
+    }
+
+    /**
+       Describes the local sub-block of the global lattice that is
+       owned by this rank, and how its sites are ordered in memory.
+     */
+    struct Layout {
+      int X[n_dim];      // local dimensions
+      int G[n_dim];      // global dimensions
+      int offset[n_dim]; // global coordinates of the local origin
+      size_t local_volume;
+      size_t global_volume;
+      bool checkerboard; // whether the host field is even-odd ordered
+
+      Layout(const int *X_, QudaSiteSubset subset) :
+        local_volume(1), global_volume(1), checkerboard(subset == QUDA_FULL_SITE_SUBSET)
+      {
+        for (int d = 0; d < n_dim; d++) {
+          X[d] = X_[d];
+          G[d] = comm_dim(d) * X[d];
+          offset[d] = comm_coord(d) * X[d];
+          local_volume *= X[d];
+          global_volume *= G[d];
+        }
+      }
+
+      /**
+         @brief Return the offset in the host field of the first site of
+         a row of the local lexicographic lattice, and its parity
+       */
+      void row(size_t row, size_t &r, int &parity) const
+      {
+        r = row * X[0];
+        int x[n_dim] = {0, static_cast<int>(row % X[1]), static_cast<int>((row / X[1]) % X[2]),
+                        static_cast<int>(row / (X[1] * X[2]))};
+        parity = 0;
+        for (int d = 0; d < n_dim; d++) parity += x[d] + offset[d];
+        parity &= 1;
+      }
+
+      /**
+         @brief Return the host field index of the site with local
+         lexicographic index r and global parity
+       */
+      size_t index(size_t r, int parity) const
+      {
+        if (!checkerboard) return r;
+        return parity ? (r + local_volume) / 2 : r / 2;
+      }
+
+      size_t rows() const { return local_volume / X[0]; }
+
+      /**
+         @brief Return the global lexicographic index of the first site
+         of a row of the local lexicographic lattice
+       */
+      size_t global_row(size_t row) const
+      {
+        size_t index = offset[0];
+        size_t stride = G[0];
+        for (int d = 1; d < n_dim; d++) {
+          index += (row % X[d] + offset[d]) * stride;
+          row /= X[d];
+          stride *= G[d];
+        }
+        return index;
+      }
+    };
+
+    /**
+       @brief Copy a host field into a buffer in local lexicographic
+       order, converting the precision if needed
+     */
+    template <typename oFloat, typename iFloat>
+    static void pack(oFloat *buffer, const iFloat *field, const Layout &layout, int site_len)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (size_t row = 0; row < layout.rows(); row++) {
+        size_t r;
+        int parity;
+        layout.row(row, r, parity);
+        for (int x = 0; x < layout.X[0]; x++) {
+          const iFloat *src = field + layout.index(r + x, (parity + x) & 1) * site_len;
+          oFloat *dst = buffer + (r + x) * site_len;
+          for (int j = 0; j < site_len; j++) dst[j] = src[j];
+        }
+      }
+    }
+
+    /**
+       @brief Copy a buffer into a host field, converting the
+       precision if needed.  The buffer either holds the local sites
+       in local lexicographic order, or is the entire global field
+       (global = true), e.g., a mapped file.
+     */
+    template <typename oFloat, typename iFloat>
+    static void unpack(oFloat *field, const iFloat *buffer, const Layout &layout, int site_len, bool global)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (size_t row = 0; row < layout.rows(); row++) {
+        size_t r;
+        int parity;
+        layout.row(row, r, parity);
+        const iFloat *src_row = buffer + (global ? layout.global_row(row) : r) * site_len;
+        for (int x = 0; x < layout.X[0]; x++) {
+          const iFloat *src = src_row + x * site_len;
+          oFloat *dst = field + layout.index(r + x, (parity + x) & 1) * site_len;
+          for (int j = 0; j < site_len; j++) dst[j] = src[j];
+        }
+      }
+    }
+
+    static void pack(void *buffer, QudaPrecision buffer_prec, const void *field, QudaPrecision field_prec,
+                     const Layout &layout, int site_len)
+    {
+      if (buffer_prec == QUDA_DOUBLE_PRECISION && field_prec == QUDA_DOUBLE_PRECISION)
+        pack(static_cast<double *>(buffer), static_cast<const double *>(field), layout, site_len);
+      else if (buffer_prec == QUDA_DOUBLE_PRECISION && field_prec == QUDA_SINGLE_PRECISION)
+        pack(static_cast<double *>(buffer), static_cast<const float *>(field), layout, site_len);
+      else if (buffer_prec == QUDA_SINGLE_PRECISION && field_prec == QUDA_SINGLE_PRECISION)
+        pack(static_cast<float *>(buffer), static_cast<const float *>(field), layout, site_len);
+      else
+        errorQuda("Unsupported precision combination %d %d", buffer_prec, field_prec);
+    }
+
+    static void unpack(void *field, QudaPrecision field_prec, const void *buffer, QudaPrecision buffer_prec,
+                       const Layout &layout, int site_len, bool global = false)
+    {
+      if (field_prec == QUDA_DOUBLE_PRECISION && buffer_prec == QUDA_DOUBLE_PRECISION)
+        unpack(static_cast<double *>(field), static_cast<const double *>(buffer), layout, site_len, global);
+      else if (field_prec == QUDA_DOUBLE_PRECISION && buffer_prec == QUDA_SINGLE_PRECISION)
+        unpack(static_cast<double *>(field), static_cast<const float *>(buffer), layout, site_len, global);
+      else if (field_prec == QUDA_SINGLE_PRECISION && buffer_prec == QUDA_DOUBLE_PRECISION)
+        unpack(static_cast<float *>(field), static_cast<const double *>(buffer), layout, site_len, global);
+      else if (field_prec == QUDA_SINGLE_PRECISION && buffer_prec == QUDA_SINGLE_PRECISION)
+        unpack(static_cast<float *>(field), static_cast<const float *>(buffer), layout, site_len, global);
+      else
+        errorQuda("Unsupported precision combination %d %d", field_prec, buffer_prec);
+    }
+
+    /**
+       @brief Convert a buffer between precisions without reordering
+     */
+    static void convert(void *dst, QudaPrecision dst_prec, const void *src, QudaPrecision src_prec, size_t length)
+    {
+      auto copy = [length](auto *d, const auto *s) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t x = 0; x < length; x++) d[x] = s[x];
+      };
+      if (dst_prec == QUDA_DOUBLE_PRECISION && src_prec == QUDA_DOUBLE_PRECISION)
+        copy(static_cast<double *>(dst), static_cast<const double *>(src));
+      else if (dst_prec == QUDA_DOUBLE_PRECISION && src_prec == QUDA_SINGLE_PRECISION)
+        copy(static_cast<double *>(dst), static_cast<const float *>(src));
+      else if (dst_prec == QUDA_SINGLE_PRECISION && src_prec == QUDA_DOUBLE_PRECISION)
+        copy(static_cast<float *>(dst), static_cast<const double *>(src));
+      else if (dst_prec == QUDA_SINGLE_PRECISION && src_prec == QUDA_SINGLE_PRECISION)
+        copy(static_cast<float *>(dst), static_cast<const float *>(src));
+      else
+        errorQuda("Unsupported precision combination %d %d", dst_prec, src_prec);
+    }
+
+    /**
+       @brief Quantize the real numbers of a site relative to a shared
+       scale, the largest magnitude in the site
+     */
+    template <typename T> static void encode_site(char *record, const double *site, int site_len)
+    {
+      constexpr double q_max = std::numeric_limits<T>::max();
+      double max = 0.0;
+      for (int j = 0; j < site_len; j++) max = std::max(max, std::abs(site[j]));
+      float scale = static_cast<float>(max / q_max);
+      memcpy(record, &scale, sizeof(float));
+      T *q = reinterpret_cast<T *>(record + sizeof(float));
+      for (int j = 0; j < site_len; j++)
+        q[j] = scale > 0.0f ? static_cast<T>(std::max(-q_max, std::min(q_max, std::nearbyint(site[j] / scale)))) : 0;
+    }
+
+    template <typename T> static void decode_site(double *site, const char *record, int site_len)
+    {
+      float scale;
+      memcpy(&scale, record, sizeof(float));
+      const T *q = reinterpret_cast<const T *>(record + sizeof(float));
+      for (int j = 0; j < site_len; j++) site[j] = q[j] * static_cast<double>(scale);
+    }
+
+    /**
+       @brief Encode n_site sites of a double-precision buffer
+     */
+    static void encode(char *records, const double *data, size_t n_site, int site_len, int encoding)
+    {
+      size_t bytes = record_bytes(encoding, site_len, QUDA_DOUBLE_PRECISION);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (size_t i = 0; i < n_site; i++) {
+        if (encoding == BLOCK_FLOAT_16)
+          encode_site<int16_t>(records + i * bytes, data + i * site_len, site_len);
+        else
+          encode_site<int8_t>(records + i * bytes, data + i * site_len, site_len);
+      }
+    }
+
+    /**
+       @brief Decode n_site sites into a double-precision buffer
+     */
+    static void decode(double *data, const char *records, size_t n_site, int site_len, int encoding)
+    {
+      size_t bytes = record_bytes(encoding, site_len, QUDA_DOUBLE_PRECISION);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (size_t i = 0; i < n_site; i++) {
+        if (encoding == BLOCK_FLOAT_16)
+          decode_site<int16_t>(data + i * site_len, records + i * bytes, site_len);
+        else
+          decode_site<int8_t>(data + i * site_len, records + i * bytes, site_len);
+      }
+    }
+
+    /**
+       Compression applied to saved vector fields, set with
+       QUDA_IO_COMPRESS, a comma-separated list of an encoding
+       (none, blockfloat16 or blockfloat8) and optionally lowrank=tol.
+       With lowrank, the set of vectors is replaced by an orthonormal
+       basis computed with reorthogonalized Gram-Schmidt, dropping
+       directions whose residual norm relative to the vector is below
+       tol, together with the coefficients of the vectors in this
+       basis.  This pays off for sets such as MG near-null vectors that
+       are close to linearly dependent; eigenvectors are already
+       orthonormal, so their basis is the set itself.
+     */
+    struct Compression {
+      int encoding = RAW;
+      double lowrank_tol = 0.0;
+    };
+
+    static const Compression &compression()
+    {
+      static bool init = false;
+      static Compression c;
+
+      if (!init) {
+        char *compress_env = getenv("QUDA_IO_COMPRESS");
+        if (compress_env) {
+          std::string env(compress_env);
+          size_t begin = 0;
+          while (begin <= env.size()) {
+            size_t end = env.find(',', begin);
+            if (end == std::string::npos) end = env.size();
+            std::string token = env.substr(begin, end - begin);
+            if (token == "none") c.encoding = RAW;
+            else if (token == "blockfloat16") c.encoding = BLOCK_FLOAT_16;
+            else if (token == "blockfloat8") c.encoding = BLOCK_FLOAT_8;
+            else if (token.compare(0, 8, "lowrank=") == 0) c.lowrank_tol = atof(token.c_str() + 8);
+            else errorQuda("Unknown QUDA_IO_COMPRESS entry \"%s\"", token.c_str());
+            begin = end + 1;
+          }
+          if (c.lowrank_tol < 0.0 || c.lowrank_tol >= 1.0) errorQuda("Invalid QUDA_IO_COMPRESS lowrank tolerance %e", c.lowrank_tol);
+        }
+        init = true;
+      }
+      return c;
+    }
+
+    /**
+       @brief Compute an orthonormal basis of a set of vectors held as
+       local complex double buffers, using classical Gram-Schmidt with
+       one reorthogonalization (CGS2) so that each vector costs two
+       global reductions.
+       @param[out] basis The basis vectors
+       @param[out] coeff The coefficients coeff[i * n + j] of vector j in basis vector i
+       @param[in] vecs The vectors
+       @param[in] length Local length of each vector in real numbers
+       @param[in] tol Vectors whose relative residual norm is below tol do not extend the basis
+     */
+    static void gram_schmidt(std::vector<std::vector<double>> &basis, std::vector<double> &coeff,
+                             const std::vector<std::vector<double>> &vecs, size_t length, double tol)
+    {
+      const int n = vecs.size();
+      std::vector<std::vector<double>> coeffs(n); // coefficients of each vector, grows with the basis
+
+      for (int j = 0; j < n; j++) {
+        std::vector<double> w = vecs[j];
+        const int k = basis.size();
+        coeffs[j].assign(2 * (k + 1), 0.0);
+
+        for (int pass = 0; pass < 2; pass++) {
+          // r_i = <q_i, w> for all basis vectors, and the norm of w in the final entry
+          std::vector<double> r(2 * k + 1, 0.0);
+          for (int i = 0; i < k; i++) {
+            double re = 0.0, im = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : re, im)
+#endif
+            for (size_t x = 0; x < length; x += 2) {
+              re += basis[i][x] * w[x] + basis[i][x + 1] * w[x + 1];
+              im += basis[i][x] * w[x + 1] - basis[i][x + 1] * w[x];
+            }
+            r[2 * i] = re;
+            r[2 * i + 1] = im;
+          }
+          double norm2 = 0.0;
+          if (pass == 0) {
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : norm2)
+#endif
+            for (size_t x = 0; x < length; x++) norm2 += w[x] * w[x];
+          }
+          r[2 * k] = norm2;
+          comm_allreduce_array(r.data(), r.size());
+          if (pass == 0) coeffs[j][2 * k + 1] = r[2 * k]; // stash the squared norm of the input vector
+
+          for (int i = 0; i < k; i++) {
+            coeffs[j][2 * i] += r[2 * i];
+            coeffs[j][2 * i + 1] += r[2 * i + 1];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (size_t x = 0; x < length; x += 2) {
+              w[x] -= r[2 * i] * basis[i][x] - r[2 * i + 1] * basis[i][x + 1];
+              w[x + 1] -= r[2 * i] * basis[i][x + 1] + r[2 * i + 1] * basis[i][x];
+            }
+          }
+        }
+
+        double norm2 = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : norm2)
+#endif
+        for (size_t x = 0; x < length; x++) norm2 += w[x] * w[x];
+        comm_allreduce(&norm2);
+
+        double input_norm2 = coeffs[j][2 * k + 1];
+        coeffs[j][2 * k + 1] = 0.0;
+        if (norm2 > tol * tol * input_norm2 && norm2 > 0.0) {
+          double inv = 1.0 / sqrt(norm2);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+          for (size_t x = 0; x < length; x++) w[x] *= inv;
+          basis.push_back(std::move(w));
+          coeffs[j][2 * k] = sqrt(norm2);
+        } else {
+          coeffs[j].resize(2 * k);
+        }
+      }
+
+      const int k = basis.size();
+      coeff.assign(2 * k * n, 0.0);
+      for (int j = 0; j < n; j++)
+        for (size_t i = 0; i < coeffs[j].size() / 2; i++) {
+          coeff[2 * (i * n + j)] = coeffs[j][2 * i];
+          coeff[2 * (i * n + j) + 1] = coeffs[j][2 * i + 1];
+        }
+    }
+
+    /**
+       @brief Reconstruct vector j from a low-rank basis
+     */
+    static void reconstruct(std::vector<double> &v, const std::vector<std::vector<double>> &basis,
+                            const std::vector<double> &coeff, int n, int j, size_t length)
+    {
+      v.assign(length, 0.0);
+      for (size_t i = 0; i < basis.size(); i++) {
+        double re = coeff[2 * (i * n + j)], im = coeff[2 * (i * n + j) + 1];
+        if (re == 0.0 && im == 0.0) continue;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t x = 0; x < length; x += 2) {
+          v[x] += re * basis[i][x] - im * basis[i][x + 1];
+          v[x + 1] += re * basis[i][x + 1] + im * basis[i][x];
+        }
+      }
+    }
+
+    /**
+       Callback that fills (write) or consumes (read) the local buffer
+       of a given record field
+     */
+    using RecordFunction = std::function<void(int, char *)>;
+
+    /**
+       @brief Read or write the given number of bytes at a file
+       offset, retrying on partial transfers.  A failure is an error,
+       unless an error string is given, in which case it is recorded
+       there (as is needed off the main thread) and false is returned.
+     */
+    static bool transfer_bytes(int fd, bool write, char *data, size_t bytes, off_t offset, const std::string &filename,
+                               std::string *error = nullptr)
+    {
+      while (bytes > 0) {
+        ssize_t n = write ? pwrite(fd, data, bytes, offset) : pread(fd, data, bytes, offset);
+        if (n <= 0) {
+          char msg[512];
+          snprintf(msg, sizeof(msg), "Failed to %s %s at offset %lld: %s", write ? "write" : "read", filename.c_str(),
+                   static_cast<long long>(offset), n < 0 ? strerror(errno) : "no progress");
+          if (!error) errorQuda("%s", msg);
+          *error = msg;
+          return false;
+        }
+        data += n;
+        bytes -= n;
+        offset += n;
+      }
+      return true;
+    }
+
+    /**
+       @brief Create a file and write its header and trailer (e.g.,
+       low-rank coefficients) from rank 0.  Collective: returns once
+       the file exists.
+     */
+    static void create_file(const std::string &filename, const char *header, const std::vector<double> &trailer,
+                            size_t trailer_offset)
+    {
+      if (comm_rank() == 0) {
+        int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) errorQuda("Failed to create %s", filename.c_str());
+        transfer_bytes(fd, true, const_cast<char *>(header), header_bytes, 0, filename);
+        if (trailer.size() > 0)
+          transfer_bytes(fd, true, reinterpret_cast<char *>(const_cast<double *>(trailer.data())),
+                         trailer.size() * sizeof(double), trailer_offset, filename);
+        close(fd);
+      }
+      comm_barrier();
+    }
+
+    /**
+       @brief Read or write this rank's sub-block of a record field
+       with pread / pwrite.  The local sub-block is split into the
+       largest runs that are contiguous in the file.  Failures are
+       handled as for transfer_bytes.
+     */
+    static bool transfer_runs(int fd, bool write, char *buffer, size_t site_bytes, const Layout &layout,
+                              off_t field_offset, const std::string &filename, std::string *error = nullptr)
+    {
+      // runs extend over each dimension until the first one that is partitioned
+      size_t run = 1;
+      for (int d = 0; d < n_dim; d++) {
+        run *= layout.X[d];
+        if (layout.X[d] != layout.G[d]) break;
+      }
+      size_t n_run = layout.local_volume / run;
+
+      for (size_t j = 0; j < n_run; j++) {
+        // global lexicographic index of the first site of the run
+        size_t local = j * run;
+        size_t global = 0;
+        size_t stride = 1;
+        for (int d = 0; d < n_dim; d++) {
+          global += (local % layout.X[d] + layout.offset[d]) * stride;
+          local /= layout.X[d];
+          stride *= layout.G[d];
+        }
+        if (!transfer_bytes(fd, write, buffer + j * run * site_bytes, run * site_bytes,
+                            field_offset + global * site_bytes, filename, error))
+          return false;
+      }
+      return true;
+    }
+
+#ifdef NATIVE_IO_MPI
+    static void check_mpi(int status, const char *call, const std::string &filename)
+    {
+      if (status != MPI_SUCCESS) {
+        char err_string[MPI_MAX_ERROR_STRING];
+        int err_len;
+        MPI_Error_string(status, err_string, &err_len);
+        errorQuda("%s failed for %s: %s", call, filename.c_str(), err_string);
+      }
+    }
+
+    /**
+       @brief Transfer all record fields between the file and this
+       rank's buffers with one collective MPI-IO call per field.  The
+       file view of each rank is the subarray of the global lattice
+       that it owns.  When writing, the header and the trailer (e.g.,
+       low-rank coefficients) are written by rank 0.
+     */
+    static void transfer(const std::string &filename, bool write, int n_record, size_t site_bytes,
+                         const Layout &layout, const char *header, const std::vector<double> &trailer,
+                         const RecordFunction &record)
+    {
+      std::vector<char> buffer(layout.local_volume * site_bytes);
+
+      MPI_Comm comm = *static_cast<MPI_Comm *>(comm_mpi_handle());
+      MPI_File fh;
+      int mode = write ? MPI_MODE_WRONLY | MPI_MODE_CREATE : MPI_MODE_RDONLY;
+      check_mpi(MPI_File_open(comm, filename.c_str(), mode, MPI_INFO_NULL, &fh), "MPI_File_open", filename);
+
+      MPI_Offset body_bytes = header_bytes + n_record * layout.global_volume * site_bytes;
+      if (write) {
+        check_mpi(MPI_File_set_size(fh, body_bytes + trailer.size() * sizeof(double)), "MPI_File_set_size", filename);
+        if (comm_rank() == 0) {
+          check_mpi(MPI_File_write_at(fh, 0, header, header_bytes, MPI_BYTE, MPI_STATUS_IGNORE), "MPI_File_write_at",
+                    filename);
+          if (trailer.size() > 0)
+            check_mpi(MPI_File_write_at(fh, body_bytes, trailer.data(), trailer.size(), MPI_DOUBLE, MPI_STATUS_IGNORE),
+                      "MPI_File_write_at", filename);
+        }
+      }
+
+      MPI_Datatype site_type, file_type;
+      check_mpi(MPI_Type_contiguous(site_bytes, MPI_BYTE, &site_type), "MPI_Type_contiguous", filename);
+      check_mpi(MPI_Type_commit(&site_type), "MPI_Type_commit", filename);
+      check_mpi(MPI_Type_create_subarray(n_dim, layout.G, layout.X, layout.offset, MPI_ORDER_FORTRAN, site_type, &file_type),
+                "MPI_Type_create_subarray", filename);
+      check_mpi(MPI_Type_commit(&file_type), "MPI_Type_commit", filename);
+
+      for (int i = 0; i < n_record; i++) {
+        MPI_Offset disp = header_bytes + i * layout.global_volume * site_bytes;
+        check_mpi(MPI_File_set_view(fh, disp, site_type, file_type, "native", MPI_INFO_NULL), "MPI_File_set_view",
+                  filename);
+        if (write) {
+          record(i, buffer.data());
+          check_mpi(MPI_File_write_all(fh, buffer.data(), layout.local_volume, site_type, MPI_STATUS_IGNORE),
+                    "MPI_File_write_all", filename);
+        } else {
+          check_mpi(MPI_File_read_all(fh, buffer.data(), layout.local_volume, site_type, MPI_STATUS_IGNORE),
+                    "MPI_File_read_all", filename);
+          record(i, buffer.data());
+        }
+      }
+
+      MPI_Type_free(&file_type);
+      MPI_Type_free(&site_type);
+      check_mpi(MPI_File_close(&fh), "MPI_File_close", filename);
+    }
+#else
+    /**
+       @brief Transfer all record fields between the file and this
+       rank's buffers with pread / pwrite.  When writing, the header
+       and the trailer (e.g., low-rank coefficients) are written by
+       rank 0.
+     */
+    static void transfer(const std::string &filename, bool write, int n_record, size_t site_bytes,
+                         const Layout &layout, const char *header, const std::vector<double> &trailer,
+                         const RecordFunction &record)
+    {
+      std::vector<char> buffer(layout.local_volume * site_bytes);
+      const size_t record_stride = layout.global_volume * site_bytes;
+
+      if (write) create_file(filename, header, trailer, header_bytes + n_record * record_stride);
+
+      int fd = open(filename.c_str(), write ? O_WRONLY : O_RDONLY);
+      if (fd < 0) errorQuda("Failed to open %s", filename.c_str());
+
+      for (int i = 0; i < n_record; i++) {
+        if (write) record(i, buffer.data());
+        transfer_runs(fd, write, buffer.data(), site_bytes, layout, header_bytes + i * record_stride, filename);
+        if (!write) record(i, buffer.data());
+      }
+
+      close(fd);
+      if (write) comm_barrier(); // the file is complete once all ranks have returned
+    }
+#endif
+
+    static void report(const char *action, const std::string &filename, size_t bytes, double time)
+    {
+      if (getVerbosity() >= QUDA_SUMMARIZE)
+        printfQuda("%s %s: %.3f GiB in %.3f s (%.3f GiB/s)\n", action, filename.c_str(),
+                   bytes / static_cast<double>(1 << 30), time, bytes / (time * (1 << 30)));
+    }
+
+    /**
+       Background writer used for asynchronous saving, enabled by
+       setting a host staging budget with QUDA_IO_ASYNC_SIZE (in MiB).
+       The records of each save are snapshotted into staging buffers,
+       and the file is created with its header on the calling thread.
+       A single background thread then writes each rank's sub-blocks
+       with pwrite, which requires no communication, so computation
+       (and MPI traffic) can continue.  A save that would exceed the
+       budget first waits for earlier writes to drain, and a save
+       larger than the whole budget is written synchronously.
+     */
+    class AsyncWriter
+    {
+      struct Job {
+        std::string filename;
+        std::vector<std::vector<char>> records;
+        size_t site_bytes;
+        Layout layout;
+        size_t file_bytes;
+        size_t staged_bytes;
+        std::string error; // set by the writer thread if the write failed
+      };
+
+      std::thread thread;
+      std::mutex mutex;
+      std::condition_variable cv;
+      std::deque<Job> queue;
+      size_t staged = 0; // staging bytes in use, including those of the job being written
+      bool stop = false;
+      int n_written = 0;
+      size_t bytes_written = 0;
+      double write_time = 0.0;
+      std::string error; // first failed write, raised on the calling thread by sync
+
+      void run()
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+          cv.wait(lock, [&] { return stop || !queue.empty(); });
+          if (queue.empty()) return;
+          Job &job = queue.front(); // references into a deque remain valid as jobs are appended
+          lock.unlock();
+
+          host_timer_t timer;
+          timer.start();
+          // errors cannot be raised on this thread, so they are recorded for sync
+          int fd = open(job.filename.c_str(), O_WRONLY);
+          if (fd < 0) {
+            job.error = "Failed to open " + job.filename + ": " + strerror(errno);
+          } else {
+            for (size_t i = 0; i < job.records.size(); i++)
+              if (!transfer_runs(fd, true, job.records[i].data(), job.site_bytes, job.layout,
+                                 header_bytes + i * job.layout.global_volume * job.site_bytes, job.filename, &job.error))
+                break;
+            close(fd);
+          }
+          timer.stop();
+
+          lock.lock();
+          if (!job.error.empty() && error.empty()) error = job.error;
+          staged -= job.staged_bytes;
+          n_written++;
+          bytes_written += job.file_bytes;
+          write_time += timer.last_interval;
+          queue.pop_front();
+          cv.notify_all();
+        }
+      }
+
+      bool pending(const std::string &filename)
+      {
+        for (auto &job : queue)
+          if (job.filename == filename) return true;
+        return false;
+      }
+
+    public:
+      static size_t budget()
+      {
+        static bool init = false;
+        static size_t bytes = 0;
+
+        if (!init) {
+          char *async_env = getenv("QUDA_IO_ASYNC_SIZE");
+          if (async_env) {
+            long size = atol(async_env);
+            if (size < 0) errorQuda("Invalid QUDA_IO_ASYNC_SIZE=%s", async_env);
+            bytes = static_cast<size_t>(size) * 1024 * 1024;
+          }
+          init = true;
+        }
+        return bytes;
+      }
+
+      ~AsyncWriter()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop = true;
+        }
+        cv.notify_all();
+        if (thread.joinable()) thread.join(); // outstanding writes are completed first
+        if (!error.empty()) warningQuda("Asynchronous write failed and was never waited on: %s", error.c_str());
+      }
+
+      /**
+         @brief Block until the given number of staging bytes are
+         available within the budget, and reserve them
+       */
+      void reserve(size_t bytes)
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return staged + bytes <= budget(); });
+        staged += bytes;
+      }
+
+      /**
+         @brief Queue the staged records of a created file for writing
+       */
+      void submit(const std::string &filename, std::vector<std::vector<char>> &&records, size_t site_bytes,
+                  const Layout &layout, size_t file_bytes, size_t staged_bytes)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({filename, std::move(records), site_bytes, layout, file_bytes, staged_bytes});
+        if (!thread.joinable()) thread = std::thread(&AsyncWriter::run, this);
+        cv.notify_all();
+      }
+
+      /**
+         @brief Wait until any outstanding write of the given file (or
+         of all files if empty) has completed on every rank, and raise
+         any write that failed in the background.  This is a collective
+         call if asynchronous writing is enabled.
+       */
+      void sync(const std::string &filename = "")
+      {
+        if (budget() == 0) return;
+        std::string failed;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cv.wait(lock, [&] { return filename.empty() ? queue.empty() : !pending(filename); });
+          failed.swap(error);
+        }
+        if (!failed.empty()) errorQuda("Asynchronous write failed: %s", failed.c_str());
+        comm_barrier();
+      }
+
+      void print()
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (getVerbosity() >= QUDA_SUMMARIZE && n_written > 0)
+          printfQuda("Asynchronous writer: %d files, %.3f GiB written in %.3f s in the background\n", n_written,
+                     bytes_written / static_cast<double>(1 << 30), write_time);
+        n_written = 0;
+        bytes_written = 0;
+        write_time = 0.0;
+      }
+    };
+
+    static AsyncWriter &async_writer()
+    {
+      static AsyncWriter writer;
+      return writer;
+    }
+
+    /**
+       @brief Return the maximum over fields of the global relative
+       error, given the local squared error and norm of each field
+     */
+    static double max_relative_error(std::vector<double> &err2_norm2)
+    {
+      comm_allreduce_array(err2_norm2.data(), err2_norm2.size());
+      double error = 0.0;
+      for (size_t i = 0; i < err2_norm2.size(); i += 2)
+        if (err2_norm2[i + 1] > 0.0) error = std::max(error, sqrt(err2_norm2[i] / err2_norm2[i + 1]));
+      return error;
+    }
+
+    static void write_fields(const std::string &filename, void *V[], int n_field, QudaPrecision precision,
+                             const int *X, QudaSiteSubset subset, QudaParity parity, int n_color, int n_spin,
+                             int site_len, bool compress)
+    {
+      if (precision != QUDA_DOUBLE_PRECISION && precision != QUDA_SINGLE_PRECISION)
+        errorQuda("Unsupported precision %d", precision);
+
+      async_writer().sync(filename); // a previous save of this file must be complete before it is replaced
+
+      host_timer_t timer;
+      timer.start();
+
+      Layout layout(X, subset);
+      const size_t length = layout.local_volume * site_len;
+      const int encoding = compress ? compression().encoding : RAW;
+      const bool lowrank = compress && compression().lowrank_tol > 0.0 && n_field > 1;
+      const size_t site_bytes = record_bytes(encoding, site_len, precision);
+
+      std::vector<std::vector<double>> basis;
+      std::vector<double> coeff;
+      std::vector<std::vector<char>> basis_records;
+      std::vector<double> err2_norm2(2 * n_field, 0.0);
+      RecordFunction record;
+
+      if (lowrank) {
+        std::vector<std::vector<double>> vecs(n_field, std::vector<double>(length));
+        for (int i = 0; i < n_field; i++) pack(vecs[i].data(), QUDA_DOUBLE_PRECISION, V[i], precision, layout, site_len);
+        gram_schmidt(basis, coeff, vecs, length, compression().lowrank_tol);
+
+        // encode the basis, and replace it with what will be decoded on loading
+        basis_records.resize(basis.size());
+        for (size_t i = 0; i < basis.size(); i++) {
+          basis_records[i].resize(layout.local_volume * site_bytes);
+          if (encoding == RAW) {
+            convert(basis_records[i].data(), precision, basis[i].data(), QUDA_DOUBLE_PRECISION, length);
+            convert(basis[i].data(), QUDA_DOUBLE_PRECISION, basis_records[i].data(), precision, length);
+          } else {
+            encode(basis_records[i].data(), basis[i].data(), layout.local_volume, site_len, encoding);
+            decode(basis[i].data(), basis_records[i].data(), layout.local_volume, site_len, encoding);
+          }
+        }
+
+        std::vector<double> v;
+        for (int j = 0; j < n_field; j++) {
+          reconstruct(v, basis, coeff, n_field, j, length);
+          for (size_t x = 0; x < length; x++) {
+            err2_norm2[2 * j] += (v[x] - vecs[j][x]) * (v[x] - vecs[j][x]);
+            err2_norm2[2 * j + 1] += vecs[j][x] * vecs[j][x];
+          }
+        }
+
+        record = [&](int i, char *buffer) { memcpy(buffer, basis_records[i].data(), basis_records[i].size()); };
+      } else if (encoding != RAW) {
+        record = [&](int i, char *buffer) {
+          std::vector<double> v(length), w(length);
+          pack(v.data(), QUDA_DOUBLE_PRECISION, V[i], precision, layout, site_len);
+          encode(buffer, v.data(), layout.local_volume, site_len, encoding);
+          decode(w.data(), buffer, layout.local_volume, site_len, encoding);
+          for (size_t x = 0; x < length; x++) {
+            err2_norm2[2 * i] += (w[x] - v[x]) * (w[x] - v[x]);
+            err2_norm2[2 * i + 1] += v[x] * v[x];
+          }
+        };
+      } else {
+        record = [&](int i, char *buffer) { pack(buffer, precision, V[i], precision, layout, site_len); };
+      }
+
+      // encode every field up front, so that the error recorded in the header is known before writing
+      std::vector<std::vector<char>> records;
+      if (encoding != RAW && !lowrank) {
+        records.resize(n_field, std::vector<char>(layout.local_volume * site_bytes));
+        for (int i = 0; i < n_field; i++) record(i, records[i].data());
+        record = [&](int i, char *buffer) { memcpy(buffer, records[i].data(), records[i].size()); };
+      }
+
+      const int n_record = lowrank ? basis.size() : n_field;
+      const double error = encoding != RAW || lowrank ? max_relative_error(err2_norm2) : 0.0;
+
+      char header_buf[header_bytes] = {};
+      Header header;
+      memcpy(header.magic, magic, sizeof(magic));
+      header.version = version;
+      header.endian = endian_check;
+      header.precision = precision;
+      header.ndim = n_dim;
+      for (int d = 0; d < n_dim; d++) header.dims[d] = layout.G[d];
+      header.subset = subset;
+      header.parity = parity;
+      header.n_color = n_color;
+      header.n_spin = n_spin;
+      header.site_len = site_len;
+      header.n_field = n_field;
+      header.encoding = encoding;
+      header.n_basis = lowrank ? n_record : 0;
+      header.error = error;
+
+      memcpy(header_buf, &header, sizeof(header));
+      const size_t record_stride = layout.global_volume * site_bytes;
+      const size_t bytes = header_bytes + n_record * record_stride + coeff.size() * sizeof(double);
+      const size_t staged_bytes = n_record * layout.local_volume * site_bytes;
+
+      if (staged_bytes <= AsyncWriter::budget()) {
+        async_writer().reserve(staged_bytes);
+        std::vector<std::vector<char>> staged(n_record, std::vector<char>(layout.local_volume * site_bytes));
+        for (int i = 0; i < n_record; i++) record(i, staged[i].data());
+        create_file(filename, header_buf, coeff, header_bytes + n_record * record_stride);
+        async_writer().submit(filename, std::move(staged), site_bytes, layout, bytes, staged_bytes);
+        timer.stop();
+        report("Queued", filename, bytes, timer.last_interval);
+      } else {
+        transfer(filename, true, n_record, site_bytes, layout, header_buf, coeff, record);
+        timer.stop();
+        report("Saved", filename, bytes, timer.last_interval);
+      }
+      if (getVerbosity() >= QUDA_SUMMARIZE && (encoding != RAW || lowrank))
+        printfQuda("Encoded %d fields as %d records with encoding %s, compression ratio %.2f, maximum relative error %e\n",
+                   n_field, n_record, encoding_str(encoding),
+                   static_cast<double>(n_field) * layout.global_volume * site_len * precision
+                     / (n_record * layout.global_volume * site_bytes + coeff.size() * sizeof(double)),
+                   header.error);
+    }
+
+    static void read_fields(const std::string &filename, void *V[], int n_field, QudaPrecision precision, const int *X,
+                            QudaSiteSubset subset, QudaParity parity, int n_color, int n_spin, int site_len)
+    {
+      if (precision != QUDA_DOUBLE_PRECISION && precision != QUDA_SINGLE_PRECISION)
+        errorQuda("Unsupported precision %d", precision);
+
+      async_writer().sync(filename);
+
+      host_timer_t timer;
+      timer.start();
+
+      Header header = {};
+      if (comm_rank() == 0) {
+        FILE *fp = fopen(filename.c_str(), "rb");
+        if (!fp) errorQuda("Failed to open %s", filename.c_str());
+        if (fread(&header, sizeof(header), 1, fp) != 1) errorQuda("Failed to read header of %s", filename.c_str());
+        fclose(fp);
+      }
+      comm_broadcast(&header, sizeof(header));
+
+      if (memcmp(header.magic, magic, sizeof(magic)) != 0) errorQuda("%s is not a native QUDA field file", filename.c_str());
+      if (header.endian != endian_check) errorQuda("%s was written with a different byte order", filename.c_str());
+      if (header.version < 1 || header.version > version)
+        errorQuda("Unsupported version %d of %s", header.version, filename.c_str());
+
+      Layout layout(X, subset);
+      for (int d = 0; d < n_dim; d++)
+        if (header.dims[d] != layout.G[d])
+          errorQuda("Lattice dimension %d of %s is %d, expected %d", d, filename.c_str(), header.dims[d], layout.G[d]);
+      if (header.subset != subset) errorQuda("Site subset %d of %s does not match %d", header.subset, filename.c_str(), subset);
+      if (header.site_len != site_len)
+        errorQuda("Site length %d of %s does not match expected %d", header.site_len, filename.c_str(), site_len);
+      if (header.n_field != n_field)
+        errorQuda("%s contains %d fields, expected %d", filename.c_str(), header.n_field, n_field);
+      if (header.precision != QUDA_DOUBLE_PRECISION && header.precision != QUDA_SINGLE_PRECISION)
+        errorQuda("Unsupported file precision %d in %s", header.precision, filename.c_str());
+      if (header.parity != parity)
+        warningQuda("Parity %d of %s does not match expected parity %d", header.parity, filename.c_str(), parity);
+      if (header.n_color != n_color || header.n_spin != n_spin)
+        warningQuda("nColor = %d, nSpin = %d of %s does not match expected nColor = %d, nSpin = %d", header.n_color,
+                    header.n_spin, filename.c_str(), n_color, n_spin);
+
+      auto file_prec = static_cast<QudaPrecision>(header.precision);
+      const int encoding = header.encoding;
+      const size_t site_bytes = record_bytes(encoding, site_len, file_prec);
+      const size_t length = layout.local_volume * site_len;
+      const bool lowrank = header.n_basis > 0;
+      const int n_record = lowrank ? header.n_basis : n_field;
+
+      std::vector<double> coeff(lowrank ? 2 * n_record * n_field : 0);
+      if (lowrank) {
+        if (comm_rank() == 0) {
+          FILE *fp = fopen(filename.c_str(), "rb");
+          if (!fp) errorQuda("Failed to open %s", filename.c_str());
+          fseek(fp, header_bytes + n_record * layout.global_volume * site_bytes, SEEK_SET);
+          if (fread(coeff.data(), sizeof(double), coeff.size(), fp) != coeff.size())
+            errorQuda("Failed to read low-rank coefficients of %s", filename.c_str());
+          fclose(fp);
+        }
+        comm_broadcast(coeff.data(), coeff.size() * sizeof(double));
+      }
+
+      std::vector<std::vector<double>> basis(lowrank ? n_record : 0);
+      RecordFunction record;
+      if (lowrank) {
+        record = [&](int i, char *buffer) {
+          basis[i].resize(length);
+          if (encoding == RAW)
+            convert(basis[i].data(), QUDA_DOUBLE_PRECISION, buffer, file_prec, length);
+          else
+            decode(basis[i].data(), buffer, layout.local_volume, site_len, encoding);
+        };
+      } else if (encoding != RAW) {
+        record = [&](int i, char *buffer) {
+          std::vector<double> v(length);
+          decode(v.data(), buffer, layout.local_volume, site_len, encoding);
+          unpack(V[i], precision, v.data(), QUDA_DOUBLE_PRECISION, layout, site_len);
+        };
+      } else {
+        record = [&](int i, char *buffer) { unpack(V[i], precision, buffer, file_prec, layout, site_len); };
+      }
+
+      transfer(filename, false, n_record, site_bytes, layout, nullptr, {}, record);
+
+      if (lowrank) {
+        std::vector<double> v;
+        for (int j = 0; j < n_field; j++) {
+          reconstruct(v, basis, coeff, n_field, j, length);
+          unpack(V[j], precision, v.data(), QUDA_DOUBLE_PRECISION, layout, site_len);
+        }
+      }
+
+      timer.stop();
+      report("Loaded", filename, header_bytes + n_record * layout.global_volume * site_bytes + coeff.size() * sizeof(double),
+             timer.last_interval);
+      if (getVerbosity() >= QUDA_SUMMARIZE && (encoding != RAW || lowrank))
+        printfQuda("Loaded %d fields from %d records with encoding %s, maximum relative error %e\n", n_field, n_record,
+                   encoding_str(encoding), header.error);
+    }
+
+    void wait()
+    {
+      async_writer().sync();
+      async_writer().print();
+    }
+
+    bool is_native(const std::string &filename)
+    {
+      int native = 0;
+      if (comm_rank() == 0) {
+        FILE *fp = fopen(filename.c_str(), "rb");
+        if (fp) {
+          char file_magic[sizeof(magic)];
+          native = fread(file_magic, sizeof(file_magic), 1, fp) == 1 && memcmp(file_magic, magic, sizeof(magic)) == 0;
+          fclose(fp);
+        }
+      }
+      comm_broadcast(&native, sizeof(native));
+      return native;
+    }
+
+    bool save_native()
+    {
+      static bool init = false;
+#ifdef HAVE_QIO
+      static bool native = false;
+#else
+      static bool native = true;
+#endif
+
+      if (!init) {
+        char *format_env = getenv("QUDA_IO_FORMAT");
+        if (format_env) {
+          if (strcmp(format_env, "native") == 0) {
+            native = true;
+          } else if (strcmp(format_env, "qio") == 0) {
+#ifndef HAVE_QIO
+            errorQuda("QUDA_IO_FORMAT=qio requested but QIO library was not built");
+#endif
+            native = false;
+          } else {
+            errorQuda("Unknown QUDA_IO_FORMAT=%s", format_env);
+          }
+        }
+        if (!native && getenv("QUDA_IO_COMPRESS")) warningQuda("QUDA_IO_COMPRESS is ignored for QIO files");
+        init = true;
+      }
+      return native;
+    }
+
+    void read_spinor_field(const std::string &filename, void *V[], QudaPrecision precision, const int *X,
+                           QudaSiteSubset subset, QudaParity parity, int nColor, int nSpin, int Nvec)
+    {
+      read_fields(filename, V, Nvec, precision, X, subset, parity, nColor, nSpin, 2 * nSpin * nColor);
+    }
+
+    void write_spinor_field(const std::string &filename, void *V[], QudaPrecision precision, const int *X,
+                            QudaSiteSubset subset, QudaParity parity, int nColor, int nSpin, int Nvec, bool compress)
+    {
+      write_fields(filename, V, Nvec, precision, X, subset, parity, nColor, nSpin, 2 * nSpin * nColor, compress);
+    }
+
+    void read_gauge_field(const std::string &filename, void *gauge[], QudaPrecision precision, const int *X,
+                          int nColor, int geometry)
+    {
+      read_fields(filename, gauge, geometry, precision, X, QUDA_FULL_SITE_SUBSET, QUDA_INVALID_PARITY, nColor, 0,
+                  2 * nColor * nColor);
+    }
+
+    void write_gauge_field(const std::string &filename, void *gauge[], QudaPrecision precision, const int *X,
+                           int nColor, int geometry)
+    {
+      write_fields(filename, gauge, geometry, precision, X, QUDA_FULL_SITE_SUBSET, QUDA_INVALID_PARITY, nColor, 0,
+                   2 * nColor * nColor, false);
+    }
+
+    MappedFile::MappedFile(const std::string &filename) : filename(filename), fd(-1), map(nullptr), map_bytes(0)
+    {
+      async_writer().sync(filename);
+
+      fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) errorQuda("Failed to open %s", filename.c_str());
+
+      struct stat st;
+      if (fstat(fd, &st) != 0) errorQuda("Failed to stat %s", filename.c_str());
+      map_bytes = st.st_size;
+      if (map_bytes < header_bytes) errorQuda("%s is too small to be a native QUDA field file", filename.c_str());
+
+      map = mmap(nullptr, map_bytes, PROT_READ, MAP_SHARED, fd, 0);
+      if (map == MAP_FAILED) errorQuda("Failed to map %s", filename.c_str());
+
+      Header header;
+      memcpy(&header, map, sizeof(header));
+      if (memcmp(header.magic, magic, sizeof(magic)) != 0) errorQuda("%s is not a native QUDA field file", filename.c_str());
+      if (header.endian != endian_check) errorQuda("%s was written with a different byte order", filename.c_str());
+      if (header.version < 1 || header.version > version)
+        errorQuda("Unsupported version %d of %s", header.version, filename.c_str());
+      if (header.n_basis > 0)
+        errorQuda("%s holds a low-rank basis, which cannot be read on demand", filename.c_str());
+      if (header.precision != QUDA_DOUBLE_PRECISION && header.precision != QUDA_SINGLE_PRECISION)
+        errorQuda("Unsupported file precision %d in %s", header.precision, filename.c_str());
+
+      n_field = header.n_field;
+      precision = static_cast<QudaPrecision>(header.precision);
+      subset = static_cast<QudaSiteSubset>(header.subset);
+      site_len = header.site_len;
+      encoding = header.encoding;
+      size_t volume = 1;
+      for (int d = 0; d < n_dim; d++) {
+        dims[d] = header.dims[d];
+        volume *= dims[d];
+      }
+      if (map_bytes < header_bytes + n_field * volume * record_bytes(encoding, site_len, precision))
+        errorQuda("%s is truncated (%lu bytes)", filename.c_str(), map_bytes);
+
+      // fields are read on demand in no particular order
+      madvise(map, map_bytes, MADV_RANDOM);
+    }
+
+    MappedFile::~MappedFile()
+    {
+      if (map) munmap(map, map_bytes);
+      if (fd >= 0) close(fd);
+    }
+
+    void MappedFile::read(int i, void *V, QudaPrecision precision, const int *X, QudaSiteSubset subset,
+                          int site_len) const
+    {
+      if (i < 0 || i >= n_field) errorQuda("Field %d out of range for %s with %d fields", i, filename.c_str(), n_field);
+
+      Layout layout(X, subset);
+      for (int d = 0; d < n_dim; d++)
+        if (dims[d] != layout.G[d])
+          errorQuda("Lattice dimension %d of %s is %d, expected %d", d, filename.c_str(), dims[d], layout.G[d]);
+      if (this->subset != subset)
+        errorQuda("Site subset %d of %s does not match %d", this->subset, filename.c_str(), subset);
+      if (this->site_len != site_len)
+        errorQuda("Site length %d of %s does not match expected %d", this->site_len, filename.c_str(), site_len);
+
+      const size_t site_bytes = record_bytes(encoding, site_len, this->precision);
+      const char *field = static_cast<const char *>(map) + header_bytes + i * layout.global_volume * site_bytes;
+      if (encoding == RAW) {
+        unpack(V, precision, field, this->precision, layout, site_len, true);
+      } else {
+        // decode the local sites row by row into local lexicographic order
+        std::vector<double> v(layout.local_volume * site_len);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t row = 0; row < layout.rows(); row++) {
+          size_t r;
+          int parity;
+          layout.row(row, r, parity);
+          decode(v.data() + r * site_len, field + layout.global_row(row) * site_bytes, layout.X[0], site_len, encoding);
+        }
+        unpack(V, precision, v.data(), QUDA_DOUBLE_PRECISION, layout, site_len);
+      }
+    }
+
+  } // namespace native_io
+
+} // namespace quda
@@ -2,6 +2,7 @@
 #include <gauge_field.h>
 #include <blas_quda.h>
 #include <timer.h>
+#include <field_io.h>
 
 namespace quda {
 
@@ -351,6 +352,40 @@ namespace quda {
     return Checksum(*this, mini);
   }
 
+  /**
+     @brief Parameters of the QDP-ordered host copy used for saving and loading
+   */
+  static GaugeFieldParam ioParam(const GaugeField &u)
+  {
+    if (u.Ndim() != 4) errorQuda("Unsupported number of dimensions %d", u.Ndim());
+    GaugeFieldParam param(u);
+    param.location = QUDA_CPU_FIELD_LOCATION;
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.reconstruct = QUDA_RECONSTRUCT_NO;
+    param.order = QUDA_QDP_GAUGE_ORDER;
+    param.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    param.nFace = 0;
+    param.pad = 0;
+    param.setPrecision(std::max(u.Precision(), QUDA_SINGLE_PRECISION));
+    return param;
+  }
+
+  void saveGaugeField(const std::string &filename, const GaugeField &u)
+  {
+    cpuGaugeField host(ioParam(u));
+    host.copy(u);
+    native_io::write_gauge_field(filename, static_cast<void **>(host.Gauge_p()), host.Precision(), host.X(),
+                                 host.Ncolor(), host.Geometry());
+  }
+
+  void loadGaugeField(const std::string &filename, GaugeField &u)
+  {
+    cpuGaugeField host(ioParam(u));
+    native_io::read_gauge_field(filename, static_cast<void **>(host.Gauge_p()), host.Precision(), host.X(),
+                                host.Ncolor(), host.Geometry());
+    u.copy(host);
+  }
+
   GaugeField* GaugeField::Create(const GaugeFieldParam &param) {
 
     GaugeField *field = nullptr;
@@ -0,0 +1,450 @@
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include <quda_internal.h>
+#include <timer.h>
+#include <halo_compress.h>
+
+namespace quda
+{
+
+  namespace halo_compress
+  {
+
+    /**
+       Header prepended to each compressed message.  The mode stored
+       here is the one actually used for the message, which is
+       Mode::NONE if compression did not reduce the message size.
+     */
+    struct Header {
+      uint32_t magic;
+      uint32_t mode;
+      uint32_t precision;
+      uint32_t reserved;
+      uint64_t bytes;
+      uint64_t payload;
+    };
+
+    static_assert(sizeof(Header) <= header_bytes(), "halo compression header exceeds reserved size");
+
+    constexpr uint32_t header_magic = 0x51484331; // "QHC1"
+
+    /** Number of values that share an exponent in block-float mode */
+    constexpr int block_length = 16;
+
+    static bool init = false;
+    static bool any_enabled = false;
+    static Mode mode_list[4] = {Mode::NONE, Mode::NONE, Mode::NONE, Mode::NONE};
+
+    static host_timer_t compress_timer;
+    static host_timer_t decompress_timer;
+    static size_t raw_bytes = 0;
+    static size_t sent_bytes = 0;
+
+    static int precision_index(QudaPrecision precision)
+    {
+      switch (precision) {
+      case QUDA_QUARTER_PRECISION: return 0;
+      case QUDA_HALF_PRECISION: return 1;
+      case QUDA_SINGLE_PRECISION: return 2;
+      case QUDA_DOUBLE_PRECISION: return 3;
+      default: errorQuda("Invalid precision %d", precision);
+      }
+      return -1;
+    }
+
+    static Mode parse_mode(const std::string &s)
+    {
+      if (s == "none") return Mode::NONE;
+      if (s == "byteplane") return Mode::BYTE_PLANE;
+      if (s == "blockfloat") return Mode::BLOCK_FLOAT;
+      errorQuda("Unknown halo compression mode \"%s\" (valid modes are none, byteplane, blockfloat)", s.c_str());
+      return Mode::NONE;
+    }
+
+    static QudaPrecision parse_precision(const std::string &s)
+    {
+      if (s == "quarter") return QUDA_QUARTER_PRECISION;
+      if (s == "half") return QUDA_HALF_PRECISION;
+      if (s == "single") return QUDA_SINGLE_PRECISION;
+      if (s == "double") return QUDA_DOUBLE_PRECISION;
+      errorQuda("Unknown halo compression precision \"%s\" (valid precisions are quarter, half, single, double)",
+                s.c_str());
+      return QUDA_INVALID_PRECISION;
+    }
+
+    static void init_modes()
+    {
+      if (init) return;
+
+      char *compress_env = getenv("QUDA_HALO_COMPRESS");
+      if (compress_env) {
+        std::stringstream compress_list(compress_env);
+        std::string entry;
+        while (std::getline(compress_list, entry, ',')) {
+          auto colon = entry.find(':');
+          if (colon == std::string::npos) {
+            Mode m = parse_mode(entry);
+            // block-float only makes sense for floating-point ghosts, the fixed-point ones are already quantized
+            for (int i = 0; i < 4; i++)
+              if (m != Mode::BLOCK_FLOAT || i >= precision_index(QUDA_SINGLE_PRECISION)) mode_list[i] = m;
+          } else {
+            QudaPrecision precision = parse_precision(entry.substr(0, colon));
+            Mode m = parse_mode(entry.substr(colon + 1));
+            if (m == Mode::BLOCK_FLOAT && precision < QUDA_SINGLE_PRECISION)
+              errorQuda("Block-float halo compression is not supported for precision %d", precision);
+            mode_list[precision_index(precision)] = m;
+          }
+        }
+      }
+
+      for (auto m : mode_list) any_enabled = any_enabled || m != Mode::NONE;
+      if (any_enabled && getVerbosity() > QUDA_SILENT)
+        printfQuda("Enabling halo compression (quarter=%d, half=%d, single=%d, double=%d)\n",
+                   static_cast<int>(mode_list[0]), static_cast<int>(mode_list[1]), static_cast<int>(mode_list[2]),
+                   static_cast<int>(mode_list[3]));
+
+      init = true;
+    }
+
+    Mode mode(QudaPrecision precision)
+    {
+      init_modes();
+      return mode_list[precision_index(precision)];
+    }
+
+    bool enabled()
+    {
+      init_modes();
+      return any_enabled;
+    }
+
+    /**
+       @brief PackBits-style run-length encoding of a strided byte
+       sequence.  A control byte c < 128 is followed by c + 1 literal
+       bytes, while c >= 128 is followed by a single byte that is
+       repeated c - 125 times.
+       @return Number of bytes written, or a value larger than
+       max_bytes if the encoding would not fit
+     */
+    static size_t rle_encode(uint8_t *dst, size_t max_bytes, const uint8_t *src, size_t n, size_t stride)
+    {
+      size_t out = 0;
+      size_t i = 0;
+      while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 130 && src[(i + run) * stride] == src[i * stride]) run++;
+
+        if (run >= 3) {
+          if (out + 2 > max_bytes) return max_bytes + 1;
+          dst[out++] = static_cast<uint8_t>(run + 125);
+          dst[out++] = src[i * stride];
+          i += run;
+        } else {
+          // accumulate literals until we hit a run of at least three
+          size_t literal = 0;
+          while (i + literal < n && literal < 128) {
+            const uint8_t *s = src + (i + literal) * stride;
+            if (i + literal + 2 < n && s[0] == s[stride] && s[0] == s[2 * stride]) break;
+            literal++;
+          }
+          if (out + 1 + literal > max_bytes) return max_bytes + 1;
+          dst[out++] = static_cast<uint8_t>(literal - 1);
+          for (size_t j = 0; j < literal; j++) dst[out++] = src[(i + j) * stride];
+          i += literal;
+        }
+      }
+      return out;
+    }
+
+    /**
+       @brief Decode a run-length encoded strided byte sequence
+       @return The number of bytes consumed from src
+     */
+    static size_t rle_decode(uint8_t *dst, size_t n, size_t stride, const uint8_t *src)
+    {
+      size_t in = 0;
+      size_t i = 0;
+      while (i < n) {
+        uint8_t c = src[in++];
+        size_t count = c < 128 ? c + 1 : c - 125;
+        if (i + count > n) errorQuda("Corrupt halo message (run of %lu exceeds remaining %lu bytes)", count, n - i);
+        if (c < 128) {
+          for (size_t j = 0; j < count; j++) dst[(i++) * stride] = src[in++];
+        } else {
+          uint8_t value = src[in++];
+          for (size_t j = 0; j < count; j++) dst[(i++) * stride] = value;
+        }
+      }
+      return in;
+    }
+
+    /** Encoding used for each byte plane */
+    enum PlaneCode : uint8_t { PLANE_RAW, PLANE_RLE, PLANE_DICTIONARY };
+
+    /**
+       @brief Encode a strided byte sequence that takes at most 16
+       distinct values by bit-packing dictionary indices.  The
+       encoding is: number of dictionary entries, the dictionary, then
+       the packed indices with 1, 2 or 4 bits per index.
+     */
+    static size_t dictionary_encode(uint8_t *dst, const uint8_t *src, size_t n, size_t stride, const uint8_t *dictionary,
+                                    int entries)
+    {
+      uint8_t index[256] = {};
+      for (int i = 0; i < entries; i++) index[dictionary[i]] = i;
+      const int bits = entries <= 2 ? 1 : entries <= 4 ? 2 : 4;
+
+      size_t out = 0;
+      dst[out++] = static_cast<uint8_t>(entries);
+      for (int i = 0; i < entries; i++) dst[out++] = dictionary[i];
+
+      const size_t packed = (n * bits + 7) / 8;
+      memset(dst + out, 0, packed);
+      for (size_t i = 0; i < n; i++) {
+        size_t bit = i * bits;
+        dst[out + bit / 8] |= index[src[i * stride]] << (bit % 8);
+      }
+      return out + packed;
+    }
+
+    static size_t dictionary_decode(uint8_t *dst, size_t n, size_t stride, const uint8_t *src)
+    {
+      const int entries = src[0];
+      const uint8_t *dictionary = src + 1;
+      const uint8_t *packed = src + 1 + entries;
+      const int bits = entries <= 2 ? 1 : entries <= 4 ? 2 : 4;
+      const int mask = (1 << bits) - 1;
+
+      for (size_t i = 0; i < n; i++) {
+        size_t bit = i * bits;
+        dst[i * stride] = dictionary[(packed[bit / 8] >> (bit % 8)) & mask];
+      }
+      return 1 + entries + (n * bits + 7) / 8;
+    }
+
+    /**
+       @brief Lossless byte-plane compression: the input is treated as
+       words of size "word" bytes, and each byte plane (the k-th byte
+       of every word) is encoded separately with whichever of raw,
+       run-length or dictionary encoding is smallest.  Sign and
+       exponent bytes are highly redundant and compress well, whereas
+       the low mantissa bytes are typically stored raw.
+       @return The size of the payload, or a value larger than bytes
+       if compression does not reduce the size
+     */
+    static size_t byte_plane_encode(uint8_t *dst, const uint8_t *src, size_t bytes, size_t word)
+    {
+      const size_t n = bytes / word;
+      const size_t tail = bytes - n * word;
+      size_t out = 0;
+
+      for (size_t plane = 0; plane < word; plane++) {
+        const uint8_t *p = src + plane;
+
+        bool present[256] = {};
+        uint8_t dictionary[16];
+        int entries = 0;
+        for (size_t i = 0; i < n && entries <= 16; i++) {
+          if (!present[p[i * word]]) {
+            present[p[i * word]] = true;
+            if (entries < 16) dictionary[entries] = p[i * word];
+            entries++;
+          }
+        }
+
+        const int bits = entries <= 2 ? 1 : entries <= 4 ? 2 : 4;
+        size_t best = n;
+        PlaneCode code = PLANE_RAW;
+        if (entries <= 16 && 1 + entries + (n * bits + 7) / 8 < best) {
+          best = 1 + entries + (n * bits + 7) / 8;
+          code = PLANE_DICTIONARY;
+        }
+
+        if (out + 1 + best > bytes) return bytes + 1;
+        size_t rle = rle_encode(dst + out + 1, best - 1, p, n, word);
+        if (rle < best) {
+          best = rle;
+          code = PLANE_RLE;
+        }
+
+        dst[out++] = code;
+        switch (code) {
+        case PLANE_RAW:
+          for (size_t i = 0; i < n; i++) dst[out + i] = p[i * word];
+          out += n;
+          break;
+        case PLANE_RLE: out += rle; break;
+        case PLANE_DICTIONARY: out += dictionary_encode(dst + out, p, n, word, dictionary, entries); break;
+        }
+        if (out >= bytes) return bytes + 1;
+      }
+
+      if (out + tail >= bytes) return bytes + 1;
+      memcpy(dst + out, src + n * word, tail);
+      return out + tail;
+    }
+
+    static void byte_plane_decode(uint8_t *dst, const uint8_t *src, size_t bytes, size_t word)
+    {
+      const size_t n = bytes / word;
+      const size_t tail = bytes - n * word;
+      size_t in = 0;
+      for (size_t plane = 0; plane < word; plane++) {
+        switch (src[in++]) {
+        case PLANE_RAW:
+          for (size_t i = 0; i < n; i++) dst[plane + i * word] = src[in + i];
+          in += n;
+          break;
+        case PLANE_RLE: in += rle_decode(dst + plane, n, word, src + in); break;
+        case PLANE_DICTIONARY: in += dictionary_decode(dst + plane, n, word, src + in); break;
+        default: errorQuda("Corrupt halo message (unknown plane encoding %d)", src[in - 1]);
+        }
+      }
+      memcpy(dst + n * word, src + in, tail);
+    }
+
+    template <typename Float, typename Mantissa>
+    static size_t block_float_encode(uint8_t *dst, const Float *src, size_t n)
+    {
+      constexpr int mantissa_bits = 8 * sizeof(Mantissa) - 1;
+      constexpr long mantissa_max = (1l << mantissa_bits) - 1;
+      const size_t n_block = (n + block_length - 1) / block_length;
+      uint8_t *mantissa = dst + n_block * sizeof(int16_t);
+
+      for (size_t b = 0; b < n_block; b++) {
+        const size_t begin = b * block_length;
+        const size_t end = std::min(begin + block_length, n);
+
+        Float max = 0.0;
+        for (size_t i = begin; i < end; i++) max = std::max(max, std::abs(src[i]));
+        if (!std::isfinite(max)) return 0; // cannot represent, fall back to uncompressed
+
+        int exponent = 0;
+        std::frexp(max, &exponent);
+        int16_t e = static_cast<int16_t>(exponent);
+        memcpy(dst + b * sizeof(int16_t), &e, sizeof(int16_t));
+
+        for (size_t i = begin; i < end; i++) {
+          long q = std::lrint(std::ldexp(src[i], mantissa_bits - exponent));
+          Mantissa m = static_cast<Mantissa>(std::max(-mantissa_max, std::min(mantissa_max, q)));
+          memcpy(mantissa + i * sizeof(Mantissa), &m, sizeof(Mantissa));
+        }
+      }
+
+      return n_block * sizeof(int16_t) + n * sizeof(Mantissa);
+    }
+
+    template <typename Float, typename Mantissa>
+    static void block_float_decode(Float *dst, const uint8_t *src, size_t n)
+    {
+      constexpr int mantissa_bits = 8 * sizeof(Mantissa) - 1;
+      const size_t n_block = (n + block_length - 1) / block_length;
+      const uint8_t *mantissa = src + n_block * sizeof(int16_t);
+
+      for (size_t b = 0; b < n_block; b++) {
+        const size_t begin = b * block_length;
+        const size_t end = std::min(begin + block_length, n);
+
+        int16_t e;
+        memcpy(&e, src + b * sizeof(int16_t), sizeof(int16_t));
+
+        for (size_t i = begin; i < end; i++) {
+          Mantissa m;
+          memcpy(&m, mantissa + i * sizeof(Mantissa), sizeof(Mantissa));
+          dst[i] = std::ldexp(static_cast<Float>(m), e - mantissa_bits);
+        }
+      }
+    }
+
+    size_t compress(void *dst, const void *src, size_t bytes, QudaPrecision precision)
+    {
+      compress_timer.start(__func__, __FILE__, __LINE__);
+
+      Header header = {header_magic, static_cast<uint32_t>(mode(precision)), static_cast<uint32_t>(precision), 0, bytes, 0};
+      auto payload = static_cast<uint8_t *>(dst) + header_bytes();
+      auto in = static_cast<const uint8_t *>(src);
+
+      size_t payload_bytes = bytes;
+      switch (static_cast<Mode>(header.mode)) {
+      case Mode::BYTE_PLANE: payload_bytes = byte_plane_encode(payload, in, bytes, precision); break;
+      case Mode::BLOCK_FLOAT:
+        if (bytes % precision != 0) break;
+        if (precision == QUDA_DOUBLE_PRECISION)
+          payload_bytes = block_float_encode<double, int32_t>(payload, static_cast<const double *>(src), bytes / precision);
+        else if (precision == QUDA_SINGLE_PRECISION)
+          payload_bytes = block_float_encode<float, int16_t>(payload, static_cast<const float *>(src), bytes / precision);
+        if (payload_bytes == 0) payload_bytes = bytes;
+        break;
+      default: break;
+      }
+
+      if (payload_bytes >= bytes) { // compression did not help, so send the raw halo
+        header.mode = static_cast<uint32_t>(Mode::NONE);
+        memcpy(payload, in, bytes);
+        payload_bytes = bytes;
+      }
+      header.payload = payload_bytes;
+      memcpy(dst, &header, sizeof(Header));
+
+      raw_bytes += bytes;
+      sent_bytes += header_bytes() + payload_bytes;
+
+      compress_timer.stop(__func__, __FILE__, __LINE__);
+      return header_bytes() + payload_bytes;
+    }
+
+    void decompress(void *dst, const void *src, size_t bytes)
+    {
+      decompress_timer.start(__func__, __FILE__, __LINE__);
+
+      Header header;
+      memcpy(&header, src, sizeof(Header));
+      if (header.magic != header_magic) errorQuda("Invalid halo message header %x", header.magic);
+      if (header.bytes != bytes) errorQuda("Halo message size %lu does not match expected %lu", header.bytes, bytes);
+
+      auto payload = static_cast<const uint8_t *>(src) + header_bytes();
+      auto out = static_cast<uint8_t *>(dst);
+      auto precision = static_cast<QudaPrecision>(header.precision);
+
+      switch (static_cast<Mode>(header.mode)) {
+      case Mode::NONE: memcpy(out, payload, bytes); break;
+      case Mode::BYTE_PLANE: byte_plane_decode(out, payload, bytes, precision); break;
+      case Mode::BLOCK_FLOAT:
+        if (precision == QUDA_DOUBLE_PRECISION)
+          block_float_decode<double, int32_t>(static_cast<double *>(dst), payload, bytes / precision);
+        else if (precision == QUDA_SINGLE_PRECISION)
+          block_float_decode<float, int16_t>(static_cast<float *>(dst), payload, bytes / precision);
+        else
+          errorQuda("Block-float halo compression is not supported for precision %d", precision);
+        break;
+      default: errorQuda("Unknown halo compression mode %u", header.mode);
+      }
+
+      decompress_timer.stop(__func__, __FILE__, __LINE__);
+    }
+
+    void print_profile()
+    {
+      if (!init || !any_enabled) return;
+
+      double stats[5] = {static_cast<double>(raw_bytes), static_cast<double>(sent_bytes), compress_timer.time,
+                         decompress_timer.time, static_cast<double>(compress_timer.count)};
+      comm_allreduce_array(stats, 5);
+
+      if (getVerbosity() >= QUDA_SUMMARIZE && stats[1] > 0.0) {
+        printfQuda("\n   %20s Total time = %9.3f secs\n", "haloCompress", stats[2] + stats[3]);
+        printfQuda("     %20s     = %9.3f secs,\t with %8.0f calls\n", "compress", stats[2], stats[4]);
+        printfQuda("     %20s     = %9.3f secs\n", "decompress", stats[3]);
+        printfQuda("     %20s     = %9.3f (%.3e bytes -> %.3e bytes)\n", "compression ratio", stats[0] / stats[1],
+                   stats[0], stats[1]);
+      }
+    }
+
+  } // namespace halo_compress
+
+} // namespace quda
@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <future>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <timer.h>
+#include <ildg_io.h>
+
+namespace quda
+{
+
+  namespace ildg_io
+  {
+
+    constexpr uint32_t lime_magic = 0x456789ab;
+    constexpr size_t lime_header_bytes = 144;
+    constexpr int n_dim = 4;
+    constexpr int link_len = 18; // real numbers per link
+
+    /**
+       Description of the gauge field record of a LIME file, as
+       determined by rank 0
+     */
+    struct Info {
+      int32_t valid;
+      int32_t precision; // bytes per real number
+      int32_t dims[n_dim];
+      int64_t data_offset;
+      int64_t data_bytes;
+      int32_t has_checksum;
+      uint32_t suma;
+      uint32_t sumb;
+    };
+
+    static uint64_t read_big_endian(const unsigned char *p, int bytes)
+    {
+      uint64_t value = 0;
+      for (int i = 0; i < bytes; i++) value = (value << 8) | p[i];
+      return value;
+    }
+
+    /**
+       @brief Extract the contents of the first <tag>...</tag> element of an XML string
+     */
+    static bool xml_value(const std::string &xml, const std::string &tag, std::string &value)
+    {
+      size_t begin = xml.find("<" + tag + ">");
+      if (begin == std::string::npos) return false;
+      begin += tag.size() + 2;
+      size_t end = xml.find("</" + tag + ">", begin);
+      if (end == std::string::npos) return false;
+      value = xml.substr(begin, end - begin);
+      return true;
+    }
+
+    /**
+       @brief Walk the LIME records of a file and locate the gauge
+       field binary record, its lattice dimensions, precision and
+       checksum.  ILDG records take precedence over SciDAC ones.
+     */
+    static Info parse(const std::string &filename)
+    {
+      Info info = {};
+      FILE *fp = fopen(filename.c_str(), "rb");
+      if (!fp) return info;
+
+      int64_t ildg_offset = -1, ildg_bytes = 0, scidac_offset = -1, scidac_bytes = 0;
+      int ildg_prec = 0, scidac_prec = 0;
+      int ildg_dims[n_dim] = {}, scidac_dims[n_dim] = {};
+
+      unsigned char header[lime_header_bytes];
+      int64_t offset = 0;
+      while (fseek(fp, offset, SEEK_SET) == 0 && fread(header, sizeof(header), 1, fp) == 1) {
+        if (read_big_endian(header, 4) != lime_magic) break;
+        int64_t bytes = read_big_endian(header + 8, 8);
+        char type[129] = {};
+        memcpy(type, header + 16, 128);
+        int64_t data_offset = offset + lime_header_bytes;
+
+        std::string record_type(type);
+        auto read_xml = [&]() {
+          std::string xml(bytes, '\0');
+          if (fread(&xml[0], 1, bytes, fp) != static_cast<size_t>(bytes)) xml.clear();
+          return xml;
+        };
+
+        std::string value;
+        if (record_type == "ildg-format") {
+          std::string xml = read_xml();
+          if (xml_value(xml, "precision", value)) ildg_prec = atoi(value.c_str()) / 8;
+          const char *tags[n_dim] = {"lx", "ly", "lz", "lt"};
+          for (int d = 0; d < n_dim; d++)
+            if (xml_value(xml, tags[d], value)) ildg_dims[d] = atoi(value.c_str());
+        } else if (record_type == "ildg-binary-data") {
+          ildg_offset = data_offset;
+          ildg_bytes = bytes;
+        } else if (record_type == "scidac-private-file-xml") {
+          std::string xml = read_xml();
+          if (xml_value(xml, "dims", value))
+            sscanf(value.c_str(), "%d %d %d %d", &scidac_dims[0], &scidac_dims[1], &scidac_dims[2], &scidac_dims[3]);
+        } else if (record_type == "scidac-private-record-xml") {
+          std::string xml = read_xml();
+          if (xml_value(xml, "precision", value)) scidac_prec = value == "D" ? 8 : value == "F" ? 4 : 0;
+        } else if (record_type == "scidac-binary-data" && scidac_offset < 0) {
+          scidac_offset = data_offset;
+          scidac_bytes = bytes;
+        } else if (record_type == "scidac-checksum") {
+          std::string xml = read_xml();
+          std::string suma, sumb;
+          if (xml_value(xml, "suma", suma) && xml_value(xml, "sumb", sumb)) {
+            info.suma = strtoul(suma.c_str(), nullptr, 16);
+            info.sumb = strtoul(sumb.c_str(), nullptr, 16);
+            info.has_checksum = 1;
+          }
+        }
+
+        offset = data_offset + ((bytes + 7) / 8) * 8; // records are padded to a multiple of eight bytes
+      }
+      fclose(fp);
+
+      if (ildg_offset >= 0 && ildg_prec > 0) {
+        info.precision = ildg_prec;
+        for (int d = 0; d < n_dim; d++) info.dims[d] = ildg_dims[d];
+        info.data_offset = ildg_offset;
+        info.data_bytes = ildg_bytes;
+      } else if (scidac_offset >= 0 && scidac_prec > 0) {
+        info.precision = scidac_prec;
+        for (int d = 0; d < n_dim; d++) info.dims[d] = scidac_dims[d];
+        info.data_offset = scidac_offset;
+        info.data_bytes = scidac_bytes;
+      } else {
+        return info;
+      }
+
+      int64_t volume = 1;
+      for (int d = 0; d < n_dim; d++) volume *= info.dims[d];
+      info.valid = volume > 0 && info.data_bytes == volume * n_dim * link_len * info.precision;
+      return info;
+    }
+
+    static Info query(const std::string &filename)
+    {
+      Info info = {};
+      if (comm_rank() == 0) info = parse(filename);
+      comm_broadcast(&info, sizeof(info));
+      return info;
+    }
+
+    bool is_ildg(const std::string &filename) { return query(filename).valid; }
+
+    bool use_native_reader()
+    {
+      static bool init = false;
+      static bool native = true;
+
+      if (!init) {
+        char *reader_env = getenv("QUDA_IO_LIME_READER");
+        if (reader_env) {
+          if (strcmp(reader_env, "native") == 0) {
+            native = true;
+          } else if (strcmp(reader_env, "qio") == 0) {
+#ifndef HAVE_QIO
+            errorQuda("QUDA_IO_LIME_READER=qio requested but QIO library was not built");
+#endif
+            native = false;
+          } else {
+            errorQuda("Unknown QUDA_IO_LIME_READER=%s", reader_env);
+          }
+        }
+        init = true;
+      }
+      return native;
+    }
+
+    static size_t chunk_bytes()
+    {
+      static bool init = false;
+      static size_t bytes = 64 * 1024 * 1024;
+
+      if (!init) {
+        char *chunk_env = getenv("QUDA_IO_CHUNK_SIZE");
+        if (chunk_env) {
+          long chunk = atol(chunk_env);
+          if (chunk <= 0) errorQuda("Invalid QUDA_IO_CHUNK_SIZE=%s", chunk_env);
+          bytes = static_cast<size_t>(chunk) * 1024 * 1024;
+        }
+        init = true;
+      }
+      return bytes;
+    }
+
+    /**
+       @brief CRC-32 (IEEE 802.3, as used by zlib and the SciDAC checksum)
+     */
+    static uint32_t crc32(const unsigned char *data, size_t bytes)
+    {
+      static const auto table = []() {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; i++) {
+          uint32_t c = i;
+          for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+          t[i] = c;
+        }
+        return t;
+      }();
+
+      uint32_t crc = 0xffffffffu;
+      for (size_t i = 0; i < bytes; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+      return crc ^ 0xffffffffu;
+    }
+
+    static inline uint32_t rotate(uint32_t x, int n) { return n == 0 ? x : (x << n) | (x >> (32 - n)); }
+
+    template <typename Float> static inline Float load(const unsigned char *p)
+    {
+      using Bits = typename std::conditional<sizeof(Float) == 8, uint64_t, uint32_t>::type;
+      Bits bits = static_cast<Bits>(read_big_endian(p, sizeof(Float)));
+      Float value;
+      memcpy(&value, &bits, sizeof(Float));
+      return value;
+    }
+
+    /**
+       Describes the local sub-block owned by this rank
+     */
+    struct Layout {
+      int X[n_dim];
+      int G[n_dim];
+      int offset[n_dim];
+      size_t local_volume;
+
+      Layout(const int *X_, const int32_t *dims) : local_volume(1)
+      {
+        for (int d = 0; d < n_dim; d++) {
+          X[d] = X_[d];
+          G[d] = comm_dim(d) * X[d];
+          offset[d] = comm_coord(d) * X[d];
+          local_volume *= X[d];
+          if (G[d] != dims[d]) errorQuda("Global lattice dimension %d is %d, file has %d", d, G[d], dims[d]);
+        }
+      }
+    };
+
+    /**
+       @brief Checksum and convert the sites of a chunk in one pass.
+       The chunk holds n_site consecutive sites of the local lattice in
+       local lexicographic order, starting at local index first.
+     */
+    template <typename Float, typename fFloat>
+    static void process(void *gauge[], QudaGaugeFieldOrder order, const unsigned char *chunk, size_t first,
+                        size_t n_site, const Layout &layout, uint32_t &suma, uint32_t &sumb)
+    {
+      constexpr size_t site_bytes = n_dim * link_len * sizeof(fFloat);
+      uint32_t a = 0, b = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for reduction(^ : a, b)
+#endif
+      for (size_t s = 0; s < n_site; s++) {
+        size_t r = first + s;
+        size_t local = r;
+        size_t global = 0;
+        size_t stride = 1;
+        int parity = 0;
+        for (int d = 0; d < n_dim; d++) {
+          int x = local % layout.X[d] + layout.offset[d];
+          local /= layout.X[d];
+          global += x * stride;
+          stride *= layout.G[d];
+          parity += x;
+        }
+
+        const unsigned char *site = chunk + s * site_bytes;
+        uint32_t crc = crc32(site, site_bytes);
+        a ^= rotate(crc, global % 29);
+        b ^= rotate(crc, global % 31);
+
+        size_t index = parity & 1 ? (r + layout.local_volume) / 2 : r / 2;
+        for (int mu = 0; mu < n_dim; mu++) {
+          Float *link = order == QUDA_QDP_GAUGE_ORDER ? static_cast<Float *>(gauge[mu]) + index * link_len :
+                                                       static_cast<Float *>(gauge[0]) + (index * n_dim + mu) * link_len;
+          for (int j = 0; j < link_len; j++) link[j] = load<fFloat>(site + (mu * link_len + j) * sizeof(fFloat));
+        }
+      }
+
+      suma ^= a;
+      sumb ^= b;
+    }
+
+    void read_gauge_field(const std::string &filename, void *gauge[], QudaPrecision precision, const int *X,
+                          QudaGaugeFieldOrder order)
+    {
+      if (precision != QUDA_DOUBLE_PRECISION && precision != QUDA_SINGLE_PRECISION)
+        errorQuda("Unsupported precision %d", precision);
+      if (order != QUDA_QDP_GAUGE_ORDER && order != QUDA_MILC_GAUGE_ORDER) errorQuda("Unsupported gauge order %d", order);
+
+      host_timer_t timer;
+      timer.start();
+
+      Info info = query(filename);
+      if (!info.valid) errorQuda("%s is not a LIME file holding a gauge field", filename.c_str());
+      Layout layout(X, info.dims);
+      const size_t site_bytes = n_dim * link_len * info.precision;
+
+      // runs of sites that are contiguous in the file extend over each dimension until the first one that is partitioned
+      size_t run = 1;
+      for (int d = 0; d < n_dim; d++) {
+        run *= layout.X[d];
+        if (layout.X[d] != layout.G[d]) break;
+      }
+      const size_t n_run = layout.local_volume / run;
+      const size_t runs_per_chunk = std::max(static_cast<size_t>(1), std::min(n_run, chunk_bytes() / (run * site_bytes)));
+
+      int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) errorQuda("Failed to open %s", filename.c_str());
+
+      auto read_chunk = [&](unsigned char *buffer, size_t first_run) {
+        size_t last_run = std::min(n_run, first_run + runs_per_chunk);
+        for (size_t j = first_run; j < last_run; j++) {
+          size_t local = j * run;
+          size_t global = 0;
+          size_t stride = 1;
+          for (int d = 0; d < n_dim; d++) {
+            global += (local % layout.X[d] + layout.offset[d]) * stride;
+            local /= layout.X[d];
+            stride *= layout.G[d];
+          }
+          unsigned char *data = buffer + (j - first_run) * run * site_bytes;
+          size_t bytes = run * site_bytes;
+          off_t file_offset = info.data_offset + global * site_bytes;
+          while (bytes > 0) {
+            ssize_t n = pread(fd, data, bytes, file_offset);
+            if (n <= 0) errorQuda("Failed to read %s at offset %lld", filename.c_str(), static_cast<long long>(file_offset));
+            data += n;
+            bytes -= n;
+            file_offset += n;
+          }
+        }
+      };
+
+      // double buffer, so that the next chunk is read while the current one is processed
+      std::vector<unsigned char> buffer[2];
+      for (auto &b : buffer) b.resize(runs_per_chunk * run * site_bytes);
+      uint32_t suma = 0, sumb = 0;
+
+      read_chunk(buffer[0].data(), 0);
+      for (size_t first_run = 0, k = 0; first_run < n_run; first_run += runs_per_chunk, k ^= 1) {
+        std::future<void> next;
+        if (first_run + runs_per_chunk < n_run)
+          next = std::async(std::launch::async, read_chunk, buffer[k ^ 1].data(), first_run + runs_per_chunk);
+
+        size_t n_site = (std::min(n_run, first_run + runs_per_chunk) - first_run) * run;
+        if (precision == QUDA_DOUBLE_PRECISION && info.precision == 8)
+          process<double, double>(gauge, order, buffer[k].data(), first_run * run, n_site, layout, suma, sumb);
+        else if (precision == QUDA_DOUBLE_PRECISION && info.precision == 4)
+          process<double, float>(gauge, order, buffer[k].data(), first_run * run, n_site, layout, suma, sumb);
+        else if (precision == QUDA_SINGLE_PRECISION && info.precision == 8)
+          process<float, double>(gauge, order, buffer[k].data(), first_run * run, n_site, layout, suma, sumb);
+        else
+          process<float, float>(gauge, order, buffer[k].data(), first_run * run, n_site, layout, suma, sumb);
+
+        if (next.valid()) next.get();
+      }
+      close(fd);
+
+      uint64_t checksum = (static_cast<uint64_t>(suma) << 32) | sumb;
+      comm_allreduce_xor(&checksum);
+      suma = checksum >> 32;
+      sumb = checksum & 0xffffffffu;
+
+      if (info.has_checksum) {
+        if (suma != info.suma || sumb != info.sumb)
+          errorQuda("Checksum mismatch for %s: computed %x %x, expected %x %x", filename.c_str(), suma, sumb, info.suma,
+                    info.sumb);
+      } else {
+        warningQuda("%s has no SciDAC checksum record, computed %x %x", filename.c_str(), suma, sumb);
+      }
+
+      timer.stop();
+      size_t bytes = info.data_bytes;
+      if (getVerbosity() >= QUDA_SUMMARIZE)
+        printfQuda("Loaded %s: %.3f GiB in %.3f s (%.3f GiB/s), checksum %x %x%s\n", filename.c_str(),
+                   bytes / static_cast<double>(1 << 30), timer.last_interval,
+                   bytes / (timer.last_interval * (1 << 30)), suma, sumb, info.has_checksum ? " verified" : "");
+    }
+
+  } // namespace ildg_io
+
+} // namespace quda
@@ -11,6 +11,7 @@
 #include <device.h>
 #include <timer.h>
 #include <comm_quda.h>
+#include <communicator_quda.h>
 #include <tune_quda.h>
 #include <blas_quda.h>
 #include <gauge_field.h>
@@ -61,6 +62,9 @@ void checkBLASParam(QudaBLASParam &param) { checkBLASParam(&param); }
 #include <gauge_tools.h>
 #include <contract_quda.h>
 #include <momentum.h>
+#include <halo_compress.h>
+#include <field_io.h>
+#include <vector_io.h>
 
 using namespace quda;
 
@@ -393,6 +397,23 @@ void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata
 }
 
 
+void initCommsGridTopologyQuda(int nDim, const int *dims, const int *local_dims)
+{
+  if (comms_initialized) return;
+
+  if (nDim != 4) { errorQuda("Number of communication grid dimensions must be 4"); }
+
+  // the rank table is filled during communicator initialization, once the hostnames are known
+  static TopologyMapData map_data;
+  map_data.ndim = nDim;
+  for (int i = 0; i < nDim; i++) {
+    map_data.dims[i] = dims[i];
+    map_data.local_dims[i] = local_dims ? local_dims[i] : 0;
+  }
+
+  initCommsGridQuda(nDim, dims, comm_topology_rank_from_coords, &map_data);
+}
+
 static void init_default_comms()
 {
 #if defined(QMP_COMMS)
@@ -1381,6 +1402,152 @@ void flushChronoQuda(int i)
   basis.clear();
 }
 
+/**
+   @brief Metadata record of a saved chronological basis, written by
+   rank 0 once the basis vectors, which are stored in a native vector
+   file, are complete.  Lattice dimensions are global, so that a
+   basis may be restored on a different process grid.
+*/
+struct ChronoHeader {
+  char magic[8];
+  int version;
+  int n_vec;
+  int precision;
+  int n_dim;
+  int x[QUDA_MAX_DIM];
+  int n_color;
+  int n_spin;
+  int site_subset;
+  int site_order;
+  int gamma_basis;
+  int pc_type;
+  int twist_flavor;
+  int suggested_parity;
+};
+
+static constexpr char chrono_magic[8] = "QUDACHR";
+static constexpr int chrono_version = 1;
+
+void saveChronoQuda(int i, const char *filename)
+{
+  if (!initialized) errorQuda("QUDA not initialized");
+  if (i < 0 || i >= QUDA_MAX_CHRONO) errorQuda("Requested chrono index %d is outside of max %d\n", i, QUDA_MAX_CHRONO);
+  if (!filename || strlen(filename) == 0) errorQuda("No chrono basis file defined");
+
+  auto &basis = chronoResident[i];
+  if (basis.size() == 0) {
+    warningQuda("Chrono basis %d is empty, nothing saved to %s", i, filename);
+    return;
+  }
+
+  const ColorSpinorField &v = *basis[0];
+  ChronoHeader header = {};
+  memcpy(header.magic, chrono_magic, sizeof(header.magic));
+  header.version = chrono_version;
+  header.n_vec = basis.size();
+  header.precision = v.Precision();
+  header.n_dim = v.Ndim();
+  for (int d = 0; d < v.Ndim(); d++) header.x[d] = v.X(d) * (d < 4 ? comm_dim(d) : 1);
+  header.n_color = v.Ncolor();
+  header.n_spin = v.Nspin();
+  header.site_subset = v.SiteSubset();
+  header.site_order = v.SiteOrder();
+  header.gamma_basis = v.GammaBasis();
+  header.pc_type = v.PCType();
+  header.twist_flavor = v.TwistFlavor();
+  header.suggested_parity = v.SuggestedParity();
+
+  // remove any previous metadata first, so that a stale header never describes a partially written basis
+  const std::string file(filename);
+  if (comm_rank() == 0) remove(file.c_str());
+  comm_barrier();
+
+  VectorIO io(file + "_vecs", false, true);
+  io.save(basis);
+  native_io::wait();
+
+  // the metadata is written last to a temporary file and renamed, so that its presence marks the basis as complete
+  if (comm_rank() == 0) {
+    std::string tmp_file = file + ".tmp";
+    FILE *fp = fopen(tmp_file.c_str(), "wb");
+    if (!fp) errorQuda("Unable to open %s for writing", tmp_file.c_str());
+    if (fwrite(&header, sizeof(header), 1, fp) != 1) errorQuda("Failed to write %s", tmp_file.c_str());
+    fclose(fp);
+    if (rename(tmp_file.c_str(), file.c_str()) != 0)
+      errorQuda("Unable to rename %s to %s", tmp_file.c_str(), filename);
+  }
+  comm_barrier();
+
+  if (getVerbosity() >= QUDA_SUMMARIZE)
+    printfQuda("Saved chrono basis %d (%d vectors, precision %d) to %s\n", i, header.n_vec, header.precision, filename);
+}
+
+void loadChronoQuda(int i, const char *filename)
+{
+  if (!initialized) errorQuda("QUDA not initialized");
+  if (i < 0 || i >= QUDA_MAX_CHRONO) errorQuda("Requested chrono index %d is outside of max %d\n", i, QUDA_MAX_CHRONO);
+  if (!filename || strlen(filename) == 0) errorQuda("No chrono basis file defined");
+
+  ChronoHeader header = {};
+  int status = 0;
+  if (comm_rank() == 0) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+      status = 1;
+    } else {
+      if (fread(&header, sizeof(header), 1, fp) != 1) status = 2;
+      fclose(fp);
+    }
+  }
+  comm_broadcast(&status, sizeof(status));
+  if (status == 1) errorQuda("Unable to open %s", filename);
+  if (status == 2) errorQuda("Failed to read %s", filename);
+  comm_broadcast(&header, sizeof(header));
+
+  if (memcmp(header.magic, chrono_magic, sizeof(header.magic)) != 0)
+    errorQuda("%s is not a chrono basis file", filename);
+  if (header.version != chrono_version)
+    errorQuda("Unsupported chrono basis version %d in %s (expected %d)", header.version, filename, chrono_version);
+  if (header.n_vec < 1) errorQuda("Invalid chrono basis size %d in %s", header.n_vec, filename);
+  if (header.n_dim != 4 && header.n_dim != 5) errorQuda("Unexpected field dimension %d in %s", header.n_dim, filename);
+
+  ColorSpinorParam cs_param;
+  cs_param.location = QUDA_CUDA_FIELD_LOCATION;
+  cs_param.create = QUDA_NULL_FIELD_CREATE;
+  cs_param.nColor = header.n_color;
+  cs_param.nSpin = header.n_spin;
+  cs_param.nDim = header.n_dim;
+  for (int d = 0; d < header.n_dim; d++) {
+    int n = d < 4 ? comm_dim(d) : 1;
+    if (header.x[d] % n != 0)
+      errorQuda("Global dimension %d = %d of %s is not divisible by the process grid %d", d, header.x[d], filename, n);
+    cs_param.x[d] = header.x[d] / n;
+  }
+  cs_param.siteSubset = static_cast<QudaSiteSubset>(header.site_subset);
+  cs_param.siteOrder = static_cast<QudaSiteOrder>(header.site_order);
+  cs_param.gammaBasis = static_cast<QudaGammaBasis>(header.gamma_basis);
+  cs_param.pc_type = static_cast<QudaPCType>(header.pc_type);
+  cs_param.twistFlavor = static_cast<QudaTwistFlavorType>(header.twist_flavor);
+  cs_param.suggested_parity = static_cast<QudaParity>(header.suggested_parity);
+  cs_param.setPrecision(static_cast<QudaPrecision>(header.precision), QUDA_INVALID_PRECISION, true);
+
+  flushChronoQuda(i);
+  auto &basis = chronoResident[i];
+  for (int j = 0; j < header.n_vec; j++) basis.emplace_back(ColorSpinorField::Create(cs_param));
+
+  VectorIO io(std::string(filename) + "_vecs", false, true);
+  io.load(basis);
+
+  if (getVerbosity() >= QUDA_SUMMARIZE)
+    printfQuda("Loaded chrono basis %d (%d vectors, precision %d) from %s\n", i, header.n_vec, header.precision, filename);
+}
+
+void waitForIOQuda(void)
+{
+  if (!comms_initialized) return;
+  native_io::wait();
+}
+
 void endQuda(void)
 {
   profileEnd.TPSTART(QUDA_PROFILE_TOTAL);
@@ -1399,6 +1566,7 @@ void endQuda(void)
 
   LatticeField::freeGhostBuffer();
   ColorSpinorField::freeGhostBuffer();
+  split_grid::destroy();
 
   blas_lapack::generic::destroy();
   blas_lapack::native::destroy();
@@ -1419,6 +1587,12 @@ void endQuda(void)
   // flush any outstanding force monitoring (if enabled)
   flushForceMonitor();
 
+  // report halo compression statistics (if enabled), requires comms so must precede comm_finalize
+  halo_compress::print_profile();
+
+  // complete any asynchronous saves, requires comms so must precede comm_finalize
+  waitForIOQuda();
+
   initialized = false;
 
   comm_finalize();
@@ -2381,6 +2555,107 @@ void eigensolveQuda(void **host_evecs, double _Complex *host_evals, QudaEigParam
   profileEigensolve.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
+/**
+   @brief Return the file prefix of the persisted multigrid hierarchy,
+   set with QUDA_MG_HIERARCHY=prefix, or an empty string if disabled.
+   The prefix is extended with a key formed from the checksum of the
+   fine gauge field and the parameters that determine the hierarchy,
+   so that a hierarchy is only reloaded for the configuration and
+   setup it was built with.
+*/
+static std::string mgHierarchyFile(const QudaMultigridParam &mg_param, const cudaGaugeField &gauge)
+{
+  char *prefix = getenv("QUDA_MG_HIERARCHY");
+  if (!prefix || strlen(prefix) == 0) return "";
+
+  // Checksum already reduces over all ranks, so the key is identical on every rank
+  uint64_t key = Checksum(gauge);
+  if (mg_param.invert_param->dslash_type == QUDA_ASQTAD_DSLASH && gaugeLongPrecise)
+    key ^= Checksum(*gaugeLongPrecise) * 0x9e3779b97f4a7c15ull;
+
+  // FNV-1a hash of the parameters that determine the hierarchy
+  auto hash = [&key](const void *data, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+      key ^= static_cast<const unsigned char *>(data)[i];
+      key *= 0x100000001b3ull;
+    }
+  };
+
+  const QudaInvertParam &inv = *mg_param.invert_param;
+  hash(&inv.dslash_type, sizeof(inv.dslash_type));
+  hash(&inv.kappa, sizeof(inv.kappa));
+  hash(&inv.mass, sizeof(inv.mass));
+  hash(&inv.mu, sizeof(inv.mu));
+  hash(&inv.epsilon, sizeof(inv.epsilon));
+  hash(&inv.m5, sizeof(inv.m5));
+  hash(&inv.Ls, sizeof(inv.Ls));
+  hash(&inv.clover_coeff, sizeof(inv.clover_coeff));
+  hash(&inv.clover_csw, sizeof(inv.clover_csw));
+  hash(&inv.twist_flavor, sizeof(inv.twist_flavor));
+  hash(&inv.matpc_type, sizeof(inv.matpc_type));
+  hash(&inv.cuda_prec_precondition, sizeof(inv.cuda_prec_precondition));
+
+  hash(&mg_param.n_level, sizeof(mg_param.n_level));
+  hash(mg_param.n_vec, sizeof(mg_param.n_vec));
+  hash(mg_param.geo_block_size, sizeof(mg_param.geo_block_size));
+  hash(mg_param.spin_block_size, sizeof(mg_param.spin_block_size));
+  hash(mg_param.n_block_ortho, sizeof(mg_param.n_block_ortho));
+  hash(mg_param.block_ortho_two_pass, sizeof(mg_param.block_ortho_two_pass));
+  hash(mg_param.precision_null, sizeof(mg_param.precision_null));
+  hash(mg_param.transfer_type, sizeof(mg_param.transfer_type));
+  hash(mg_param.mu_factor, sizeof(mg_param.mu_factor));
+  hash(mg_param.setup_location, sizeof(mg_param.setup_location));
+  hash(mg_param.smoother_solve_type, sizeof(mg_param.smoother_solve_type));
+  hash(mg_param.coarse_grid_solution_type, sizeof(mg_param.coarse_grid_solution_type));
+  hash(mg_param.num_setup_iter, sizeof(mg_param.num_setup_iter));
+  hash(mg_param.setup_maxiter, sizeof(mg_param.setup_maxiter));
+  hash(mg_param.setup_tol, sizeof(mg_param.setup_tol));
+  hash(mg_param.use_eig_solver, sizeof(mg_param.use_eig_solver));
+  hash(&mg_param.compute_null_vector, sizeof(mg_param.compute_null_vector));
+  hash(&mg_param.generate_all_levels, sizeof(mg_param.generate_all_levels));
+  hash(&mg_param.staggered_kd_dagger_approximation, sizeof(mg_param.staggered_kd_dagger_approximation));
+
+  char key_str[17];
+  snprintf(key_str, sizeof(key_str), "%016lx", static_cast<unsigned long>(key));
+  return std::string(prefix) + "_" + key_str;
+}
+
+/**
+   @brief Return whether a complete persisted hierarchy exists, that
+   is whether its manifest was written after saving every level
+*/
+static bool mgHierarchyExists(const std::string &file)
+{
+  int exists = 0;
+  if (comm_rank() == 0) {
+    FILE *fp = fopen((file + "_complete").c_str(), "r");
+    if (fp) {
+      exists = 1;
+      fclose(fp);
+    }
+  }
+  comm_broadcast(&exists, sizeof(exists));
+  return exists;
+}
+
+/**
+   @brief Save the hierarchy of an MG instance, and write the manifest
+   that marks it as complete once every level has been written
+*/
+static void mgHierarchySave(const MG &mg, const std::string &file)
+{
+  if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Saving multigrid hierarchy to %s\n", file.c_str());
+  mg.saveHierarchy(file);
+  native_io::wait();
+  if (comm_rank() == 0) {
+    FILE *fp = fopen((file + "_complete").c_str(), "w");
+    if (!fp) errorQuda("Unable to write %s_complete", file.c_str());
+    fprintf(fp, "%s\n", file.c_str());
+    fclose(fp);
+  }
+  comm_barrier();
+}
+
 multigrid_solver::multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &profile)
   : profile(profile) {
   profile.TPSTART(QUDA_PROFILE_INIT);
@@ -2456,10 +2731,18 @@ multigrid_solver::multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &pr
 
   // fill out the MG parameters for the fine level
   mgParam = new MGParam(mg_param, B, m, mSmooth, mSmoothSloppy);
+  mgParam->hierarchy_file = mgHierarchyFile(mg_param, *cudaGauge);
+  if (mgParam->hierarchy_file.size() > 0) {
+    mgParam->hierarchy_load = mgHierarchyExists(mgParam->hierarchy_file);
+    if (mgParam->hierarchy_load && getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Loading multigrid hierarchy from %s\n", mgParam->hierarchy_file.c_str());
+  }
 
   mg = new MG(*mgParam, profile);
   mgParam->updateInvertParam(*param);
 
+  if (mgParam->hierarchy_file.size() > 0 && !mgParam->hierarchy_load) mgHierarchySave(*mg, mgParam->hierarchy_file);
+
   // cache is written out even if a long benchmarking job gets interrupted
   saveTuneCache();
   profile.TPSTOP(QUDA_PROFILE_INIT);
@@ -2608,9 +2891,11 @@ void dumpMultigridQuda(void *mg_, QudaMultigridParam *mg_param)
 
   auto *mg = static_cast<multigrid_solver*>(mg_);
   checkMultigridParam(mg_param);
-  checkGauge(mg_param->invert_param);
 
   mg->mg->dumpNullVectors();
+  // the gauge field may have changed since the hierarchy was created, so recompute the key
+  std::string hierarchy_file = mgHierarchyFile(*mg_param, *checkGauge(mg_param->invert_param));
+  if (hierarchy_file.size() > 0) mgHierarchySave(*mg->mg, hierarchy_file);
 
   profileInvert.TPSTOP(QUDA_PROFILE_TOTAL);
   popVerbosity();
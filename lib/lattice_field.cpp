@@ -4,6 +4,7 @@
 #include <color_spinor_field.h>
 #include <gauge_field.h>
 #include <clover_field.h>
+#include <halo_compress.h>
 
 namespace quda {
 
@@ -28,6 +29,9 @@ namespace quda {
   void *LatticeField::ghost_pinned_recv_buffer_h[2] = {nullptr, nullptr};
   void *LatticeField::ghost_pinned_recv_buffer_hd[2] = {nullptr, nullptr};
 
+  void *LatticeField::ghost_compress_send_buffer_h[2] = {nullptr, nullptr};
+  void *LatticeField::ghost_compress_recv_buffer_h[2] = {nullptr, nullptr};
+
   // gpu ghost receive buffer
   void *LatticeField::ghost_recv_buffer_d[2] = {nullptr, nullptr};
 
@@ -79,6 +83,7 @@ namespace quda {
     from_face_h {},
     from_face_hd {},
     from_face_d {},
+    ghost_compress(false),
     initComms(false),
     mem_type(param.mem_type),
     backup_h(nullptr),
@@ -98,6 +103,9 @@ namespace quda {
           from_face_dim_dir_d[b][dim][dir] = nullptr;
           from_face_dim_dir_hd[b][dim][dir] = nullptr;
           from_face_dim_dir_h[b][dim][dir] = nullptr;
+
+          my_face_compress_dim_dir_h[b][dim][dir] = nullptr;
+          from_face_compress_dim_dir_h[b][dim][dir] = nullptr;
         }
 
         mh_recv_fwd[dir][dim] = nullptr;
@@ -109,8 +117,15 @@ namespace quda {
         mh_recv_rdma_back[dir][dim] = nullptr;
         mh_send_rdma_fwd[dir][dim] = nullptr;
         mh_send_rdma_back[dir][dim] = nullptr;
+
+        mh_recv_compress_fwd[dir][dim] = nullptr;
+        mh_recv_compress_back[dir][dim] = nullptr;
+        mh_send_compress_fwd[dir][dim] = nullptr;
+        mh_send_compress_back[dir][dim] = nullptr;
+        for (int d = 0; d < 2; d++) send_compress_active[dir][dim][d] = false;
       }
     }
+    for (int b = 0; b < 2; b++) mh_neighbor[b] = nullptr;
 
     for (int i=0; i<nDim; i++) {
       x[i] = param.x[i];
@@ -181,6 +196,7 @@ namespace quda {
     from_face_h {},
     from_face_hd {},
     from_face_d {},
+    ghost_compress(false),
     initComms(false),
     mem_type(field.mem_type),
     backup_h(nullptr),
@@ -200,6 +216,9 @@ namespace quda {
           from_face_dim_dir_d[b][dim][dir] = nullptr;
           from_face_dim_dir_hd[b][dim][dir] = nullptr;
           from_face_dim_dir_h[b][dim][dir] = nullptr;
+
+          my_face_compress_dim_dir_h[b][dim][dir] = nullptr;
+          from_face_compress_dim_dir_h[b][dim][dir] = nullptr;
         }
 
         mh_recv_fwd[dir][dim] = nullptr;
@@ -211,8 +230,15 @@ namespace quda {
         mh_recv_rdma_back[dir][dim] = nullptr;
         mh_send_rdma_fwd[dir][dim] = nullptr;
         mh_send_rdma_back[dir][dim] = nullptr;
+
+        mh_recv_compress_fwd[dir][dim] = nullptr;
+        mh_recv_compress_back[dir][dim] = nullptr;
+        mh_send_compress_fwd[dir][dim] = nullptr;
+        mh_send_compress_back[dir][dim] = nullptr;
+        for (int d = 0; d < 2; d++) send_compress_active[dir][dim][d] = false;
       }
     }
+    for (int b = 0; b < 2; b++) mh_neighbor[b] = nullptr;
 
     for (int i=0; i<nDim; i++) {
       x[i] = field.x[i];
@@ -246,6 +272,10 @@ namespace quda {
             device_comms_pinned_free(ghost_send_buffer_d[b]);
             host_free(ghost_pinned_send_buffer_h[b]);
             host_free(ghost_pinned_recv_buffer_h[b]);
+            if (ghost_compress_send_buffer_h[b]) host_free(ghost_compress_send_buffer_h[b]);
+            if (ghost_compress_recv_buffer_h[b]) host_free(ghost_compress_recv_buffer_h[b]);
+            ghost_compress_send_buffer_h[b] = nullptr;
+            ghost_compress_recv_buffer_h[b] = nullptr;
           }
         }
       }
@@ -273,6 +303,13 @@ namespace quda {
 
           // set the matching device-mapped pointer
           ghost_pinned_recv_buffer_hd[b] = get_mapped_device_pointer(ghost_pinned_recv_buffer_h[b]);
+
+          // pinned buffers used for compressed halos, with room for a header per face
+          if (halo_compress::enabled()) {
+            size_t compress_bytes = ghost_bytes + 2 * QUDA_MAX_DIM * halo_compress::header_bytes();
+            ghost_compress_send_buffer_h[b] = pinned_malloc(compress_bytes);
+            ghost_compress_recv_buffer_h[b] = pinned_malloc(compress_bytes);
+          }
         }
 
         initGhostFaceBuffer = true;
@@ -309,6 +346,12 @@ namespace quda {
       ghost_pinned_recv_buffer_hd[b] = nullptr;
       ghost_pinned_send_buffer_h[b] = nullptr;
       ghost_pinned_send_buffer_hd[b] = nullptr;
+
+      // free compressed halo buffers
+      if (ghost_compress_send_buffer_h[b]) host_free(ghost_compress_send_buffer_h[b]);
+      if (ghost_compress_recv_buffer_h[b]) host_free(ghost_compress_recv_buffer_h[b]);
+      ghost_compress_send_buffer_h[b] = nullptr;
+      ghost_compress_recv_buffer_h[b] = nullptr;
     }
     initGhostFaceBuffer = false;
   }
@@ -347,6 +390,12 @@ namespace quda {
 
           my_face_dim_dir_d[b][i][dir] = static_cast<char *>(my_face_d[b]) + ghost_offset[i][dir];
           from_face_dim_dir_d[b][i][dir] = static_cast<char *>(from_face_d[b]) + ghost_offset[i][dir];
+
+          if (ghost_compress) { // each compressed face is offset by the headers of the preceding faces
+            size_t offset = ghost_offset[i][dir] + (2 * i + dir) * halo_compress::header_bytes();
+            my_face_compress_dim_dir_h[b][i][dir] = static_cast<char *>(ghost_compress_send_buffer_h[b]) + offset;
+            from_face_compress_dim_dir_h[b][i][dir] = static_cast<char *>(ghost_compress_recv_buffer_h[b]) + offset;
+          }
         } // loop over b
       }   // loop over direction
     } // loop over dimension
@@ -369,10 +418,35 @@ namespace quda {
 
 	mh_recv_rdma_fwd[b][i] = gdr ? comm_declare_receive_relative(from_face_dim_dir_d[b][i][1], i, +1, ghost_face_bytes[i]) : nullptr;
 	mh_recv_rdma_back[b][i] = gdr ? comm_declare_receive_relative(from_face_dim_dir_d[b][i][0], i, -1, ghost_face_bytes[i]) : nullptr;
+
+        // compressed messages are declared with the maximum size, and the sends are resized per message
+        size_t compress_bytes = halo_compress::bound(ghost_face_bytes[i]);
+        mh_send_compress_fwd[b][i] = ghost_compress ?
+          comm_declare_send_relative(my_face_compress_dim_dir_h[b][i][1], i, +1, compress_bytes) :
+          nullptr;
+        mh_send_compress_back[b][i] = ghost_compress ?
+          comm_declare_send_relative(my_face_compress_dim_dir_h[b][i][0], i, -1, compress_bytes) :
+          nullptr;
+        mh_recv_compress_fwd[b][i] = ghost_compress ?
+          comm_declare_receive_relative(from_face_compress_dim_dir_h[b][i][1], i, +1, compress_bytes) :
+          nullptr;
+        mh_recv_compress_back[b][i] = ghost_compress ?
+          comm_declare_receive_relative(from_face_compress_dim_dir_h[b][i][0], i, -1, compress_bytes) :
+          nullptr;
       } // loop over b
 
     } // loop over dimension
 
+    if (comm_neighbor_exchange_enabled() && comm_partitioned()) {
+      size_t offset[QUDA_MAX_DIM][2] = {};
+      size_t bytes[QUDA_MAX_DIM] = {};
+      for (int i = 0; i < nDimComms; i++) { // the communicator selects the partitioned dimensions
+        for (int dir = 0; dir < 2; dir++) offset[i][dir] = ghost_offset[i][dir];
+        bytes[i] = ghost_face_bytes[i];
+      }
+      for (int b = 0; b < 2; ++b) mh_neighbor[b] = comm_declare_neighbor_exchange(my_face_h[b], from_face_h[b], offset, bytes);
+    }
+
     initComms = true;
   }
 
@@ -396,7 +470,18 @@ namespace quda {
           if (mh_recv_rdma_back[b][i]) comm_free(mh_recv_rdma_back[b][i]);
           if (mh_send_rdma_fwd[b][i]) comm_free(mh_send_rdma_fwd[b][i]);
           if (mh_send_rdma_back[b][i]) comm_free(mh_send_rdma_back[b][i]);
+
+          if (mh_recv_compress_fwd[b][i]) comm_free(mh_recv_compress_fwd[b][i]);
+          if (mh_recv_compress_back[b][i]) comm_free(mh_recv_compress_back[b][i]);
+          for (int dir = 0; dir < 2; dir++) { // retire any compressed send that was not waited on
+            MsgHandle *mh = dir == 0 ? mh_send_compress_back[b][i] : mh_send_compress_fwd[b][i];
+            if (send_compress_active[b][i][dir]) comm_wait(mh);
+            send_compress_active[b][i][dir] = false;
+          }
+          if (mh_send_compress_fwd[b][i]) comm_free(mh_send_compress_fwd[b][i]);
+          if (mh_send_compress_back[b][i]) comm_free(mh_send_compress_back[b][i]);
         }
+        if (mh_neighbor[b]) comm_free(mh_neighbor[b]);
       } // loop over b
 
       // local take down complete - now synchronize to ensure globally complete
@@ -7,6 +7,8 @@
 
 // for int max
 #include <limits>
+#include <vector>
+#include <cstdint>
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -29,6 +31,85 @@ static size_t sites_on_node;
 static int *mcoord = nullptr;
 static bool single_parity = false;
 
+/* Lookup tables built by quda_setup_layout, so that the per-site
+   layout queries made by QIO need no divisions, modulos or QMP calls */
+static std::vector<std::vector<int>> node_coord;     /* [d][x] logical node coordinate of global coordinate x */
+static std::vector<std::vector<size_t>> site_offset; /* [d][x] lexicographic offset of x within its node */
+static std::vector<int> node_table;                  /* node number of each lexicographic node coordinate */
+static std::vector<size_t> node_stride;              /* lexicographic stride of each node grid dimension */
+static std::vector<int> node_origin;                 /* [node * ndim + d] first global coordinate of each node */
+static std::vector<uint64_t> site_coords; /* packed local coordinates of each site index on this node */
+
+static constexpr int coord_bits = 16;
+static constexpr uint64_t coord_mask = (static_cast<uint64_t>(1) << coord_bits) - 1;
+
+static void setup_tables(const int len[])
+{
+  node_coord.assign(ndim, std::vector<int>());
+  site_offset.assign(ndim, std::vector<size_t>());
+  node_stride.assign(ndim, 1);
+
+  size_t site_stride = 1;
+  size_t n_nodes = 1;
+  for (int d = 0; d < ndim; d++) {
+    node_coord[d].resize(len[d]);
+    site_offset[d].resize(len[d]);
+    for (int x = 0; x < len[d]; x++) {
+      node_coord[d][x] = x / squaresize[d];
+      site_offset[d][x] = (x % squaresize[d]) * site_stride;
+    }
+    site_stride *= squaresize[d];
+    node_stride[d] = n_nodes;
+    n_nodes *= nsquares[d];
+  }
+
+  // map each node grid coordinate to its node number, and each node to its origin
+  node_table.resize(n_nodes);
+  node_origin.resize(n_nodes * ndim);
+  for (size_t n = 0; n < n_nodes; n++) {
+    size_t rem = n;
+    for (int d = 0; d < ndim; d++) {
+      mcoord[d] = rem % nsquares[d];
+      rem /= nsquares[d];
+    }
+    node_table[n] = QMP_get_node_number_from(mcoord);
+  }
+  for (size_t n = 0; n < n_nodes; n++) {
+    int *m = QMP_get_logical_coordinates_from(static_cast<int>(n));
+    for (int d = 0; d < ndim; d++) node_origin[n * ndim + d] = m[d] * squaresize[d];
+    free(m);
+  }
+
+  // invert the site index of this node with a single incremental pass over its sites
+  site_coords.clear();
+  bool packable = ndim * coord_bits <= 64;
+  for (int d = 0; d < ndim; d++) packable = packable && static_cast<uint64_t>(squaresize[d]) <= coord_mask + 1;
+  if (!packable) return;
+
+  site_coords.resize(sites_on_node);
+  const int *origin = &node_origin[quda_this_node * ndim];
+  int origin_parity = 0;
+  for (int d = 0; d < ndim; d++) origin_parity += origin[d];
+
+  std::vector<int> x(ndim, 0);
+  int parity = origin_parity & 1;
+  for (size_t r = 0; r < sites_on_node; r++) {
+    uint64_t packed = 0;
+    for (int d = 0; d < ndim; d++) packed |= static_cast<uint64_t>(x[d]) << (d * coord_bits);
+    size_t index = single_parity ? r : (parity == 0 ? r / 2 : (r + sites_on_node) / 2);
+    site_coords[index] = packed;
+
+    for (int d = 0; d < ndim; d++) {
+      parity ^= 1;
+      if (++x[d] < squaresize[d]) break;
+      // the coordinate wraps back to zero, undoing its contribution to the parity
+      parity ^= (squaresize[d] - 1) & 1;
+      parity ^= 1;
+      x[d] = 0;
+    }
+  }
+}
+
 int quda_setup_layout(int len[], int nd, int, int single_parity_)
 {
   ndim = nd;
@@ -73,13 +154,16 @@ int quda_setup_layout(int len[], int nd, int, int single_parity_)
     size2[i] = size1[0][i] + size1[1][i];
     // printf("%s %i\t%i\t%i\n", __func__, size1[0][i], size1[1][i], size2[i]);
   }
+
+  setup_tables(len);
   return 0;
 }
 
 int quda_node_number(const int x[])
 {
-  for (int i = 0; i < ndim; i++) { mcoord[i] = x[i] / squaresize[i]; }
-  return QMP_get_node_number_from(mcoord);
+  size_t n = 0;
+  for (int i = 0; i < ndim; i++) n += node_coord[i][x[i]] * node_stride[i];
+  return node_table[n];
 }
 
 #ifdef QIO_HAS_EXTENDED_LAYOUT
@@ -94,8 +178,8 @@ size_t quda_node_index_helper(const int x[])
 {
   size_t r = 0, p = 0;
 
-  for (int i = ndim - 1; i >= 0; --i) {
-    r = r * squaresize[i] + (x[i] % squaresize[i]);
+  for (int i = 0; i < ndim; i++) {
+    r += site_offset[i][x[i]];
     p += x[i];
   }
 
@@ -129,12 +213,18 @@ int quda_node_index(const int x[])
 
 void quda_get_coords_helper(int x[], int node, size_t index)
 {
-  size_t si = index;
-  int *m = QMP_get_logical_coordinates_from(node);
+  const int *origin = &node_origin[node * ndim];
+
+  if (node == quda_this_node && !site_coords.empty()) {
+    uint64_t packed = site_coords[index];
+    for (int i = 0; i < ndim; i++) x[i] = origin[i] + static_cast<int>((packed >> (i * coord_bits)) & coord_mask);
+    return;
+  }
 
+  size_t si = index;
   size_t s = 0;
   for (int i = 0; i < ndim; ++i) {
-    x[i] = m[i] * squaresize[i];
+    x[i] = origin[i];
     s += x[i];
   }
 
@@ -165,8 +255,6 @@ void quda_get_coords_helper(int x[], int node, size_t index)
     x[0] += index;
   }
 
-  free(m);
-
   /* Check the result */
 #ifdef QIO_HAS_EXTENDED_LAYOUT
   size_t node_index = quda_node_index_ext(x, NULL);
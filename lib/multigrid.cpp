@@ -83,7 +83,10 @@ namespace quda
 
     if (param.transfer_type == QUDA_TRANSFER_AGGREGATE) {
       if (param.level < param.Nlevel - 1) {
-        if (param.mg_global.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_YES) {
+        if (param.hierarchy_load) {
+          VectorIO io(hierarchyFile(param.hierarchy_file, "B"));
+          io.load(param.B);
+        } else if (param.mg_global.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_YES) {
           if (param.mg_global.generate_all_levels == QUDA_BOOLEAN_TRUE || param.level == 0) {
 
             // Initializing to random vectors
@@ -117,6 +120,9 @@ namespace quda
     // in case of iterative setup with MG the coarse level may be already built
     if (!transfer) reset();
 
+    // subsequent resets must rebuild from the updated operators
+    param.hierarchy_load = false;
+
     popLevel();
   }
 
@@ -157,7 +163,8 @@ namespace quda
         if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating transfer operator\n");
         transfer = new Transfer(param.B, param.Nvec, param.NblockOrtho, param.blockOrthoTwoPass, param.geoBlockSize,
                                 param.spinBlockSize, param.mg_global.precision_null[param.level],
-                                param.mg_global.transfer_type[param.level], profile);
+                                param.mg_global.transfer_type[param.level], profile,
+                                param.hierarchy_load ? hierarchyFile(param.hierarchy_file, "V") : "");
         for (int i=0; i<QUDA_MAX_MG_LEVEL; i++) param.mg_global.geo_block_size[param.level][i] = param.geoBlockSize[i];
 
         // create coarse temporary vector if not already created in verify()
@@ -421,8 +428,13 @@ namespace quda
         fine_gauge = const_cast<cudaGaugeField *>(
           reinterpret_cast<const DiracImprovedStaggered *>(diracSmoother)->getFatLinkField());
 
-      xInvKD = AllocateAndBuildStaggeredKahlerDiracInverse(
-        *fine_gauge, diracSmoother->Mass(), param.mg_global.staggered_kd_dagger_approximation == QUDA_BOOLEAN_TRUE);
+      if (param.hierarchy_load) {
+        xInvKD = AllocateStaggeredKahlerDiracInverse(*fine_gauge);
+        loadGaugeField(hierarchyFile(param.hierarchy_file, "XinvKD"), *xInvKD);
+      } else {
+        xInvKD = AllocateAndBuildStaggeredKahlerDiracInverse(
+          *fine_gauge, diracSmoother->Mass(), param.mg_global.staggered_kd_dagger_approximation == QUDA_BOOLEAN_TRUE);
+      }
 
       DiracParam diracParamKD;
       diracParamKD.kappa
@@ -505,7 +517,8 @@ namespace quda
       diracParam.allow_truncation = (param.mg_global.allow_truncation == QUDA_BOOLEAN_TRUE) ? true : false;
 
       diracCoarseResidual = new DiracCoarse(diracParam, param.setup_location == QUDA_CUDA_FIELD_LOCATION ? true : false,
-                                            param.mg_global.setup_minimize_memory == QUDA_BOOLEAN_TRUE ? true : false);
+                                            param.mg_global.setup_minimize_memory == QUDA_BOOLEAN_TRUE ? true : false,
+                                            param.hierarchy_load ? hierarchyFile(param.hierarchy_file, "coarse") : "");
 
       // create smoothing operators
       diracParam.dirac = const_cast<Dirac *>(param.matSmooth->Expose());
@@ -1355,6 +1368,28 @@ namespace quda
     if (param.level < param.Nlevel - 2) coarse->dumpNullVectors();
   }
 
+  void MG::saveHierarchy(const std::string &prefix) const
+  {
+    if (param.level >= param.Nlevel - 1) return;
+    pushLevel(param.level);
+
+    if (param.transfer_type == QUDA_TRANSFER_AGGREGATE) {
+      VectorIO io(hierarchyFile(prefix, "B"));
+      io.save(param.B);
+      transfer->save(hierarchyFile(prefix, "V"));
+    }
+
+    if (param.level == 0
+        && (param.transfer_type == QUDA_TRANSFER_OPTIMIZED_KD || param.transfer_type == QUDA_TRANSFER_OPTIMIZED_KD_DROP_LONG)) {
+      saveGaugeField(hierarchyFile(prefix, "XinvKD"), *xInvKD);
+    } else {
+      static_cast<const DiracCoarse *>(diracCoarseResidual)->save(hierarchyFile(prefix, "coarse"));
+    }
+
+    popLevel();
+    if (param.level < param.Nlevel - 2) coarse->saveHierarchy(prefix);
+  }
+
   void MG::generateNullVectors(std::vector<ColorSpinorField *> &B, bool refresh)
   {
     pushLevel(param.level);
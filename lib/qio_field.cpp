@@ -4,8 +4,12 @@
 #include <quda.h>
 #include <util_quda.h>
 #include <layout_hyper.h>
+#include <qio_field.h>
 
 #include <string>
+#include <cstring>
+#include <vector>
+#include <type_traits>
 
 static QIO_Layout layout;
 static int lattice_size[4];
@@ -62,6 +66,89 @@ template <typename oFloat, typename iFloat> void vget(char *s1, size_t index, in
   }
 }
 
+// Precision conversion is not done in the QIO callbacks, which are
+// called once per site.  Instead the callbacks copy each site of the
+// record to or from a staging buffer in file precision, ordered by
+// node site index, and the conversion between the staging buffer and
+// the fields is done in bulk over all sites in a parallel loop.
+
+// copy a site of the record from the read buffer into the staging buffer
+template <typename fFloat> void vput_raw(char *s1, size_t index, int count, void *s2)
+{
+  size_t bytes = count * vlen * sizeof(fFloat);
+  memcpy(static_cast<char *>(s2) + index * bytes, s1, bytes);
+}
+
+// copy a site of the record from the staging buffer into the write buffer
+template <typename fFloat> void vget_raw(char *s1, size_t index, int count, void *s2)
+{
+  size_t bytes = count * vlen * sizeof(fFloat);
+  memcpy(s1, static_cast<const char *>(s2) + index * bytes, bytes);
+}
+
+// convert the staging buffer into an array of fields
+template <typename oFloat, typename iFloat> void unpack_record(void *field_in[], const iFloat *buffer, int count)
+{
+  oFloat **field = reinterpret_cast<oFloat **>(field_in);
+  const size_t sites = layout.sites_on_node;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (size_t s = 0; s < sites; s++) {
+    const iFloat *src = buffer + s * count * vlen;
+    for (int i = 0; i < count; i++) {
+      oFloat *dest = field[i] + vlen * s;
+      for (int j = 0; j < vlen; j++) dest[j] = src[i * vlen + j];
+    }
+  }
+}
+
+// convert an array of fields into the staging buffer
+template <typename oFloat, typename iFloat> void pack_record(oFloat *buffer, void *field_out[], int count)
+{
+  iFloat **field = reinterpret_cast<iFloat **>(field_out);
+  const size_t sites = layout.sites_on_node;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (size_t s = 0; s < sites; s++) {
+    oFloat *dest = buffer + s * count * vlen;
+    for (int i = 0; i < count; i++) {
+      const iFloat *src = field[i] + vlen * s;
+      for (int j = 0; j < vlen; j++) dest[i * vlen + j] = src[j];
+    }
+  }
+}
+
+// read a record in file precision iFloat into fields of precision oFloat
+template <typename oFloat, typename iFloat>
+int read_record(QIO_Reader *infile, QIO_RecordInfo *rec_info, QIO_String *xml_record, int count, void *field_in[])
+{
+  size_t rec_size = sizeof(iFloat) * count * vlen;
+  if (std::is_same<oFloat, iFloat>::value)
+    return QIO_read(infile, rec_info, xml_record, vput<oFloat, iFloat>, rec_size, sizeof(iFloat), field_in);
+
+  std::vector<iFloat> buffer(static_cast<size_t>(layout.sites_on_node) * count * vlen);
+  int status = QIO_read(infile, rec_info, xml_record, vput_raw<iFloat>, rec_size, sizeof(iFloat), buffer.data());
+  if (status == QIO_SUCCESS) unpack_record<oFloat, iFloat>(field_in, buffer.data(), count);
+  return status;
+}
+
+// write fields of precision iFloat as a record in file precision oFloat
+template <typename oFloat, typename iFloat>
+int write_record(QIO_Writer *outfile, QIO_RecordInfo *rec_info, QIO_String *xml_record, int count, void *field_out[])
+{
+  size_t rec_size = sizeof(oFloat) * count * vlen;
+  if (std::is_same<oFloat, iFloat>::value)
+    return QIO_write(outfile, rec_info, xml_record, vget<oFloat, iFloat>, rec_size, sizeof(oFloat), field_out);
+
+  std::vector<oFloat> buffer(static_cast<size_t>(layout.sites_on_node) * count * vlen);
+  pack_record<oFloat, iFloat>(buffer.data(), field_out, count);
+  return QIO_write(outfile, rec_info, xml_record, vget_raw<oFloat>, rec_size, sizeof(oFloat), buffer.data());
+}
+
 QIO_Reader *open_test_input(const char *filename, int volfmt, int serpar)
 {
   QIO_Iflag iflag;
@@ -168,23 +255,20 @@ int read_field(QIO_Reader *infile, int count, void *field_in[], QudaPrecision cp
   // Tracked on github via #936
   if (len != 18 && QIO_string_length(xml_record_in) > 0) printfQuda("QIO string: %s\n", QIO_string_ptr(xml_record_in));
 
-  // Get total size. Could probably check the filesize better, but tbd.
-  size_t rec_size = file_prec * count * len;
-
   vlen = len;
 
   /* Read the field record and convert to cpu precision*/
   if (cpu_prec == QUDA_DOUBLE_PRECISION) {
     if (file_prec == QUDA_DOUBLE_PRECISION) {
-      status = QIO_read(infile, rec_info, xml_record_in, vput<double, double>, rec_size, QUDA_DOUBLE_PRECISION, field_in);
+      status = read_record<double, double>(infile, rec_info, xml_record_in, count, field_in);
     } else {
-      status = QIO_read(infile, rec_info, xml_record_in, vput<double, float>, rec_size, QUDA_SINGLE_PRECISION, field_in);
+      status = read_record<double, float>(infile, rec_info, xml_record_in, count, field_in);
     }
   } else {
     if (file_prec == QUDA_DOUBLE_PRECISION) {
-      status = QIO_read(infile, rec_info, xml_record_in, vput<float, double>, rec_size, QUDA_DOUBLE_PRECISION, field_in);
+      status = read_record<float, double>(infile, rec_info, xml_record_in, count, field_in);
     } else {
-      status = QIO_read(infile, rec_info, xml_record_in, vput<float, float>, rec_size, QUDA_SINGLE_PRECISION, field_in);
+      status = read_record<float, float>(infile, rec_info, xml_record_in, count, field_in);
     }
   }
 
@@ -247,6 +331,16 @@ void set_layout(const int *X, QudaSiteSubset subset = QUDA_FULL_SITE_SUBSET)
 
 void read_gauge_field(const char *filename, void *gauge[], QudaPrecision precision, const int *X, int, char *[])
 {
+  if (quda::native_io::is_native(filename)) {
+    quda::native_io::read_gauge_field(filename, gauge, precision, X);
+    return;
+  }
+
+  if (quda::ildg_io::use_native_reader() && quda::ildg_io::is_ildg(filename)) {
+    quda::ildg_io::read_gauge_field(filename, gauge, precision, X);
+    return;
+  }
+
   quda_this_node = QMP_get_node_number();
 
   set_layout(X);
@@ -352,22 +446,17 @@ int write_field(QIO_Writer *outfile, int count, void *field_out[], QudaPrecision
 
   /* Write the field record converting to desired file precision*/
   vlen = len;
-  size_t rec_size = file_prec*count*len;
   if (cpu_prec == QUDA_DOUBLE_PRECISION) {
     if (file_prec == QUDA_DOUBLE_PRECISION) {
-      status
-        = QIO_write(outfile, rec_info, xml_record_out, vget<double, double>, rec_size, QUDA_DOUBLE_PRECISION, field_out);
+      status = write_record<double, double>(outfile, rec_info, xml_record_out, count, field_out);
     } else {
-      status
-        = QIO_write(outfile, rec_info, xml_record_out, vget<double, float>, rec_size, QUDA_SINGLE_PRECISION, field_out);
+      status = write_record<float, double>(outfile, rec_info, xml_record_out, count, field_out);
     }
   } else {
     if (file_prec == QUDA_DOUBLE_PRECISION) {
-      status
-        = QIO_write(outfile, rec_info, xml_record_out, vget<float, double>, rec_size, QUDA_DOUBLE_PRECISION, field_out);
+      status = write_record<double, float>(outfile, rec_info, xml_record_out, count, field_out);
     } else {
-      status
-        = QIO_write(outfile, rec_info, xml_record_out, vget<float, float>, rec_size, QUDA_SINGLE_PRECISION, field_out);
+      status = write_record<float, float>(outfile, rec_info, xml_record_out, count, field_out);
     }
   }
 
@@ -388,6 +477,11 @@ int write_su3_field(QIO_Writer *outfile, int count, void *field_out[],
 
 void write_gauge_field(const char *filename, void *gauge[], QudaPrecision precision, const int *X, int, char *[])
 {
+  if (quda::native_io::save_native()) {
+    quda::native_io::write_gauge_field(filename, gauge, precision, X);
+    return;
+  }
+
   quda_this_node = QMP_get_node_number();
 
   set_layout(X);
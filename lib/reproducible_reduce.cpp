@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <vector>
+
+#include <util_quda.h>
+#include <reproducible_reduce.h>
+
+#if defined(QMP_COMMS) || defined(MPI_COMMS)
+
+#define MPI_CHECK(mpi_call)                                                                                            \
+  do {                                                                                                                 \
+    int status = mpi_call;                                                                                             \
+    if (status != MPI_SUCCESS) {                                                                                       \
+      char err_string[128];                                                                                            \
+      int err_len;                                                                                                     \
+      MPI_Error_string(status, err_string, &err_len);                                                                  \
+      err_string[127] = '\0';                                                                                          \
+      errorQuda("(MPI) %s", err_string);                                                                               \
+    }                                                                                                                  \
+  } while (0)
+
+namespace quda
+{
+
+  namespace reproducible
+  {
+
+    /**
+       Custom reduction operator for the fixed-point summands
+     */
+    static void fixed_sum_op(void *in, void *inout, int *len, MPI_Datatype *)
+    {
+      accumulate(static_cast<const int64_t *>(in), static_cast<int64_t *>(inout), *len);
+    }
+
+    void allreduce(double *data, size_t size, MPI_Comm comm)
+    {
+      static MPI_Datatype fixed_type = MPI_DATATYPE_NULL;
+      static MPI_Op fixed_sum = MPI_OP_NULL;
+      if (fixed_type == MPI_DATATYPE_NULL) {
+        MPI_CHECK(MPI_Type_contiguous(n_limb, MPI_INT64_T, &fixed_type));
+        MPI_CHECK(MPI_Type_commit(&fixed_type));
+        MPI_CHECK(MPI_Op_create(fixed_sum_op, 1, &fixed_sum));
+      }
+
+      // first pass: find the global maximum exponent of each summand
+      std::vector<int> e(size);
+      for (size_t i = 0; i < size; i++) e[i] = exponent(data[i]);
+      MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, e.data(), size, MPI_INT, MPI_MAX, comm));
+
+      // non-finite values cannot be represented in fixed point, and the sum is non-finite regardless of order
+      if (std::any_of(e.begin(), e.end(), [](int e_i) { return e_i == non_finite; })) {
+        MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, comm));
+        return;
+      }
+
+      // second pass: exact integer sum of the fixed-point summands
+      std::vector<int64_t> fixed(size * n_limb);
+      for (size_t i = 0; i < size; i++) to_fixed(&fixed[i * n_limb], data[i], e[i]);
+      MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, fixed.data(), size, fixed_type, fixed_sum, comm));
+      for (size_t i = 0; i < size; i++) data[i] = from_fixed(&fixed[i * n_limb], e[i]);
+    }
+
+  } // namespace reproducible
+
+} // namespace quda
+
+#endif
@@ -204,6 +204,14 @@ namespace quda {
 
         // we successfully got the deflation space so disable any subsequent recalculation
         deflate_compute = false;
+      } else if (strcmp(param.eig_param.vec_infile, "") != 0 && param.eig_param.compute_svd == QUDA_BOOLEAN_FALSE
+                 && EigenvectorStore::enabled() && native_io::is_native(param.eig_param.vec_infile)) {
+        // Stream the eigenvectors from file on demand, rather than loading the entire space
+        eig_solve->setEigenvectorStore(
+          new EigenvectorStore(param.eig_param.vec_infile, csParam, param.eig_param.n_conv));
+
+        evals.resize(param.eig_param.n_conv);
+        for (int i = 0; i < param.eig_param.n_conv; i++) evals[i] = 0.0;
       } else {
         // Computing the deflation space, rather than transferring, so we create space.
         for (int i = 0; i < param.eig_param.n_conv; i++) evecs.push_back(new ColorSpinorField(csParam));
@@ -221,7 +229,8 @@ namespace quda {
   void Solver::destroyDeflationSpace()
   {
     if (deflate_init) {
-      if (param.eig_param.preserve_deflation) {
+      // a streamed eigenspace is not preserved, since it is cheap to reopen
+      if (param.eig_param.preserve_deflation && !evecs.empty()) {
         if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Preserving deflation space of size %lu\n", evecs.size());
 
         if (param.eig_param.preserve_deflation_space) {
@@ -0,0 +1,114 @@
+#include <array>
+#include <map>
+#include <tuple>
+#include <limits>
+
+#include <split_grid.h>
+
+namespace quda
+{
+
+  namespace split_grid
+  {
+
+    // the split is stored as a std::array, since CommKey::operator< is an element-wise comparison and not an ordering
+    using exchange_key = std::tuple<std::array<int, CommKey::n_dim>, bool, size_t, int>;
+    static std::map<exchange_key, Exchange> exchange_cache;
+
+    /**
+       The maximum message size used for split-grid redistribution,
+       set with QUDA_SPLIT_GRID_CHUNK_SIZE (in MiB, default 64).
+     */
+    static size_t get_chunk_bytes()
+    {
+      static bool init = false;
+      static size_t chunk_bytes = 64 * 1024 * 1024;
+
+      if (!init) {
+        char *chunk_env = getenv("QUDA_SPLIT_GRID_CHUNK_SIZE");
+        if (chunk_env) {
+          long chunk = atol(chunk_env);
+          if (chunk <= 0) errorQuda("Invalid QUDA_SPLIT_GRID_CHUNK_SIZE=%s", chunk_env);
+          chunk_bytes = static_cast<size_t>(chunk) * 1024 * 1024;
+        }
+        chunk_bytes = std::min(chunk_bytes, static_cast<size_t>(std::numeric_limits<int>::max()));
+        init = true;
+      }
+      return chunk_bytes;
+    }
+
+    Exchange &get_exchange(const CommKey &comm_key, bool join, size_t bytes, int n_send, int n_replicates)
+    {
+      std::array<int, CommKey::n_dim> split;
+      for (int d = 0; d < CommKey::n_dim; d++) split[d] = comm_key[d];
+      auto &ex = exchange_cache[exchange_key(split, join, bytes, n_send)];
+
+      if (ex.bytes == 0) {
+        ex.bytes = bytes;
+        ex.chunk_bytes = get_chunk_bytes();
+        ex.n_chunks = (bytes + ex.chunk_bytes - 1) / ex.chunk_bytes;
+
+        ex.send_buffer.resize(n_send);
+        for (auto &b : ex.send_buffer) b = pinned_malloc(bytes);
+        ex.recv_buffer.resize(n_replicates);
+        for (auto &b : ex.recv_buffer) b = pinned_malloc(bytes);
+
+        ex.mh_send.resize(n_replicates * ex.n_chunks, nullptr);
+        ex.mh_recv.resize(n_replicates * ex.n_chunks, nullptr);
+      }
+
+      return ex;
+    }
+
+    void declare(Exchange &ex, int i, void *send_buffer, int dst_rank, int send_tag, int src_rank, int recv_tag)
+    {
+      // chunks between a given pair of ranks share the same tag, since MPI preserves the message order
+      for (int c = 0; c < ex.n_chunks; c++) {
+        size_t offset = c * ex.chunk_bytes;
+        size_t bytes = std::min(ex.chunk_bytes, ex.bytes - offset);
+        ex.mh_send[i * ex.n_chunks + c]
+          = comm_declare_send_rank(static_cast<char *>(send_buffer) + offset, dst_rank, send_tag, bytes);
+        ex.mh_recv[i * ex.n_chunks + c]
+          = comm_declare_recv_rank(static_cast<char *>(ex.recv_buffer[i]) + offset, src_rank, recv_tag, bytes);
+      }
+    }
+
+    void start_recv(Exchange &ex, int i)
+    {
+      for (int c = 0; c < ex.n_chunks; c++) comm_start(ex.mh_recv[i * ex.n_chunks + c]);
+    }
+
+    void start_send(Exchange &ex, int i)
+    {
+      for (int c = 0; c < ex.n_chunks; c++) comm_start(ex.mh_send[i * ex.n_chunks + c]);
+    }
+
+    bool recv_complete(Exchange &ex, int i)
+    {
+      for (int c = 0; c < ex.n_chunks; c++)
+        if (!comm_query(ex.mh_recv[i * ex.n_chunks + c])) return false;
+      return true;
+    }
+
+    void wait_send(Exchange &ex, int i)
+    {
+      for (int c = 0; c < ex.n_chunks; c++) comm_wait(ex.mh_send[i * ex.n_chunks + c]);
+    }
+
+    void destroy()
+    {
+      for (auto &entry : exchange_cache) {
+        auto &ex = entry.second;
+        for (auto &mh : ex.mh_send)
+          if (mh) comm_free(mh);
+        for (auto &mh : ex.mh_recv)
+          if (mh) comm_free(mh);
+        for (auto &b : ex.send_buffer) host_free(b);
+        for (auto &b : ex.recv_buffer) host_free(b);
+      }
+      exchange_cache.clear();
+    }
+
+  } // namespace split_grid
+
+} // namespace quda
@@ -262,8 +262,8 @@ namespace quda {
   }
 
 
-  // Allocates and calculates the inverse KD block, returning Xinv
-  std::unique_ptr<GaugeField> AllocateAndBuildStaggeredKahlerDiracInverse(const cudaGaugeField &gauge, const double mass, const bool dagger_approximation)
+  // Allocates the inverse KD block, returning Xinv
+  std::unique_ptr<GaugeField> AllocateStaggeredKahlerDiracInverse(const cudaGaugeField &gauge)
   {
     GaugeFieldParam gParam(gauge);
     gParam.reconstruct = QUDA_RECONSTRUCT_NO;
@@ -277,7 +277,13 @@ namespace quda {
     // latter true is to force FLOAT2
     gParam.setPrecision(gauge.Precision(), true);
 
-    std::unique_ptr<GaugeField> Xinv(reinterpret_cast<GaugeField*>(new cudaGaugeField(gParam)));
+    return std::unique_ptr<GaugeField>(reinterpret_cast<GaugeField*>(new cudaGaugeField(gParam)));
+  }
+
+  // Allocates and calculates the inverse KD block, returning Xinv
+  std::unique_ptr<GaugeField> AllocateAndBuildStaggeredKahlerDiracInverse(const cudaGaugeField &gauge, const double mass, const bool dagger_approximation)
+  {
+    std::unique_ptr<GaugeField> Xinv = AllocateStaggeredKahlerDiracInverse(gauge);
 
     BuildStaggeredKahlerDiracInverse(*Xinv, gauge, mass, dagger_approximation);
 
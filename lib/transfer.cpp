@@ -7,6 +7,7 @@
 #include <multigrid.h>
 #include <tune_quda.h>
 #include <malloc_quda.h>
+#include <vector_io.h>
 
 #include <iostream>
 #include <algorithm>
@@ -21,7 +22,7 @@ namespace quda {
   */
   Transfer::Transfer(const std::vector<ColorSpinorField *> &B, int Nvec, int n_block_ortho, bool block_ortho_two_pass,
                      int *geo_bs, int spin_bs, QudaPrecision null_precision, const QudaTransferType transfer_type,
-                     TimeProfile &profile) :
+                     TimeProfile &profile, const std::string &infile) :
     B(B),
     Nvec(Nvec),
     NblockOrtho(n_block_ortho),
@@ -133,7 +134,7 @@ namespace quda {
     for (int s = 0; s < B[0]->Nspin(); s++) spin_map[s] = static_cast<int*>(safe_malloc(2*sizeof(int)));
     createSpinMap(spin_bs);
 
-    reset();
+    reset(infile);
     postTrace();
   }
 
@@ -233,7 +234,7 @@ namespace quda {
     }
   }
 
-  void Transfer::reset()
+  void Transfer::reset(const std::string &infile)
   {
     postTrace();
 
@@ -241,6 +242,18 @@ namespace quda {
         || transfer_type == QUDA_TRANSFER_OPTIMIZED_KD_DROP_LONG) {
       return;
     }
+
+    if (infile.size() > 0) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Transfer: loading prolongator from %s\n", infile.c_str());
+      bool gpu = B[0]->Location() == QUDA_CUDA_FIELD_LOCATION;
+      std::vector<ColorSpinorField *> V {gpu ? V_d : V_h};
+      VectorIO(infile).load(V);
+      if (gpu && enable_cpu) *V_h = *V_d;
+      if (!gpu && enable_gpu) *V_d = *V_h;
+      postTrace();
+      return;
+    }
+
     if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Transfer: block orthogonalizing\n");
 
     if (B[0]->Location() == QUDA_CUDA_FIELD_LOCATION) {
@@ -261,6 +274,17 @@ namespace quda {
     postTrace();
   }
 
+  void Transfer::save(const std::string &filename) const
+  {
+    if (transfer_type == QUDA_TRANSFER_COARSE_KD || transfer_type == QUDA_TRANSFER_OPTIMIZED_KD
+        || transfer_type == QUDA_TRANSFER_OPTIMIZED_KD_DROP_LONG) {
+      return;
+    }
+
+    std::vector<ColorSpinorField *> V {const_cast<ColorSpinorField *>(&Vectors())};
+    VectorIO(filename).save(V);
+  }
+
   Transfer::~Transfer() {
     if (spin_map)
     {
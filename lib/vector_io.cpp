@@ -1,24 +1,19 @@
 #include <color_spinor_field.h>
 #include <qio_field.h>
+#include <field_io.h>
 #include <vector_io.h>
 #include <blas_quda.h>
 
 namespace quda
 {
 
-  VectorIO::VectorIO(const std::string &filename, bool parity_inflate) :
-#ifdef HAVE_QIO
-    filename(filename),
-    parity_inflate(parity_inflate)
-#else
-    filename(filename)
-#endif
+  VectorIO::VectorIO(const std::string &filename, bool parity_inflate, bool exact) :
+    filename(filename), parity_inflate(parity_inflate), exact(exact)
   {
     if (strcmp(filename.c_str(), "") == 0)
       errorQuda("No eigenspace input file defined (filename = %s, parity_inflate = %d", filename.c_str(), parity_inflate);
   }
 
-#ifdef HAVE_QIO
   void VectorIO::load(std::vector<ColorSpinorField *> &vecs)
   {
     const int Nvec = vecs.size();
@@ -50,7 +45,7 @@ namespace quda
     }
 
     if (vecs[0]->Ndim() == 4 || vecs[0]->Ndim() == 5) {
-      // since QIO routines presently assume we have 4-d fields, we need to convert to array of 4-d fields
+      // since the I/O routines presently assume we have 4-d fields, we need to convert to array of 4-d fields
       auto Ls = vecs[0]->Ndim() == 5 ? tmp[0]->X(4) : 1;
       auto V4 = tmp[0]->Volume() / Ls;
       auto stride = V4 * tmp[0]->Ncolor() * tmp[0]->Nspin() * 2 * tmp[0]->Precision();
@@ -59,8 +54,17 @@ namespace quda
         for (int j = 0; j < Ls; j++) { V[i * Ls + j] = static_cast<char *>(tmp[i]->V()) + j * stride; }
       }
 
-      read_spinor_field(filename.c_str(), &V[0], tmp[0]->Precision(), tmp[0]->X(), tmp[0]->SiteSubset(), spinor_parity,
-                        tmp[0]->Ncolor(), tmp[0]->Nspin(), Nvec * Ls, 0, (char **)0);
+      if (native_io::is_native(filename)) {
+        native_io::read_spinor_field(filename, &V[0], tmp[0]->Precision(), tmp[0]->X(), tmp[0]->SiteSubset(),
+                                     spinor_parity, tmp[0]->Ncolor(), tmp[0]->Nspin(), Nvec * Ls);
+      } else {
+#ifdef HAVE_QIO
+        read_spinor_field(filename.c_str(), &V[0], tmp[0]->Precision(), tmp[0]->X(), tmp[0]->SiteSubset(),
+                          spinor_parity, tmp[0]->Ncolor(), tmp[0]->Nspin(), Nvec * Ls, 0, (char **)0);
+#else
+        errorQuda("%s is not a native QUDA field file and QIO library was not built", filename.c_str());
+#endif
+      }
 
       host_free(V);
     } else {
@@ -113,11 +117,7 @@ namespace quda
 
     if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Done loading vectors\n");
   }
-#else
-  void VectorIO::load(std::vector<ColorSpinorField *> &) { errorQuda("\nQIO library was not built.\n"); }
-#endif
 
-#ifdef HAVE_QIO
   void VectorIO::save(const std::vector<ColorSpinorField *> &vecs)
   {
     const int Nvec = vecs.size();
@@ -186,7 +186,7 @@ namespace quda
     if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Start saving %d vectors to %s\n", Nvec, filename.c_str());
 
     if (vecs[0]->Ndim() == 4 || vecs[0]->Ndim() == 5) {
-      // since QIO routines presently assume we have 4-d fields, we need to convert to array of 4-d fields
+      // since the I/O routines presently assume we have 4-d fields, we need to convert to array of 4-d fields
       auto Ls = vecs[0]->Ndim() == 5 ? tmp[0]->X(4) : 1;
       auto V4 = tmp[0]->Volume() / Ls;
       auto stride = V4 * tmp[0]->Ncolor() * tmp[0]->Nspin() * 2 * tmp[0]->Precision();
@@ -195,8 +195,13 @@ namespace quda
         for (int j = 0; j < Ls; j++) { V[i * Ls + j] = static_cast<char *>(tmp[i]->V()) + j * stride; }
       }
 
-      write_spinor_field(filename.c_str(), &V[0], tmp[0]->Precision(), tmp[0]->X(), tmp[0]->SiteSubset(), spinor_parity,
-                         tmp[0]->Ncolor(), tmp[0]->Nspin(), Nvec * Ls, 0, (char **)0);
+      if (exact || native_io::save_native()) {
+        native_io::write_spinor_field(filename, &V[0], tmp[0]->Precision(), tmp[0]->X(), tmp[0]->SiteSubset(),
+                                      spinor_parity, tmp[0]->Ncolor(), tmp[0]->Nspin(), Nvec * Ls, !exact);
+      } else {
+        write_spinor_field(filename.c_str(), &V[0], tmp[0]->Precision(), tmp[0]->X(), tmp[0]->SiteSubset(),
+                           spinor_parity, tmp[0]->Ncolor(), tmp[0]->Nspin(), Nvec * Ls, 0, (char **)0);
+      }
 
       host_free(V);
     } else {
@@ -209,8 +214,5 @@ namespace quda
       for (int i = 0; i < Nvec; i++) delete tmp[i];
     }
   }
-#else
-  void VectorIO::save(const std::vector<ColorSpinorField *> &) { errorQuda("\nQIO library was not built.\n"); }
-#endif
 
 } // namespace quda
@@ -124,6 +124,23 @@ TEST_P(DslashTest, verify)
 
 TEST_P(DslashTest, benchmark) { dslash_test_wrapper.run_test(niter, /**show_metrics =*/true); }
 
+// the host fields are built with the counter-based generator, which must reproduce the Random123 known-answer vectors
+TEST(host_rng, philox4x32)
+{
+  uint32_t ctr[3][4] = {{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+                        {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                        {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+  uint32_t key[3][2] = {{0x00000000, 0x00000000}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}};
+  const uint32_t expected[3][4] = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+                                   {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+                                   {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+
+  for (int i = 0; i < 3; i++) {
+    philox4x32(ctr[i], key[i]);
+    for (int j = 0; j < 4; j++) EXPECT_EQ(ctr[i][j], expected[i][j]) << "known-answer vector " << i << " word " << j;
+  }
+}
+
 int main(int argc, char **argv)
 {
   // initalize google test, includes command line options
@@ -17,13 +17,11 @@ template <typename T> using complex = std::complex<T>;
 
 void fillEigenArray(MatrixXcd &EigenArr, complex<double> *arr, int rows, int cols, int ld, int offset)
 {
-  int counter = offset;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < rows; i++) {
-    for (int j = 0; j < cols; j++) {
-      EigenArr(i, j) = arr[counter];
-      counter++;
-    }
-    counter += (ld - cols);
+    for (int j = 0; j < cols; j++) { EigenArr(i, j) = arr[offset + i * ld + j]; }
   }
 }
 
@@ -240,32 +238,68 @@ double blasGEMMQudaVerify(void *arrayA, void *arrayB, void *arrayC, void *arrayC
 
   switch (blas_param->data_type) {
   case QUDA_BLAS_DATATYPE_S:
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refA_size * batches; i += 2) { ((double *)checkA)[i] = ((float *)arrayA)[i / 2]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refB_size * batches; i += 2) { ((double *)checkB)[i] = ((float *)arrayB)[i / 2]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refC_size * batches; i += 2) {
       ((double *)checkC)[i] = ((float *)arrayC)[i / 2];
       ((double *)checkCcopy)[i] = ((float *)arrayCcopy)[i / 2];
     }
     break;
   case QUDA_BLAS_DATATYPE_D:
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refA_size * batches; i += 2) { ((double *)checkA)[i] = ((double *)arrayA)[i / 2]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refB_size * batches; i += 2) { ((double *)checkB)[i] = ((double *)arrayB)[i / 2]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refC_size * batches; i += 2) {
       ((double *)checkC)[i] = ((double *)arrayC)[i / 2];
       ((double *)checkCcopy)[i] = ((double *)arrayCcopy)[i / 2];
     }
     break;
   case QUDA_BLAS_DATATYPE_C:
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refA_size * batches; i++) { ((double *)checkA)[i] = ((float *)arrayA)[i]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refB_size * batches; i++) { ((double *)checkB)[i] = ((float *)arrayB)[i]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refC_size * batches; i++) {
       ((double *)checkC)[i] = ((float *)arrayC)[i];
       ((double *)checkCcopy)[i] = ((float *)arrayCcopy)[i];
     }
     break;
   case QUDA_BLAS_DATATYPE_Z:
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refA_size * batches; i++) { ((double *)checkA)[i] = ((double *)arrayA)[i]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refB_size * batches; i++) { ((double *)checkB)[i] = ((double *)arrayB)[i]; }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (uint64_t i = 0; i < 2 * refC_size * batches; i++) {
       ((double *)checkC)[i] = ((double *)arrayC)[i];
       ((double *)checkCcopy)[i] = ((double *)arrayCcopy)[i];
@@ -2,11 +2,111 @@
 #include <stdlib.h>
 #include <math.h>
 #include <complex>
+#include <algorithm>
 
 #include <util_quda.h>
 #include <host_utils.h>
 #include <wilson_dslash_reference.h>
 
+// Each parity of the clover field is stored as a pair of chiral blocks per
+// site, each a 6x6 Hermitian matrix packed as 6 real diagonal entries followed
+// by the 15 complex entries of the strictly lower triangle in column order
+constexpr int clover_block_n = 6;
+constexpr int clover_block_size = clover_block_n * clover_block_n;
+
+using CloverBlock = std::complex<double>[clover_block_n][clover_block_n];
+using CloverHalfSpinor = std::complex<double>[clover_block_n];
+
+template <typename cFloat> static void unpackCloverBlock(CloverBlock &A, const cFloat *D)
+{
+  constexpr int N = clover_block_n;
+  const std::complex<cFloat> *L = reinterpret_cast<const std::complex<cFloat> *>(&D[N]);
+
+  int k = 0;
+  for (int col = 0; col < N; col++) {
+    A[col][col] = D[col];
+    for (int row = col + 1; row < N; row++, k++) {
+      A[row][col] = L[k];
+      A[col][row] = std::conj(A[row][col]);
+    }
+  }
+}
+
+template <typename cFloat> static void packCloverBlock(cFloat *D, const CloverBlock &A)
+{
+  constexpr int N = clover_block_n;
+  std::complex<cFloat> *L = reinterpret_cast<std::complex<cFloat> *>(&D[N]);
+
+  int k = 0;
+  for (int col = 0; col < N; col++) {
+    D[col] = A[col][col].real();
+    for (int row = col + 1; row < N; row++, k++) L[k] = A[row][col];
+  }
+}
+
+static void multCloverBlock(CloverHalfSpinor &y, const CloverBlock &A, const CloverHalfSpinor &x)
+{
+  for (int row = 0; row < clover_block_n; row++) {
+    y[row] = 0.0;
+    for (int col = 0; col < clover_block_n; col++) y[row] += A[row][col] * x[col];
+  }
+}
+
+/**
+   @brief Invert a Hermitian positive-definite chiral block in place
+   through its Cholesky decomposition A = L L^dagger, as is done for
+   the device clover inverse
+   @param[in,out] A The block to invert
+ */
+static void invertCloverBlock(CloverBlock &A)
+{
+  constexpr int N = clover_block_n;
+  CloverBlock L = {}, Linv = {};
+
+  for (int j = 0; j < N; j++) {
+    double diag = A[j][j].real();
+    for (int k = 0; k < j; k++) diag -= std::norm(L[j][k]);
+    if (diag <= 0.0) errorQuda("Clover block is not positive definite");
+    L[j][j] = sqrt(diag);
+    for (int i = j + 1; i < N; i++) {
+      std::complex<double> sum = A[i][j];
+      for (int k = 0; k < j; k++) sum -= L[i][k] * std::conj(L[j][k]);
+      L[i][j] = sum / L[j][j].real();
+    }
+  }
+
+  // forward substitution for L^{-1}, which is lower triangular
+  for (int j = 0; j < N; j++) {
+    Linv[j][j] = 1.0 / L[j][j].real();
+    for (int i = j + 1; i < N; i++) {
+      std::complex<double> sum = 0.0;
+      for (int k = j; k < i; k++) sum -= L[i][k] * Linv[k][j];
+      Linv[i][j] = sum / L[i][i].real();
+    }
+  }
+
+  // A^{-1} = L^{-dagger} L^{-1}
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      std::complex<double> sum = 0.0;
+      for (int k = std::max(i, j); k < N; k++) sum += std::conj(Linv[k][i]) * Linv[k][j];
+      A[i][j] = sum;
+    }
+  }
+}
+
+template <typename sFloat> static void loadHalfSpinor(CloverHalfSpinor &x, const sFloat *in, int i, int chi)
+{
+  const std::complex<sFloat> *In = reinterpret_cast<const std::complex<sFloat> *>(in) + i * 12 + chi * clover_block_n;
+  for (int j = 0; j < clover_block_n; j++) x[j] = In[j];
+}
+
+template <typename sFloat> static void storeHalfSpinor(sFloat *out, const CloverHalfSpinor &x, int i, int chi)
+{
+  std::complex<sFloat> *Out = reinterpret_cast<std::complex<sFloat> *>(out) + i * 12 + chi * clover_block_n;
+  for (int j = 0; j < clover_block_n; j++) Out[j] = x[j];
+}
+
 /**
    @brief Apply the clover matrix field
    @param[out] out Result field (single parity)
@@ -15,50 +115,142 @@
    @param[in] parity Parity to which we are applying the clover field
  */
 template <typename sFloat, typename cFloat>
-void cloverReference(sFloat *out, cFloat *clover, sFloat *in, int parity) {
-  int nSpin = 4;
-  int nColor = 3;
-  int N = nColor * nSpin / 2;
-  int chiralBlock = N + 2*(N-1)*N/2;
-
-  for (int i=0; i<Vh; i++) {
-    std::complex<sFloat> *In = reinterpret_cast<std::complex<sFloat>*>(&in[i*nSpin*nColor*2]);
-    std::complex<sFloat> *Out = reinterpret_cast<std::complex<sFloat>*>(&out[i*nSpin*nColor*2]);
-  
-    for (int chi=0; chi<nSpin/2; chi++) {
-      cFloat *D = &clover[((parity*Vh + i)*2 + chi)*chiralBlock];
-      std::complex<cFloat> *L = reinterpret_cast<std::complex<cFloat>*>(&D[N]);
-
-      for (int s_col=0; s_col<nSpin/2; s_col++) { // 2 spins per chiral block
-	for (int c_col=0; c_col<nColor; c_col++) {
-	  const int col = s_col * nColor + c_col;
-	  const int Col = chi*N + col;
-	  Out[Col] = 0.0;
-
-	  for (int s_row=0; s_row<nSpin/2; s_row++) { // 2 spins per chiral block
-	    for (int c_row=0; c_row<nColor; c_row++) {
-	      const int row = s_row * nColor + c_row;
-	      const int Row = chi*N + row;
-
-	      if (row == col) {
-		Out[Col] += D[row] * In[Row];
-	      } else if (col < row) {
-		int k = N*(N-1)/2 - (N-col)*(N-col-1)/2 + row - col - 1;
-		Out[Col] += conj(L[k]) * In[Row];
-	      } else if (row < col) {
-		int k = N*(N-1)/2 - (N-row)*(N-row-1)/2 + col - row - 1;		
-		Out[Col] += L[k] * In[Row];
-	      }
-	    }
-	  }
-
-	}
+void cloverReference(sFloat *out, const cFloat *clover, const sFloat *in, int parity)
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < Vh; i++) {
+    CloverBlock A;
+    CloverHalfSpinor x, y;
+    for (int chi = 0; chi < 2; chi++) {
+      unpackCloverBlock(A, &clover[((parity * Vh + i) * 2 + chi) * clover_block_size]);
+      loadHalfSpinor(x, in, i, chi);
+      multCloverBlock(y, A, x);
+      storeHalfSpinor(out, y, i, chi);
+    }
+  }
+}
+
+/**
+   @brief Apply the twisted-clover matrix field, for one or two
+   flavors, optionally followed by the (twisted) clover inverse:
+   out1 = cInv (C + i a gamma_5) in1 + b in2 and
+   out2 = cInv (C - i a gamma_5) in2 + b in1 (when in2 is set)
+   @param[out] out1 Result field for the first flavor (single parity)
+   @param[out] out2 Result field for the second flavor (single parity, nullptr if in2 is not set)
+   @param[in] clover Clover-matrix field (full field)
+   @param[in] cInv Clover-inverse field (full field), or nullptr to not apply it
+   @param[in] in1 Input field for the first flavor (single parity)
+   @param[in] in2 Input field for the second flavor (single parity), or nullptr for a single flavor
+   @param[in] parity Parity to which we are applying the clover field
+   @param[in] a The chiral twist
+   @param[in] b The flavor twist
+ */
+template <typename sFloat, typename cFloat>
+void twistCloverReference(sFloat *out1, sFloat *out2, const cFloat *clover, const cFloat *cInv, const sFloat *in1,
+                          const sFloat *in2, int parity, double a, double b)
+{
+  const int n_flavor = in2 ? 2 : 1;
+  const sFloat *in[2] = {in1, in2};
+  sFloat *out[2] = {out1, out2};
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < Vh; i++) {
+    CloverBlock A;
+    CloverHalfSpinor x[2], y[2];
+    for (int chi = 0; chi < 2; chi++) {
+      // gamma_5 is diagonal in the chiral basis
+      const std::complex<double> twist(0.0, chi == 0 ? a : -a);
+
+      unpackCloverBlock(A, &clover[((parity * Vh + i) * 2 + chi) * clover_block_size]);
+      for (int f = 0; f < n_flavor; f++) loadHalfSpinor(x[f], in[f], i, chi);
+
+      for (int f = 0; f < n_flavor; f++) {
+        multCloverBlock(y[f], A, x[f]);
+        for (int j = 0; j < clover_block_n; j++) y[f][j] += (f == 0 ? twist : -twist) * x[f][j];
+        if (n_flavor == 2)
+          for (int j = 0; j < clover_block_n; j++) y[f][j] += b * x[1 - f][j];
+      }
+
+      if (cInv) {
+        unpackCloverBlock(A, &cInv[((parity * Vh + i) * 2 + chi) * clover_block_size]);
+        for (int f = 0; f < n_flavor; f++) {
+          multCloverBlock(x[f], A, y[f]);
+          storeHalfSpinor(out[f], x[f], i, chi);
+        }
+      } else {
+        for (int f = 0; f < n_flavor; f++) storeHalfSpinor(out[f], y[f], i, chi);
       }
-      
     }
+  }
+}
 
+/**
+   @brief Compute the inverse of the clover field (or of C^2 + mu2 for
+   twisted clover) with a batched Cholesky decomposition of the chiral
+   blocks
+   @param[out] cInv Clover-inverse field (full field)
+   @param[in] clover Clover-matrix field (full field)
+   @param[in] twisted Whether to invert C^2 + mu2 rather than C
+   @param[in] mu2 The squared twist (mu^2 - epsilon^2 for the non-degenerate doublet)
+ */
+template <typename cFloat> void cloverInverseReference(cFloat *cInv, const cFloat *clover, bool twisted, double mu2)
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < 2 * V; i++) { // loop over sites and chiral blocks
+    CloverBlock A, A2;
+    unpackCloverBlock(A, &clover[i * clover_block_size]);
+
+    if (twisted) {
+      for (int row = 0; row < clover_block_n; row++) {
+        for (int col = 0; col < clover_block_n; col++) {
+          A2[row][col] = row == col ? mu2 : 0.0;
+          for (int k = 0; k < clover_block_n; k++) A2[row][col] += A[row][k] * A[k][col];
+        }
+      }
+      invertCloverBlock(A2);
+      packCloverBlock(&cInv[i * clover_block_size], A2);
+    } else {
+      invertCloverBlock(A);
+      packCloverBlock(&cInv[i * clover_block_size], A);
+    }
   }
+}
 
+void compute_clover_inverse(void *cInv, void *clover, bool twisted, double mu2, QudaPrecision precision)
+{
+  switch (precision) {
+  case QUDA_DOUBLE_PRECISION:
+    cloverInverseReference(static_cast<double *>(cInv), static_cast<double *>(clover), twisted, mu2);
+    break;
+  case QUDA_SINGLE_PRECISION:
+    cloverInverseReference(static_cast<float *>(cInv), static_cast<float *>(clover), twisted, mu2);
+    break;
+  default: errorQuda("Unsupported precision %d", precision);
+  }
+}
+
+void apply_twist_clover(void *out1, void *out2, void *clover, void *cInv, void *in1, void *in2, int parity, double a,
+                        double b, QudaPrecision precision)
+{
+  switch (precision) {
+  case QUDA_DOUBLE_PRECISION:
+    twistCloverReference(static_cast<double *>(out1), static_cast<double *>(out2), static_cast<double *>(clover),
+                         static_cast<double *>(cInv), static_cast<double *>(in1), static_cast<double *>(in2), parity,
+                         a, b);
+    break;
+  case QUDA_SINGLE_PRECISION:
+    twistCloverReference(static_cast<float *>(out1), static_cast<float *>(out2), static_cast<float *>(clover),
+                         static_cast<float *>(cInv), static_cast<float *>(in1), static_cast<float *>(in2), parity, a,
+                         b);
+    break;
+  default: errorQuda("Unsupported precision %d", precision);
+  }
 }
 
 void apply_clover(void *out, void *clover, void *in, int parity, QudaPrecision precision) {
@@ -173,6 +365,9 @@ void clover_mat(void *out, void **gauge, void *clover, void *in, double kappa,
 void applyTwist(void *out, void *in, void *tmpH, double a, QudaPrecision precision) {
   switch (precision) {
   case QUDA_DOUBLE_PRECISION:
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(int i = 0; i < Vh; i++)
       for(int s = 0; s < 4; s++) {
         double a5 = ((s / 2) ? -1.0 : +1.0) * a;
@@ -183,6 +378,9 @@ void applyTwist(void *out, void *in, void *tmpH, double a, QudaPrecision precisi
       }
     break;
   case QUDA_SINGLE_PRECISION:
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for(int i = 0; i < Vh; i++)
       for(int s = 0; s < 4; s++) {
         float a5 = ((s / 2) ? -1.0 : +1.0) * a;
@@ -213,9 +411,6 @@ void twistClover(void *out, void *in, void *x, void *clover, const double a, int
 // Apply (C + i*a*gamma_5)/(C^2 + a^2)
 void twistCloverGamma5(void *out, void *in, void *clover, void *cInv, const int dagger, const double kappa, const double mu,
 		       const QudaTwistFlavorType flavor, const int parity, QudaTwistGamma5Type twist, QudaPrecision precision) {
-  void *tmp1 = safe_malloc(Vh * spinor_site_size * precision);
-  void *tmp2 = safe_malloc(Vh * spinor_site_size * precision);
-
   double a = 0.0;
 
   if (twist == QUDA_TWIST_GAMMA5_DIRECT) {
@@ -223,23 +418,17 @@ void twistCloverGamma5(void *out, void *in, void *clover, void *cInv, const int
 
     if (dagger) a *= -1.0;
 
-    apply_clover(tmp1, clover, in, parity, precision);
-    applyTwist(out, in, tmp1, a, precision);
+    apply_twist_clover(out, nullptr, clover, nullptr, in, nullptr, parity, a, 0.0, precision);
   } else if (twist == QUDA_TWIST_GAMMA5_INVERSE) {
     a = -2.0 * kappa * mu * flavor;
 
     if (dagger) a *= -1.0;
 
-    apply_clover(tmp1, clover, in, parity, precision);
-    applyTwist(tmp2, in, tmp1, a, precision);
-    apply_clover(out, cInv, tmp2, parity, precision);
+    apply_twist_clover(out, nullptr, clover, cInv, in, nullptr, parity, a, 0.0, precision);
   } else {
     printf("Twist type %d not defined\n", twist);
     exit(0);
   }
-
-  host_free(tmp2);
-  host_free(tmp1);
 }
 
 // Apply (A + i*mu*gamma_5*tau3 - epsilon*tau1) for QUDA_TWIST_GAMMA5_DIRECT
@@ -248,9 +437,6 @@ void ndegTwistCloverGamma5(void *out1, void *out2, void *in1, void *in2, void *c
                            const double kappa, const double mu, const double epsilon, const int parity,
                            QudaTwistGamma5Type twist, QudaPrecision precision)
 {
-  void *tmp1 = safe_malloc(Vh * spinor_site_size * precision);
-  void *tmp2 = safe_malloc(Vh * spinor_site_size * precision);
-
   double a = 0.0, b = 0.0;
 
   if (twist == QUDA_TWIST_GAMMA5_DIRECT) {
@@ -259,47 +445,20 @@ void ndegTwistCloverGamma5(void *out1, void *out2, void *in1, void *in2, void *c
 
     if (dagger) a *= -1.0;
 
-    // apply_clover zeroes its output
-    apply_clover(tmp1, clover, in1, parity, precision);
-    apply_clover(tmp2, clover, in2, parity, precision);
-    // out = tmp + (i 2 kappa mu gamma_5 tau_3) * in
-    applyTwist(out1, in1, tmp1, a, precision);
-    applyTwist(out2, in2, tmp2, -a, precision);
-    // out += (-epsilon tau_1) * in
-    axpy(b, in2, out1, Vh * spinor_site_size, precision);
-    axpy(b, in1, out2, Vh * spinor_site_size, precision);
+    // out = C * in + (i 2 kappa mu gamma_5 tau_3 - epsilon tau_1) * in
+    apply_twist_clover(out1, out2, clover, nullptr, in1, in2, parity, a, b, precision);
   } else if (twist == QUDA_TWIST_GAMMA5_INVERSE) {
-    void *tmptmp1 = safe_malloc(Vh * spinor_site_size * precision);
-    void *tmptmp2 = safe_malloc(Vh * spinor_site_size * precision);
-
     a = -2.0 * kappa * mu;
     b = 2.0 * kappa * epsilon;
 
     if (dagger) a *= -1.0;
 
-    // tmp = C * in
-    apply_clover(tmp1, clover, in1, parity, precision);
-    apply_clover(tmp2, clover, in2, parity, precision);
-    // out = tmp - (i 2 kappa mu gamma_5 tau_3) * in
-    applyTwist(tmptmp1, in1, tmp1, a, precision);
-    applyTwist(tmptmp2, in2, tmp2, -a, precision);
-    // tmptmp += +(epsilon * tau_1) * in
-    axpy(b, in2, tmptmp1, Vh * spinor_site_size, precision);
-    axpy(b, in1, tmptmp2, Vh * spinor_site_size, precision);
-
     // out = (A - i 2 kappa mu gamma5 tau3 + epsilon tau1)/(A^2 + mu^2 - epsilon^2)
-    apply_clover(out1, cInv, tmptmp1, parity, precision);
-    apply_clover(out2, cInv, tmptmp2, parity, precision);
-
-    host_free(tmptmp1);
-    host_free(tmptmp2);
+    apply_twist_clover(out1, out2, clover, cInv, in1, in2, parity, a, b, precision);
   } else {
     printf("Twist type %d not defined\n", twist);
     exit(0);
   }
-
-  host_free(tmp2);
-  host_free(tmp1);
 }
 
 void tmc_dslash(void *out, void **gauge, void *in, void *clover, void *cInv, double kappa, double mu, QudaTwistFlavorType flavor,
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <math.h>
 #include <complex.h>
+#include <vector>
 
 #include <quda.h>
 #include <host_utils.h>
@@ -508,187 +509,147 @@ void dslashReference_5th(sFloat *res, sFloat *spinorField, int oddBit, int dagge
   }
 }
 
-//Currently we consider only spacetime decomposition (not in 5th dim), so this operator is local
-template <typename sFloat>
-void dslashReference_5th_inv(sFloat *res, sFloat *spinorField, int, int daggerBit, sFloat mferm, double *kappa)
+/**
+   @brief Build the Ls x Ls matrices in the fifth dimension (row major) of
+   the inverse of the domain-wall M5 operator, for the upper (P_+) and lower
+   (P_-) chiral halves of the spinor in the DeGrand-Rossi basis.  The
+   matrices are obtained by applying the LU recurrence of the inverse to the
+   identity, so the inverse can subsequently be applied to every 4-d site
+   with a small dense matrix product.
+   @param[out] M_plus Matrix applied to spin components 0 and 1
+   @param[out] M_minus Matrix applied to spin components 2 and 3
+   @param[in] kappa The per-slice kappa_s (real for Shamir, complex for Mobius)
+   @param[in] mferm The fermion mass
+   @param[in] daggerBit Whether to construct the inverse of the dagger
+ */
+static void m5InverseMatrix(std::vector<Complex> &M_plus, std::vector<Complex> &M_minus,
+                            const std::vector<Complex> &kappa, double mferm, int daggerBit)
 {
-  double *inv_Ftr = (double *)safe_malloc(Ls * sizeof(sFloat));
-  double *Ftr = (double *)safe_malloc(Ls * sizeof(sFloat));
-  for(int xs = 0 ; xs < Ls ; xs++)
-  {
-    inv_Ftr[xs] = 1.0/(1.0+pow(2.0*kappa[xs], Ls)*mferm);
-    Ftr[xs] = -2.0*kappa[xs]*mferm*inv_Ftr[xs]; 
-    for (int i = 0; i < Vh; i++) {
-      memcpy(&res[24*(i+Vh*xs)], &spinorField[24*(i+Vh*xs)], 24*sizeof(sFloat));
-    }
+  M_plus.assign(Ls * Ls, 0.0);
+  M_minus.assign(Ls * Ls, 0.0);
+  for (int s = 0; s < Ls; s++) M_plus[s * Ls + s] = M_minus[s * Ls + s] = 1.0;
+
+  // row operations of the recurrence: row(dst) += a * row(src), row(dst) *= a
+  auto axpy_row = [](std::vector<Complex> &M, Complex a, int src, int dst) {
+    for (int sp = 0; sp < Ls; sp++) M[dst * Ls + sp] += a * M[src * Ls + sp];
+  };
+  auto ax_row = [](std::vector<Complex> &M, Complex a, int dst) {
+    for (int sp = 0; sp < Ls; sp++) M[dst * Ls + sp] *= a;
+  };
+
+  std::vector<Complex> inv_Ftr(Ls), Ftr(Ls);
+  for (int xs = 0; xs < Ls; xs++) {
+    inv_Ftr[xs] = 1.0 / (1.0 + std::pow(2.0 * kappa[xs], Ls) * mferm);
+    Ftr[xs] = -2.0 * kappa[xs] * mferm * inv_Ftr[xs];
   }
-  if(daggerBit == 0)
-  {
-    // s = 0
-    for (int i = 0; i < Vh; i++) {
-      ax(&res[12+24*(i+Vh*(Ls-1))],(sFloat)(inv_Ftr[0]), &spinorField[12+24*(i+Vh*(Ls-1))], 12);
-    }
 
-    // s = 1 ... ls-2
-    for(int xs = 0 ; xs <= Ls-2 ; ++xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)(2.0*kappa[xs]), &res[24*(i+Vh*xs)], &res[24*(i+Vh*(xs+1))], 12);
-        axpy((sFloat)Ftr[xs], &res[12+24*(i+Vh*xs)], &res[12+24*(i+Vh*(Ls-1))], 12);
-      }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] *= 2.0*kappa[tmp_s];
-    }
-    for(int xs = 0 ; xs < Ls ; xs++)
-    {
-      Ftr[xs] = -pow(2.0*kappa[xs],Ls-1)*mferm*inv_Ftr[xs]; 
-    }
-    // s = ls-2 ... 0
-    for(int xs = Ls-2 ; xs >=0 ; --xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)Ftr[xs], &res[24*(i+Vh*(Ls-1))], &res[24*(i+Vh*xs)], 12);
-        axpy((sFloat)(2.0*kappa[xs]), &res[12+24*(i+Vh*(xs+1))], &res[12+24*(i+Vh*xs)], 12);
-      }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] /= 2.0*kappa[tmp_s];
-    }
-    // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax(&res[24*(i+Vh*(Ls-1))], (sFloat)(inv_Ftr[Ls-1]), &res[24*(i+Vh*(Ls-1))], 12);
-    }
+  // without the dagger the upper half is lower bidiagonal and the lower
+  // half picks up the wrap-around mass term, and vice versa with the dagger
+  std::vector<Complex> &M_fwd = daggerBit ? M_minus : M_plus;
+  std::vector<Complex> &M_wrap = daggerBit ? M_plus : M_minus;
+
+  ax_row(M_wrap, inv_Ftr[0], Ls - 1);
+  for (int xs = 0; xs <= Ls - 2; xs++) {
+    axpy_row(M_fwd, 2.0 * kappa[xs], xs, xs + 1);
+    axpy_row(M_wrap, Ftr[xs], xs, Ls - 1);
+    for (int t = 0; t < Ls; t++) Ftr[t] *= 2.0 * kappa[t];
   }
-  else
+
+  for (int xs = 0; xs < Ls; xs++) Ftr[xs] = -std::pow(2.0 * kappa[xs], Ls - 1) * mferm * inv_Ftr[xs];
+  for (int xs = Ls - 2; xs >= 0; xs--) {
+    axpy_row(M_fwd, Ftr[xs], Ls - 1, xs);
+    axpy_row(M_wrap, 2.0 * kappa[xs], xs + 1, xs);
+    for (int t = 0; t < Ls; t++) Ftr[t] /= 2.0 * kappa[t];
+  }
+  ax_row(M_fwd, inv_Ftr[Ls - 1], Ls - 1);
+}
+
+/**
+   @brief Apply chirality dependent Ls x Ls matrices in the fifth dimension
+   to a 4-d preconditioned spinor field, as a batch of small dense products
+   over the 4-d sites, which are distributed over threads.  The input of each
+   site is gathered before its output is written, so res may alias in.
+   @param[out] res The output spinor field
+   @param[in] in The input spinor field
+   @param[in] M_plus Matrix applied to spin components 0 and 1
+   @param[in] M_minus Matrix applied to spin components 2 and 3
+ */
+template <typename sFloat>
+void apply5thMatrix(sFloat *res, const sFloat *in, const std::vector<Complex> &M_plus,
+                    const std::vector<Complex> &M_minus)
+{
+  constexpr int half = 6; // complex components in each chiral half of a site
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
   {
-    // s = 0
+    std::vector<Complex> x(Ls * 2 * half), y(Ls * 2 * half);
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
     for (int i = 0; i < Vh; i++) {
-      ax(&res[24*(i+Vh*(Ls-1))],(sFloat)(inv_Ftr[0]), &spinorField[24*(i+Vh*(Ls-1))], 12);
-    }
+      for (int s = 0; s < Ls; s++) {
+        const sFloat *src = in + 24 * (i + Vh * s);
+        for (int c = 0; c < 2 * half; c++) x[s * 2 * half + c] = Complex(src[2 * c], src[2 * c + 1]);
+      }
 
-    // s = 1 ... ls-2
-    for(int xs = 0 ; xs <= Ls-2 ; ++xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)Ftr[xs], &res[24*(i+Vh*xs)], &res[24*(i+Vh*(Ls-1))], 12);
-        axpy((sFloat)(2.0*kappa[xs]), &res[12+24*(i+Vh*xs)], &res[12+24*(i+Vh*(xs+1))], 12);
+      for (int h = 0; h < 2; h++) {
+        const Complex *M = (h == 0 ? M_plus : M_minus).data();
+        for (int s = 0; s < Ls; s++) {
+          Complex *ys = &y[s * 2 * half + h * half];
+          for (int c = 0; c < half; c++) ys[c] = 0.0;
+          for (int sp = 0; sp < Ls; sp++) {
+            const Complex m = M[s * Ls + sp];
+            const Complex *xs = &x[sp * 2 * half + h * half];
+            for (int c = 0; c < half; c++) ys[c] += m * xs[c];
+          }
+        }
       }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] *= 2.0*kappa[tmp_s];
-    }
-    for(int xs = 0 ; xs < Ls ; xs++)
-    {
-      Ftr[xs] = -pow(2.0*kappa[xs],Ls-1)*mferm*inv_Ftr[xs]; 
-    }
-    // s = ls-2 ... 0
-    for(int xs = Ls-2 ; xs >=0 ; --xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)(2.0*kappa[xs]), &res[24*(i+Vh*(xs+1))], &res[24*(i+Vh*xs)], 12);
-        axpy((sFloat)Ftr[xs], &res[12+24*(i+Vh*(Ls-1))], &res[12+24*(i+Vh*xs)], 12);
+
+      for (int s = 0; s < Ls; s++) {
+        sFloat *dst = res + 24 * (i + Vh * s);
+        for (int c = 0; c < 2 * half; c++) {
+          dst[2 * c] = y[s * 2 * half + c].real();
+          dst[2 * c + 1] = y[s * 2 * half + c].imag();
+        }
       }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] /= 2.0*kappa[tmp_s];
-    }
-    // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax(&res[12+24*(i+Vh*(Ls-1))], (sFloat)(inv_Ftr[Ls-1]), &res[12+24*(i+Vh*(Ls-1))], 12);
     }
   }
-  host_free(inv_Ftr);
-  host_free(Ftr);
 }
 
-template <typename sComplex> sComplex cpow(const sComplex &x, int y)
+//Currently we consider only spacetime decomposition (not in 5th dim), so this operator is local
+template <typename sFloat>
+void dslashReference_5th_inv(sFloat *res, sFloat *spinorField, int, int daggerBit, sFloat mferm, double *kappa)
+{
+  std::vector<Complex> kappa_s(kappa, kappa + Ls);
+  std::vector<Complex> M_plus, M_minus;
+  m5InverseMatrix(M_plus, M_minus, kappa_s, mferm, daggerBit);
+  apply5thMatrix(res, spinorField, M_plus, M_minus);
+}
+
+template <typename sComplex> Complex toComplex(const sComplex &x)
 {
   static_assert(sizeof(sComplex) == sizeof(Complex), "C and C++ complex type sizes do not match");
   // note that C++ standard explicitly calls out that casting between C and C++ complex is legal
-  const Complex x_ = reinterpret_cast<const Complex &>(x);
-  Complex z_ = std::pow(x_, y);
-  sComplex z = reinterpret_cast<sComplex &>(z_);
-  return z;
+  return reinterpret_cast<const Complex &>(x);
 }
 
 // Currently we consider only spacetime decomposition (not in 5th dim), so this operator is local
 template <typename sFloat, typename sComplex>
 void mdslashReference_5th_inv(sFloat *res, sFloat *spinorField, int, int daggerBit, sFloat mferm, sComplex *kappa)
 {
-  sComplex *inv_Ftr = (sComplex *)safe_malloc(Ls * sizeof(sComplex));
-  sComplex *Ftr = (sComplex *)safe_malloc(Ls * sizeof(sComplex));
-  for (int xs = 0; xs < Ls; xs++) {
-    inv_Ftr[xs] = 1.0 / (1.0 + cpow(2.0 * kappa[xs], Ls) * mferm);
-    Ftr[xs] = -2.0 * kappa[xs] * mferm * inv_Ftr[xs];
-    for (int i = 0; i < Vh; i++) {
-      memcpy(&res[24 * (i + Vh * xs)], &spinorField[24 * (i + Vh * xs)], 24 * sizeof(sFloat));
-    }
-  }
-  if (daggerBit == 0) {
-    // s = 0
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], inv_Ftr[0],
-          (sComplex *)&spinorField[12 + 24 * (i + Vh * (Ls - 1))], 6);
-    }
-
-    // s = 1 ... ls-2
-    for (int xs = 0; xs <= Ls - 2; ++xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[24 * (i + Vh * xs)], (sComplex *)&res[24 * (i + Vh * (xs + 1))], 6);
-        axpy(Ftr[xs], (sComplex *)&res[12 + 24 * (i + Vh * xs)], (sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] *= 2.0 * kappa[tmp_s];
-    }
-    for (int xs = 0; xs < Ls; xs++) Ftr[xs] = -cpow(2.0 * kappa[xs], Ls - 1) * mferm * inv_Ftr[xs];
-
-    // s = ls-2 ... 0
-    for (int xs = Ls - 2; xs >= 0; --xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy(Ftr[xs], (sComplex *)&res[24 * (i + Vh * (Ls - 1))], (sComplex *)&res[24 * (i + Vh * xs)], 6);
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[12 + 24 * (i + Vh * (xs + 1))],
-            (sComplex *)&res[12 + 24 * (i + Vh * xs)], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] /= 2.0 * kappa[tmp_s];
-    }
-    // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[24 * (i + Vh * (Ls - 1))], inv_Ftr[Ls - 1], (sComplex *)&res[24 * (i + Vh * (Ls - 1))], 6);
-    }
-  } else {
-    // s = 0
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[24 * (i + Vh * (Ls - 1))], inv_Ftr[0], (sComplex *)&spinorField[24 * (i + Vh * (Ls - 1))], 6);
-    }
-
-    // s = 1 ... ls-2
-    for (int xs = 0; xs <= Ls - 2; ++xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy(Ftr[xs], (sComplex *)&res[24 * (i + Vh * xs)], (sComplex *)&res[24 * (i + Vh * (Ls - 1))], 6);
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[12 + 24 * (i + Vh * xs)],
-            (sComplex *)&res[12 + 24 * (i + Vh * (xs + 1))], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] *= 2.0 * kappa[tmp_s];
-    }
-    for (int xs = 0; xs < Ls; xs++) Ftr[xs] = -cpow(2.0 * kappa[xs], Ls - 1) * mferm * inv_Ftr[xs];
-
-    // s = ls-2 ... 0
-    for (int xs = Ls - 2; xs >= 0; --xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[24 * (i + Vh * (xs + 1))], (sComplex *)&res[24 * (i + Vh * xs)], 6);
-        axpy(Ftr[xs], (sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], (sComplex *)&res[12 + 24 * (i + Vh * xs)], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] /= 2.0 * kappa[tmp_s];
-    }
-    // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], inv_Ftr[Ls - 1],
-          (sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], 6);
-    }
-  }
-  host_free(inv_Ftr);
-  host_free(Ftr);
+  std::vector<Complex> kappa_s(Ls);
+  for (int xs = 0; xs < Ls; xs++) kappa_s[xs] = toComplex(kappa[xs]);
+  std::vector<Complex> M_plus, M_minus;
+  m5InverseMatrix(M_plus, M_minus, kappa_s, mferm, daggerBit);
+  apply5thMatrix(res, spinorField, M_plus, M_minus);
 }
 
 template <typename sFloat>
-void mdw_eofa_m5inv_ref(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit, sFloat mferm, sFloat m5, sFloat b,
-                        sFloat c, sFloat mq1, sFloat mq2, sFloat mq3, int eofa_pm, sFloat eofa_shift)
+void mdw_eofa_m5inv_ref(sFloat *res, sFloat *spinorField, int /*oddBit*/, int daggerBit, sFloat mferm, sFloat m5,
+                        sFloat b, sFloat c, sFloat mq1, sFloat mq2, sFloat mq3, int eofa_pm, sFloat eofa_shift)
 {
   // res: the output spinor field
   // spinorField: the input spinor field
@@ -702,14 +663,13 @@ void mdw_eofa_m5inv_ref(sFloat *res, sFloat *spinorField, int oddBit, int dagger
     / (std::pow(alpha + 1., Ls) + mq3 * std::pow(alpha - 1., Ls));
   sFloat kappa5 = (c * (4. + m5) - 1.) / (b * (4. + m5) + 1.); // alpha = b+c
 
-  using sComplex = double _Complex;
-
-  std::vector<sComplex> kappa_array(Ls, -0.5 * kappa5);
+  std::vector<Complex> kappa_array(Ls, -0.5 * kappa5);
   std::vector<sFloat> eofa_u(Ls);
   std::vector<sFloat> eofa_x(Ls);
   std::vector<sFloat> eofa_y(Ls);
 
-  mdslashReference_5th_inv(res, spinorField, oddBit, daggerBit, mferm, kappa_array.data());
+  std::vector<Complex> M_plus, M_minus;
+  m5InverseMatrix(M_plus, M_minus, kappa_array, mferm, daggerBit);
 
   sFloat N = (eofa_pm ? +1. : -1.) * (2. * eofa_shift * eofa_norm)
     * (std::pow(alpha + 1., Ls) + mq1 * std::pow(alpha - 1., Ls)) / (b * (m5 + 4.) + 1.);
@@ -755,29 +715,17 @@ void mdw_eofa_m5inv_ref(sFloat *res, sFloat *spinorField, int oddBit, int dagger
   }
   sherman_morrison_fac = -0.5 / (1. + sherman_morrison_fac); // 0.5 for the spin project factor
 
-  // The EOFA stuff
-  for (int idx_cb_4d = 0; idx_cb_4d < Vh; idx_cb_4d++) {
-    for (int s = 0; s < Ls; s++) {
-      for (int sp = 0; sp < Ls; sp++) {
-        sFloat t = 2.0 * sherman_morrison_fac;
-        if (daggerBit == 0) {
-          t *= eofa_x[s] * eofa_y[sp];
-          if (eofa_pm) {
-            axpby_ssp_project<true>(res, (sFloat)1., res, t, spinorField, idx_cb_4d, s, sp);
-          } else {
-            axpby_ssp_project<false>(res, (sFloat)1., res, t, spinorField, idx_cb_4d, s, sp);
-          }
-        } else {
-          t *= eofa_y[s] * eofa_x[sp];
-          if (eofa_pm) {
-            axpby_ssp_project<true>(res, (sFloat)1., res, t, spinorField, idx_cb_4d, s, sp);
-          } else {
-            axpby_ssp_project<false>(res, (sFloat)1., res, t, spinorField, idx_cb_4d, s, sp);
-          }
-        }
-      }
+  // The EOFA stuff: a rank-one correction to the chiral half selected by eofa_pm
+  std::vector<Complex> &M_eofa = eofa_pm ? M_plus : M_minus;
+  for (int s = 0; s < Ls; s++) {
+    for (int sp = 0; sp < Ls; sp++) {
+      sFloat t = 2.0 * sherman_morrison_fac;
+      t *= daggerBit == 0 ? eofa_x[s] * eofa_y[sp] : eofa_y[s] * eofa_x[sp];
+      M_eofa[s * Ls + sp] += t;
     }
   }
+
+  apply5thMatrix(res, spinorField, M_plus, M_minus);
 }
 
 void mdw_eofa_m5inv(void *res, void *spinorField, int oddBit, int daggerBit, double mferm, double m5, double b, double c,
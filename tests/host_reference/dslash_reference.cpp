@@ -10,6 +10,8 @@
 #include <staggered_dslash_reference.h>
 #include <command_line_params.h>
 
+#include <map>
+
 // Overload for workflows without multishift
 void verifyInversion(void *spinorOut, void *spinorIn, void *spinorCheck, QudaGaugeParam &gauge_param,
                      QudaInvertParam &inv_param, void **gauge, void *clover, void *clover_inv)
@@ -405,8 +407,7 @@ void verifyWilsonTypeInversion(void *spinorOut, void **spinorOutMulti, void *spi
 
 void verifyStaggeredInversion(quda::ColorSpinorField &tmp, quda::ColorSpinorField &ref, quda::ColorSpinorField &in,
                               quda::ColorSpinorField &out, double mass, void *qdp_fatlink[], void *qdp_longlink[],
-                              void **ghost_fatlink, void **ghost_longlink, QudaGaugeParam &gauge_param,
-                              QudaInvertParam &inv_param, int shift)
+                              QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, int shift)
 {
 
   switch (test_type) {
@@ -418,10 +419,10 @@ void verifyStaggeredInversion(quda::ColorSpinorField &tmp, quda::ColorSpinorFiel
     // {{m, -D_eo},{-D_oe,m}}, while the CPU verify function does not
     // have the minus sign. Passing in QUDA_DAG_YES solves this
     // discrepancy.
-    staggeredDslash(ref.Even(), qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink, out.Odd(), QUDA_EVEN_PARITY,
-                    QUDA_DAG_YES, inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
-    staggeredDslash(ref.Odd(), qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink, out.Even(), QUDA_ODD_PARITY,
-                    QUDA_DAG_YES, inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
+    staggeredDslash(ref.Even(), qdp_fatlink, qdp_longlink, out.Odd(), QUDA_EVEN_PARITY, QUDA_DAG_YES,
+                    inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
+    staggeredDslash(ref.Odd(), qdp_fatlink, qdp_longlink, out.Even(), QUDA_ODD_PARITY, QUDA_DAG_YES,
+                    inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
 
     if (dslash_type == QUDA_LAPLACE_DSLASH) {
       xpay(out.V(), kappa, ref.V(), ref.Length(), gauge_param.cpu_prec);
@@ -436,8 +437,7 @@ void verifyStaggeredInversion(quda::ColorSpinorField &tmp, quda::ColorSpinorFiel
   case 5: // multi mass CG, even parity solution, solving EVEN system
   case 6: // multi mass CG, odd parity solution, solving ODD system
 
-    staggeredMatDagMat(ref, qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink, out, mass, 0, inv_param.cpu_prec,
-                       gauge_param.cpu_prec, tmp,
+    staggeredMatDagMat(ref, qdp_fatlink, qdp_longlink, out, mass, 0, inv_param.cpu_prec, gauge_param.cpu_prec, tmp,
                        (test_type == 3 || test_type == 5) ? QUDA_EVEN_PARITY : QUDA_ODD_PARITY, dslash_type);
     break;
   }
@@ -470,3 +470,50 @@ void verifyStaggeredInversion(quda::ColorSpinorField &tmp, quda::ColorSpinorFiel
     }
   }
 }
+
+bool NeighborTable::valid() const
+{
+  if (ls != Ls) return false;
+  for (int d = 0; d < 4; d++)
+    if (dims[d] != Z[d]) return false;
+  return true;
+}
+
+void NeighborTable::build(int hop_)
+{
+  hop = hop_;
+  ls = Ls;
+  for (int d = 0; d < 4; d++) dims[d] = Z[d];
+
+  for (int parity = 0; parity < 2; parity++) {
+    spinor_index[parity].resize(Vh * 8);
+    link_index[parity].resize(Vh * 8);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < Vh; i++) {
+      int Y = fullLatticeIndex(i, parity);
+      int x[4] = {Y % Z[0], (Y / Z[0]) % Z[1], (Y / (Z[1] * Z[0])) % Z[2], Y / (Z[2] * Z[1] * Z[0])};
+
+      for (int dir = 0; dir < 8; dir++) {
+        const int mu = dir / 2;
+        const bool fwd = dir % 2 == 0;
+        const int k = i * 8 + dir;
+        int y[4] = {x[0], x[1], x[2], x[3]};
+        y[mu] = (y[mu] + (fwd ? hop : -hop) + Z[mu]) % Z[mu];
+        int j = (((y[3] * Z[2] + y[2]) * Z[1] + y[1]) * Z[0] + y[0]) / 2;
+        spinor_index[parity][k] = j;
+        link_index[parity][k] = fwd ? i : j;
+      }
+    }
+  }
+}
+
+const NeighborTable &neighborTable(int hop)
+{
+  static std::map<int, NeighborTable> tables;
+  NeighborTable &table = tables[hop];
+  if (table.hop != hop || !table.valid()) table.build(hop);
+  return table;
+}
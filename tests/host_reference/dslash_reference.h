@@ -103,8 +103,39 @@ void verifyWilsonTypeInversion(void *spinorOut, void **spinorOutMulti, void *spi
 
 void verifyStaggeredInversion(quda::ColorSpinorField &tmp, quda::ColorSpinorField &ref, quda::ColorSpinorField &in,
                               quda::ColorSpinorField &out, double mass, void *qdp_fatlink[], void *qdp_longlink[],
-                              void **ghost_fatlink, void **ghost_longlink, QudaGaugeParam &gauge_param,
-                              QudaInvertParam &inv_param, int shift);
+                              QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, int shift);
+
+/**
+   @brief Table of the neighbors at a given hop distance of every site of
+   each parity, in each of the eight directions (+x, -x, ..., -t), for the
+   single-process host reference operators (the multi-process ones
+   address their neighbors in extended fields instead).  The link index
+   locates the link connecting a site to its backward neighbor.  Tables
+   are cached by neighborTable, and are rebuilt when the local volume
+   changes.
+ */
+struct NeighborTable {
+  int hop = 0;
+  int dims[4] = {0, 0, 0, 0};
+  int ls = 0;
+  std::vector<int> spinor_index[2]; // [parity][i * 8 + dir] neighbor half index for the first 4-d slice
+  std::vector<int> link_index[2];   // [parity][i * 8 + dir] index of the backward link (odd dir only)
+
+  bool valid() const;
+  void build(int hop);
+
+  /**
+     @brief Return the index of the neighbor of a site in 4-d slice xs
+     (the fifth dimension or source index, with 4-d preconditioning)
+  */
+  int spinor(int parity, int i, int dir, int xs) const { return spinor_index[parity][i * 8 + dir] + xs * Vh; }
+};
+
+/**
+   @brief Return the neighbor table for the given hop distance, building
+   it if needed
+ */
+const NeighborTable &neighborTable(int hop);
 
 // i represents a "half index" into an even or odd "half lattice".
 // when oddBit={0,1} the half lattice is {even,odd}.
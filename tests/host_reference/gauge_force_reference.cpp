@@ -3,6 +3,8 @@
 #include <math.h>
 #include <string.h>
 #include <type_traits>
+#include <vector>
+#include <map>
 
 #include "quda.h"
 #include "gauge_field.h"
@@ -275,61 +277,112 @@ int gf_neighborIndexFullLattice(size_t i, int dx[], const lattice_t &lat)
   return ret;
 }
 
-// this function compute one path for all lattice sites
-template <typename su3_matrix, typename Float>
-static void compute_path_product(su3_matrix *staple, su3_matrix **sitelink, int *path, int len, Float loop_coeff,
-                                 int dir, const lattice_t &lat)
-{
-  su3_matrix prev_matrix, curr_matrix, tmat;
-  int dx[4];
+/**
+   Prefix tree of the paths for one direction.  Each node is a distinct
+   path prefix, and holds the link that is multiplied onto the product of
+   its parent prefix, so sub-paths shared between paths (e.g., the
+   plaquette staples that prefix the rectangles and chairs) are only
+   computed once per site.  Children are always created after their
+   parent, so the nodes may be evaluated in index order.
+*/
+struct path_tree_t {
+  struct node_t {
+    int parent;    // parent prefix (-1 for the empty prefix at the root)
+    bool forwards; // whether the link is traversed forwards
+    int lnkdir;    // direction of the link
+    int dx[4];     // displacement of the link from the site
+    int pos[4];    // displacement of the end of the prefix from the site
+  };
 
-  for (size_t i = 0; i < lat.volume; i++) {
-    memset(dx, 0, sizeof(dx));
-    memset(&curr_matrix, 0, sizeof(curr_matrix));
-
-    curr_matrix.e[0][0].real = 1.0;
-    curr_matrix.e[1][1].real = 1.0;
-    curr_matrix.e[2][2].real = 1.0;
-
-    dx[dir] = 1;
-    for (int j = 0; j < len; j++) {
-      int lnkdir;
-
-      prev_matrix = curr_matrix;
-      if (GOES_FORWARDS(path[j])) {
-        // dx[path[j]] +=1;
-        lnkdir = path[j];
-      } else {
-        dx[OPP_DIR(path[j])] -= 1;
-        lnkdir = OPP_DIR(path[j]);
+  std::vector<node_t> node;
+  std::vector<int> leaf; // node holding the complete product of each path
+
+  path_tree_t(int **path, const int *length, int num_paths, int dir) : leaf(num_paths)
+  {
+    node_t root = {-1, true, dir, {0, 0, 0, 0}, {0, 0, 0, 0}};
+    root.pos[dir] = 1; // paths start at the end of the link being updated
+    node.push_back(root);
+
+    std::map<std::pair<int, int>, int> child;
+    for (int p = 0; p < num_paths; p++) {
+      int curr = 0;
+      for (int j = 0; j < length[p]; j++) {
+        auto key = std::make_pair(curr, path[p][j]);
+        auto it = child.find(key);
+        if (it != child.end()) {
+          curr = it->second;
+          continue;
+        }
+
+        node_t n = node[curr];
+        n.parent = curr;
+        n.forwards = GOES_FORWARDS(path[p][j]);
+        n.lnkdir = n.forwards ? path[p][j] : OPP_DIR(path[p][j]);
+        if (n.forwards) {
+          for (int d = 0; d < 4; d++) n.dx[d] = n.pos[d];
+          n.pos[n.lnkdir]++;
+        } else {
+          n.pos[n.lnkdir]--;
+          for (int d = 0; d < 4; d++) n.dx[d] = n.pos[d];
+        }
+
+        curr = child[key] = node.size();
+        node.push_back(n);
       }
+      leaf[p] = curr;
+    }
+  }
+};
 
-      int nbr_idx = gf_neighborIndexFullLattice(i, dx, lat);
-      su3_matrix *lnk = sitelink[lnkdir] + nbr_idx;
+// this function computes all paths for one direction for all lattice sites
+template <typename su3_matrix, typename Float>
+static void compute_path_product(su3_matrix *staple, su3_matrix **sitelink, const path_tree_t &tree,
+                                 const Float *loop_coeff, const lattice_t &lat)
+{
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<su3_matrix> prod(tree.node.size());
+    su3_matrix tmat;
 
-      if (GOES_FORWARDS(path[j])) {
-        mult_su3_nn(&prev_matrix, lnk, &curr_matrix);
-      } else {
-        mult_su3_na(&prev_matrix, lnk, &curr_matrix);
+    memset(&prod[0], 0, sizeof(su3_matrix));
+    prod[0].e[0][0].real = 1.0;
+    prod[0].e[1][1].real = 1.0;
+    prod[0].e[2][2].real = 1.0;
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (size_t i = 0; i < lat.volume; i++) {
+      for (auto n = 1u; n < tree.node.size(); n++) {
+        auto &node = tree.node[n];
+        int dx[4] = {node.dx[0], node.dx[1], node.dx[2], node.dx[3]};
+        su3_matrix *lnk = sitelink[node.lnkdir] + gf_neighborIndexFullLattice(i, dx, lat);
+
+        if (node.forwards) {
+          mult_su3_nn(&prod[node.parent], lnk, &prod[n]);
+        } else {
+          mult_su3_na(&prod[node.parent], lnk, &prod[n]);
+        }
       }
 
-      if (GOES_FORWARDS(path[j])) {
-        dx[path[j]] += 1;
-      } else {
-        // we already substract one in the code above
+      // accumulate in path order
+      for (auto p = 0u; p < tree.leaf.size(); p++) {
+        su3_adjoint(&prod[tree.leaf[p]], &tmat);
+        scalar_mult_add_su3_matrix(staple + i, &tmat, loop_coeff[p], staple + i);
       }
-
-    } // j
-
-    su3_adjoint(&curr_matrix, &tmat);
-    scalar_mult_add_su3_matrix(staple + i, &tmat, loop_coeff, staple + i);
-  } // i
+    } // i
+  }
 }
 
 template <typename su3_matrix, typename anti_hermitmat, typename Float>
 static void update_mom(anti_hermitmat *momentum, int dir, su3_matrix **sitelink, su3_matrix *staple, Float eb3,
                        const lattice_t &lat)
 {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (size_t i = 0; i < lat.volume; i++) {
     su3_matrix tmat1;
     su3_matrix tmat2;
@@ -351,6 +404,9 @@ template <typename su3_matrix, typename Float>
 static void update_gauge(su3_matrix *gauge, int dir, su3_matrix **sitelink, su3_matrix *staple, Float eb3,
                          const lattice_t &lat)
 {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (size_t i = 0; i < lat.volume; i++) {
     su3_matrix tmat;
 
@@ -375,16 +431,11 @@ void gauge_force_reference_dir(void *refMom, int dir, double eb3, void **sitelin
   void *staple = safe_malloc(size);
   memset(staple, 0, size);
 
-  for (int i = 0; i < num_paths; i++) {
-    if (prec == QUDA_DOUBLE_PRECISION) {
-      double *my_loop_coeff = (double *)loop_coeff;
-      compute_path_product((dsu3_matrix *)staple, (dsu3_matrix **)sitelink_ex, path_dir[i], length[i], my_loop_coeff[i],
-                           dir, lat);
-    } else {
-      float *my_loop_coeff = (float *)loop_coeff;
-      compute_path_product((fsu3_matrix *)staple, (fsu3_matrix **)sitelink_ex, path_dir[i], length[i], my_loop_coeff[i],
-                           dir, lat);
-    }
+  path_tree_t tree(path_dir, length, num_paths, dir);
+  if (prec == QUDA_DOUBLE_PRECISION) {
+    compute_path_product((dsu3_matrix *)staple, (dsu3_matrix **)sitelink_ex, tree, (double *)loop_coeff, lat);
+  } else {
+    compute_path_product((fsu3_matrix *)staple, (fsu3_matrix **)sitelink_ex, tree, (float *)loop_coeff, lat);
   }
 
   if (compute_force) {
@@ -3,6 +3,9 @@
 #include <math.h>
 #include <string.h>
 #include <type_traits>
+#include <array>
+#include <map>
+#include <vector>
 
 #include <quda.h>
 #include <host_utils.h>
@@ -114,8 +117,11 @@ template <typename su3_vector, typename su3_matrix> void su3_projector(su3_vecto
 template <typename half_wilson_vector, typename su3_matrix>
 void computeLinkOrderedOuterProduct(half_wilson_vector *src, su3_matrix *dest, int gauge_order)
 {
-  int dx[4];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < V; ++i) {
+    int dx[4];
     for (int dir = 0; dir < 4; dir++) {
       dx[3] = dx[2] = dx[1] = dx[0] = 0;
       dx[dir] = 1;
@@ -130,8 +136,11 @@ void computeLinkOrderedOuterProduct(half_wilson_vector *src, su3_matrix *dest, i
 template <typename half_wilson_vector, typename su3_matrix>
 void computeLinkOrderedOuterProduct(half_wilson_vector *src, su3_matrix *dest, size_t nhops, int gauge_order)
 {
-  int dx[4];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < V; ++i) {
+    int dx[4];
     for (int dir = 0; dir < 4; ++dir) {
       dx[3] = dx[2] = dx[1] = dx[0] = 0;
       dx[dir] = nhops;
@@ -795,27 +804,91 @@ template <int oddBit> int Locator<oddBit>::getNeighborFromFullIndex(int full_lat
   return neighbor_index;
 }
 
-// Can't typedef a template
-template <class Real> struct ColorMatrix {
-  typedef Matrix<3, std::complex<Real>> Type;
+/**
+   Index maps of the local (extended if MULTI_GPU) lattice, computed once
+   per lattice size so that the field kernels below do not have to
+   recompute site coordinates for every access: the neighbors of every
+   half-lattice site in each of the eight directions, whether that
+   neighbor lies outside of the extended lattice, and the extended index
+   of every site of the normal lattice.
+*/
+struct IndexTable {
+  int half_volume;            // number of sites per parity that the kernels loop over
+  std::vector<int> nbr[2][8]; // half-lattice index of the neighbor (of opposite parity)
+  std::vector<char> err[2][8];
+  std::vector<int> ex[2]; // extended half-lattice index of each normal site
+
+  int neighbor(int oddBit, int half_lattice_index, int dir, int *error = nullptr) const
+  {
+    if (error) *error = err[oddBit][dir][half_lattice_index];
+    return nbr[oddBit][dir][half_lattice_index];
+  }
+
+  int normal2ex(int oddBit, int half_lattice_index) const { return ex[oddBit][half_lattice_index]; }
 };
 
-template <class Real, int oddBit>
-void computeOneLinkSite(
+template <int oddBit> void buildIndexTable(const int dim[4], IndexTable &table)
+{
+  Locator<oddBit> locator(dim);
+  for (int dir = 0; dir < 8; dir++) {
+    table.nbr[oddBit][dir].resize(table.half_volume);
+    table.err[oddBit][dir].resize(table.half_volume);
+  }
+
+  for (int site = 0; site < table.half_volume; site++) {
+    int X = locator.getFullFromHalfIndex(site);
+    for (int dir = 0; dir < 8; dir++) {
+      int err;
+      table.nbr[oddBit][dir][site] = locator.getNeighborFromFullIndex(X, dir, &err) >> 1;
+      table.err[oddBit][dir][site] = err;
+    }
+  }
+
+  const int volume = dim[0] * dim[1] * dim[2] * dim[3];
+  LoadStore<double> ls(volume);
+  table.ex[oddBit].resize(volume / 2);
+  for (int site = 0; site < volume / 2; site++) {
 #ifdef MULTI_GPU
-  const int dim[4],
+    table.ex[oddBit][site] = ls.half_idx_conversion_normal2ex(site, dim, oddBit);
 #else
-  const int[],
+    table.ex[oddBit][site] = site;
 #endif
-  int half_lattice_index, const Real *const oprod, int sig, Real coeff, const LoadStore<Real> &ls, Real *const output)
+  }
+}
+
+// Return the index maps for the local lattice dimensions dim, which are
+// built on first use (not thread safe, so call outside of parallel regions)
+const IndexTable &indexTable(const int dim[4])
 {
-  if (GOES_FORWARDS(sig)) {
-    typename ColorMatrix<Real>::Type colorMatW;
+  static std::map<std::array<int, 4>, IndexTable> tables;
+  std::array<int, 4> key = {dim[0], dim[1], dim[2], dim[3]};
+
+  auto it = tables.find(key);
+  if (it != tables.end()) return it->second;
+
+  IndexTable &table = tables[key];
 #ifdef MULTI_GPU
-    int idx = ls.half_idx_conversion_normal2ex(half_lattice_index, dim, oddBit);
+  table.half_volume = Vh_ex;
 #else
-    int idx = half_lattice_index;
+  table.half_volume = dim[0] * dim[1] * dim[2] * dim[3] / 2;
 #endif
+  buildIndexTable<0>(dim, table);
+  buildIndexTable<1>(dim, table);
+  return table;
+}
+
+// Can't typedef a template
+template <class Real> struct ColorMatrix {
+  typedef Matrix<3, std::complex<Real>> Type;
+};
+
+template <class Real, int oddBit>
+void computeOneLinkSite(int half_lattice_index, const Real *const oprod, int sig, Real coeff, const LoadStore<Real> &ls,
+                        const IndexTable &index, Real *const output)
+{
+  if (GOES_FORWARDS(sig)) {
+    typename ColorMatrix<Real>::Type colorMatW;
+    int idx = index.normal2ex(oddBit, half_lattice_index);
     ls.loadMatrixFromField(oprod, oddBit, sig, idx, &colorMatW);
     ls.addMatrixToField(colorMatW, oddBit, sig, idx, coeff, output);
   }
@@ -828,43 +901,45 @@ void computeOneLinkField(const int dim[4], const Real *const oprod, int sig, Rea
   for (int dir = 0; dir < 4; ++dir) volume *= dim[dir];
   const int half_volume = volume / 2;
   LoadStore<Real> ls(volume);
+  const IndexTable &index = indexTable(dim);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < half_volume; ++site) {
-    computeOneLinkSite<Real, 0>(dim, site, oprod, sig, coeff, ls, output);
+    computeOneLinkSite<Real, 0>(site, oprod, sig, coeff, ls, index, output);
   }
   // Loop over odd lattice sites
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < half_volume; ++site) {
-    computeOneLinkSite<Real, 1>(dim, site, oprod, sig, coeff, ls, output);
+    computeOneLinkSite<Real, 1>(site, oprod, sig, coeff, ls, index, output);
   }
 }
 
 // middleLinkKernel compiles for now, but lots of debugging to be done
 template <class Real, int oddBit>
 void computeMiddleLinkSite(int half_lattice_index, // half_lattice_index to better match the GPU code.
-                           const int dim[4], const Real *const oprod, const Real *const Qprev, const Real *const link,
+                           const Real *const oprod, const Real *const Qprev, const Real *const link,
                            int sig, int mu, Real coeff,
                            const LoadStore<Real> &ls, // pass a function object to read from and write to matrix fields
-                           Real *const Pmu, Real *const P3, Real *const Qmu, Real *const newOprod)
+                           const IndexTable &index, Real *const Pmu, Real *const P3, Real *const Qmu,
+                           Real *const newOprod)
 {
   const bool mu_positive = (GOES_FORWARDS(mu)) ? true : false;
   const bool sig_positive = (GOES_FORWARDS(sig)) ? true : false;
 
-  Locator<oddBit> locator(dim);
   int point_b, point_c, point_d;
   int ad_link_nbr_idx, ab_link_nbr_idx, bc_link_nbr_idx;
-  int X = locator.getFullFromHalfIndex(half_lattice_index);
 
   int err;
-  int new_mem_idx = locator.getNeighborFromFullIndex(X, OPP_DIR(mu), &err);
+  point_d = index.neighbor(oddBit, half_lattice_index, OPP_DIR(mu), &err);
   RETURN_IF_ERR;
-  point_d = new_mem_idx >> 1;
-  // getNeighborFromFullIndex will work on any site on the lattice, odd or even
-  new_mem_idx = locator.getNeighborFromFullIndex(new_mem_idx, sig, &err);
+  // point_d has the opposite parity
+  point_c = index.neighbor(1 - oddBit, point_d, sig, &err);
   RETURN_IF_ERR;
-  point_c = new_mem_idx >> 1;
 
-  new_mem_idx = locator.getNeighborFromFullIndex(X, sig);
-  RETURN_IF_ERR;
-  point_b = new_mem_idx >> 1;
+  point_b = index.neighbor(oddBit, half_lattice_index, sig);
 
   ad_link_nbr_idx = (mu_positive) ? point_d : half_lattice_index;
   bc_link_nbr_idx = (mu_positive) ? point_c : point_b;
@@ -941,36 +1016,40 @@ void computeMiddleLinkField(const int dim[4], const Real *const oprod, const Rea
   // To keep the code as close to the GPU code as possible, we'll
   // loop over the even sites first and then the odd sites
   LoadStore<Real> ls(volume);
+  const IndexTable &index = indexTable(dim);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < loop_count; ++site) {
-    computeMiddleLinkSite<Real, 0>(site, dim, oprod, Qprev, link, sig, mu, coeff, ls, Pmu, P3, Qmu, newOprod);
+    computeMiddleLinkSite<Real, 0>(site, oprod, Qprev, link, sig, mu, coeff, ls, index, Pmu, P3, Qmu, newOprod);
   }
   // Loop over odd lattice sites
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < loop_count; ++site) {
-    computeMiddleLinkSite<Real, 1>(site, dim, oprod, Qprev, link, sig, mu, coeff, ls, Pmu, P3, Qmu, newOprod);
+    computeMiddleLinkSite<Real, 1>(site, oprod, Qprev, link, sig, mu, coeff, ls, index, Pmu, P3, Qmu, newOprod);
   }
 }
 
 template <class Real, int oddBit>
 void computeSideLinkSite(int half_lattice_index, // half_lattice_index to better match the GPU code.
-                         const int dim[4], const Real *const P3,
+                         const Real *const P3,
                          const Real *const Qprod, // why?
                          const Real *const link, int sig, int mu, Real coeff, Real accumu_coeff,
                          const LoadStore<Real> &ls, // pass a function object to read from and write to matrix fields
-                         Real *const shortP, Real *const newOprod)
+                         const IndexTable &index, Real *const shortP, Real *const newOprod)
 {
 
   const bool mu_positive = (GOES_FORWARDS(mu)) ? true : false;
   const bool sig_positive = (GOES_FORWARDS(sig)) ? true : false;
 
-  Locator<oddBit> locator(dim);
   int point_d;
   int ad_link_nbr_idx;
-  int X = locator.getFullFromHalfIndex(half_lattice_index);
 
   int err;
-  int new_mem_idx = locator.getNeighborFromFullIndex(X, OPP_DIR(mu), &err);
+  point_d = index.neighbor(oddBit, half_lattice_index, OPP_DIR(mu), &err);
   RETURN_IF_ERR;
-  point_d = new_mem_idx >> 1;
   ad_link_nbr_idx = (mu_positive) ? point_d : half_lattice_index;
 
   typename ColorMatrix<Real>::Type ad_link;
@@ -1034,22 +1113,29 @@ void computeSideLinkField(const int dim[4], const Real *const P3,
   const int loop_count = volume / 2;
 #endif
   LoadStore<Real> ls(volume);
+  const IndexTable &index = indexTable(dim);
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < loop_count; ++site) {
-    computeSideLinkSite<Real, 0>(site, dim, P3, Qprod, link, sig, mu, coeff, accumu_coeff, ls, shortP, newOprod);
+    computeSideLinkSite<Real, 0>(site, P3, Qprod, link, sig, mu, coeff, accumu_coeff, ls, index, shortP, newOprod);
   }
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < loop_count; ++site) {
-    computeSideLinkSite<Real, 1>(site, dim, P3, Qprod, link, sig, mu, coeff, accumu_coeff, ls, shortP, newOprod);
+    computeSideLinkSite<Real, 1>(site, P3, Qprod, link, sig, mu, coeff, accumu_coeff, ls, index, shortP, newOprod);
   }
 }
 
 template <class Real, int oddBit>
 void computeAllLinkSite(int half_lattice_index, // half_lattice_index to better match the GPU code.
-                        const int dim[4], const Real *const oprod, const Real *const Qprev, const Real *const link,
+                        const Real *const oprod, const Real *const Qprev, const Real *const link,
                         int sig, int mu, Real coeff, Real accumu_coeff,
                         const LoadStore<Real> &ls, // pass a function object to read from and write to matrix fields
-                        Real *const shortP, Real *const newOprod)
+                        const IndexTable &index, Real *const shortP, Real *const newOprod)
 {
 
   const bool mu_positive = (GOES_FORWARDS(mu)) ? true : false;
@@ -1060,21 +1146,15 @@ void computeAllLinkSite(int half_lattice_index, // half_lattice_index to better
 
   int ab_link_nbr_idx, point_b, point_c, point_d;
 
-  Locator<oddBit> locator(dim);
-  int X = locator.getFullFromHalfIndex(half_lattice_index);
-
   int err;
-  int new_mem_idx = locator.getNeighborFromFullIndex(X, OPP_DIR(mu), &err);
+  point_d = index.neighbor(oddBit, half_lattice_index, OPP_DIR(mu), &err);
   RETURN_IF_ERR;
-  point_d = new_mem_idx >> 1;
 
-  new_mem_idx = locator.getNeighborFromFullIndex(new_mem_idx, sig, &err);
+  point_c = index.neighbor(1 - oddBit, point_d, sig, &err);
   RETURN_IF_ERR;
-  point_c = new_mem_idx >> 1;
 
-  new_mem_idx = locator.getNeighborFromFullIndex(X, sig, &err);
+  point_b = index.neighbor(oddBit, half_lattice_index, sig, &err);
   RETURN_IF_ERR;
-  point_b = new_mem_idx >> 1;
   ab_link_nbr_idx = (sig_positive) ? half_lattice_index : point_b;
 
   Real mycoeff = ((sig_positive && oddBit) || (!sig_positive && !oddBit)) ? coeff : -coeff;
@@ -1145,13 +1225,21 @@ void computeAllLinkField(const int dim[4], const Real *const oprod, const Real *
 #endif
 
   LoadStore<Real> ls(volume);
+  const IndexTable &index = indexTable(dim);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < loop_count; ++site) {
-
-    computeAllLinkSite<Real, 0>(site, dim, oprod, Qprev, link, sig, mu, coeff, accumu_coeff, ls, shortP, newOprod);
+    computeAllLinkSite<Real, 0>(site, oprod, Qprev, link, sig, mu, coeff, accumu_coeff, ls, index, shortP,
+                                newOprod);
   }
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < loop_count; ++site) {
-    computeAllLinkSite<Real, 1>(site, dim, oprod, Qprev, link, sig, mu, coeff, accumu_coeff, ls, shortP, newOprod);
+    computeAllLinkSite<Real, 1>(site, oprod, Qprev, link, sig, mu, coeff, accumu_coeff, ls, index, shortP,
+                                newOprod);
   }
 }
 
@@ -1282,37 +1370,22 @@ void hisqStaplesForceCPU(const double *path_coeff, const QudaGaugeParam &param,
 }
 
 template <class Real, int oddBit>
-void computeLongLinkSite(int half_lattice_index, const int dim[4], const Real *const oprod, const Real *const link,
-                         int sig, Real coeff, const LoadStore<Real> &ls, Real *const output)
+void computeLongLinkSite(int half_lattice_index, const Real *const oprod, const Real *const link, int sig, Real coeff,
+                         const LoadStore<Real> &ls, const IndexTable &index, Real *const output)
 {
   if (GOES_FORWARDS(sig)) {
 
-    Locator<oddBit> locator(dim);
-
     typename ColorMatrix<Real>::Type ab_link, bc_link, de_link, ef_link;
     typename ColorMatrix<Real>::Type colorMatU, colorMatV, colorMatW, colorMatX, colorMatY, colorMatZ;
 
     int point_a, point_b, point_c, point_d, point_e;
-#ifdef MULTI_GPU
-    int idx = ls.half_idx_conversion_normal2ex(half_lattice_index, dim, oddBit);
-#else
-    int idx = half_lattice_index;
-#endif
-
-    int X = locator.getFullFromHalfIndex(idx);
+    int idx = index.normal2ex(oddBit, half_lattice_index);
     point_c = idx;
 
-    int new_mem_idx = locator.getNeighborFromFullIndex(X, sig);
-    point_d = new_mem_idx >> 1;
-
-    new_mem_idx = locator.getNeighborFromFullIndex(new_mem_idx, sig);
-    point_e = new_mem_idx >> 1;
-
-    new_mem_idx = locator.getNeighborFromFullIndex(X, OPP_DIR(sig));
-    point_b = new_mem_idx >> 1;
-
-    new_mem_idx = locator.getNeighborFromFullIndex(new_mem_idx, OPP_DIR(sig));
-    point_a = new_mem_idx >> 1;
+    point_d = index.neighbor(oddBit, point_c, sig);
+    point_e = index.neighbor(1 - oddBit, point_d, sig);
+    point_b = index.neighbor(oddBit, point_c, OPP_DIR(sig));
+    point_a = index.neighbor(1 - oddBit, point_b, OPP_DIR(sig));
 
     ls.loadMatrixFromField(link, oddBit, sig, point_a, &ab_link);
     ls.loadMatrixFromField(link, 1 - oddBit, sig, point_b, &bc_link);
@@ -1338,12 +1411,19 @@ void computeLongLinkField(const int dim[4], const Real *const oprod, const Real
   const int half_volume = volume / 2;
 
   LoadStore<Real> ls(volume);
+  const IndexTable &index = indexTable(dim);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < half_volume; ++site) {
-    computeLongLinkSite<Real, 0>(site, dim, oprod, link, sig, coeff, ls, output);
+    computeLongLinkSite<Real, 0>(site, oprod, link, sig, coeff, ls, index, output);
   }
   // Loop over odd lattice sites
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int site = 0; site < half_volume; ++site) {
-    computeLongLinkSite<Real, 1>(site, dim, oprod, link, sig, coeff, ls, output);
+    computeLongLinkSite<Real, 1>(site, oprod, link, sig, coeff, ls, index, output);
   }
 }
 
@@ -1364,24 +1444,13 @@ void hisqLongLinkForceCPU(double coeff, const QudaGaugeParam &param, cpuGaugeFie
 }
 
 template <class Real, int oddBit>
-void completeForceSite(int half_lattice_index,
-#ifdef MULTI_GPU
-                       const int dim[4],
-#else
-                       const int[],
-#endif
-                       const Real *const oprod, const Real *const link, int sig, const LoadStore<Real> &ls,
-                       Real *const mom)
+void completeForceSite(int half_lattice_index, const Real *const oprod, const Real *const link, int sig,
+                       const LoadStore<Real> &ls, const IndexTable &index, Real *const mom)
 {
 
   typename ColorMatrix<Real>::Type colorMatX, colorMatY, linkW;
 
-#ifdef MULTI_GPU
-  int half_lattice_index_ex = ls.half_idx_conversion_normal2ex(half_lattice_index, dim, oddBit);
-  int idx = half_lattice_index_ex;
-#else
-  int idx = half_lattice_index;
-#endif
+  int idx = index.normal2ex(oddBit, half_lattice_index);
   ls.loadMatrixFromField(link, oddBit, sig, idx, &linkW);
   ls.loadMatrixFromField(oprod, oddBit, sig, idx, &colorMatX);
 
@@ -1397,9 +1466,16 @@ void completeForceField(const int dim[4], const Real *const oprod, const Real *c
   int volume = dim[0] * dim[1] * dim[2] * dim[3];
   const int half_volume = volume / 2;
   LoadStore<Real> ls(volume);
+  const IndexTable &index = indexTable(dim);
 
-  for (int site = 0; site < half_volume; ++site) { completeForceSite<Real, 0>(site, dim, oprod, link, sig, ls, mom); }
-  for (int site = 0; site < half_volume; ++site) { completeForceSite<Real, 1>(site, dim, oprod, link, sig, ls, mom); }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int site = 0; site < half_volume; ++site) { completeForceSite<Real, 0>(site, oprod, link, sig, ls, index, mom); }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int site = 0; site < half_volume; ++site) { completeForceSite<Real, 1>(site, oprod, link, sig, ls, index, mom); }
 }
 
 void hisqCompleteForceCPU(const QudaGaugeParam &param, cpuGaugeField &oprod, cpuGaugeField &link, cpuGaugeField *mom)
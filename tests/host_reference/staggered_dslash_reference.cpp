@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <vector>
 
 #include <host_utils.h>
 #include <quda_internal.h>
@@ -32,148 +33,243 @@ template <typename Float> void display_link_internal(Float *link)
 // if oddBit is one:  calculate odd parity spinor elements
 // if daggerBit is zero: perform ordinary dslash operator
 // if daggerBit is one:  perform hermitian conjugate of dslash
+//
+// The one-hop (fat link) and three-hop (long link) terms of each
+// direction are applied together for every site.  Sites and sources
+// are distributed over threads, and each writes only its own output
+// site.
+//
+#ifndef MULTI_GPU
+// The neighbors at both hop distances are taken from the cached
+// neighbor tables.
 template <typename sFloat, typename gFloat>
-#ifdef MULTI_GPU
-void staggeredDslashReference(sFloat *res, gFloat **fatlink, gFloat **longlink, gFloat **ghostFatlink,
-                              gFloat **ghostLonglink, sFloat *spinorField, sFloat **fwd_nbr_spinor,
-                              sFloat **back_nbr_spinor, int oddBit, int daggerBit, int nSrc, QudaDslashType dslash_type)
-#else
-void staggeredDslashReference(sFloat *res, gFloat **fatlink, gFloat **longlink, gFloat **, gFloat **, sFloat *spinorField,
-                              sFloat **, sFloat **, int oddBit, int daggerBit, int nSrc, QudaDslashType dslash_type)
-#endif
+void staggeredDslashReference(sFloat *res, gFloat **fatlink, gFloat **longlink, const sFloat *spinorField, int oddBit,
+                              int daggerBit, int nSrc, QudaDslashType dslash_type)
 {
-  for (int i = 0; i < Vh * stag_spinor_site_size * nSrc; i++) res[i] = 0.0;
+  const bool improved = dslash_type == QUDA_ASQTAD_DSLASH;
+  const NeighborTable &one_hop = neighborTable(1);
+  const NeighborTable &three_hop = neighborTable(3);
 
-  gFloat *fatlinkEven[4], *fatlinkOdd[4];
-  gFloat *longlinkEven[4], *longlinkOdd[4];
+  const gFloat *fatSame[4], *fatOther[4];
+  const gFloat *longSame[4], *longOther[4];
+  for (int mu = 0; mu < 4; mu++) {
+    fatSame[mu] = fatlink[mu] + (oddBit ? Vh : 0) * gauge_site_size;
+    fatOther[mu] = fatlink[mu] + (oddBit ? 0 : Vh) * gauge_site_size;
+    longSame[mu] = improved ? longlink[mu] + (oddBit ? Vh : 0) * gauge_site_size : nullptr;
+    longOther[mu] = improved ? longlink[mu] + (oddBit ? 0 : Vh) * gauge_site_size : nullptr;
+  }
 
-#ifdef MULTI_GPU
-  gFloat *ghostFatlinkEven[4], *ghostFatlinkOdd[4];
-  gFloat *ghostLonglinkEven[4], *ghostLonglinkOdd[4];
-#endif
+  const bool laplace = dslash_type == QUDA_LAPLACE_DSLASH;
 
-  for (int dir = 0; dir < 4; dir++) {
-    fatlinkEven[dir] = fatlink[dir];
-    fatlinkOdd[dir] = fatlink[dir] + Vh * gauge_site_size;
-    longlinkEven[dir] = longlink[dir];
-    longlinkOdd[dir] = longlink[dir] + Vh * gauge_site_size;
-
-#ifdef MULTI_GPU
-    ghostFatlinkEven[dir] = ghostFatlink[dir];
-    ghostFatlinkOdd[dir] = ghostFatlink[dir] + (faceVolume[dir] / 2) * gauge_site_size;
-    ghostLonglinkEven[dir] = ghostLonglink ? ghostLonglink[dir] : nullptr;
-    ghostLonglinkOdd[dir] = ghostLonglink ? ghostLonglink[dir] + 3 * (faceVolume[dir] / 2) * gauge_site_size : nullptr;
+#ifdef _OPENMP
+#pragma omp parallel for
 #endif
+  for (int sid = 0; sid < nSrc * Vh; sid++) {
+    const int xs = sid / Vh;
+    const int i = sid - xs * Vh;
+    sFloat out[stag_spinor_site_size];
+    for (int c = 0; c < stag_spinor_site_size; c++) out[c] = 0.0;
+
+    for (int dir = 0; dir < 8; dir++) {
+      const int mu = dir / 2;
+      const int k = i * 8 + dir;
+      const bool fwd = dir % 2 == 0;
+
+      for (int n = 0; n < (improved ? 2 : 1); n++) {
+        const NeighborTable &table = n == 0 ? one_hop : three_hop;
+        const int l = table.link_index[oddBit][k];
+
+        const sFloat *spinor = spinorField + table.spinor(oddBit, i, dir, xs) * stag_spinor_site_size;
+        const gFloat *link;
+        if (fwd)
+          link = (n == 0 ? fatSame[mu] : longSame[mu]) + l * gauge_site_size;
+        else
+          link = (n == 0 ? fatOther[mu] : longOther[mu]) + l * gauge_site_size;
+
+        sFloat gaugedSpinor[stag_spinor_site_size];
+        if (fwd) {
+          su3Mul(gaugedSpinor, link, spinor);
+          for (int c = 0; c < stag_spinor_site_size; c++) out[c] += gaugedSpinor[c];
+        } else {
+          su3Tmul(gaugedSpinor, link, spinor);
+          if (laplace)
+            for (int c = 0; c < stag_spinor_site_size; c++) out[c] += gaugedSpinor[c];
+          else
+            for (int c = 0; c < stag_spinor_site_size; c++) out[c] -= gaugedSpinor[c];
+        }
+      }
+    }
+
+    if (daggerBit)
+      for (int c = 0; c < stag_spinor_site_size; c++) out[c] = -out[c];
+    for (int c = 0; c < stag_spinor_site_size; c++) res[sid * stag_spinor_site_size + c] = out[c];
   }
+}
+
+void staggeredDslash(ColorSpinorField &out, void **fatlink, void **longlink, const ColorSpinorField &in, int oddBit,
+                     int daggerBit, QudaPrecision sPrecision, QudaPrecision gPrecision, QudaDslashType dslash_type)
+{
+  const int nSrc = in.X(4);
+
+  if (oddBit != QUDA_EVEN_PARITY && oddBit != QUDA_ODD_PARITY)
+    errorQuda("ERROR: full parity not supported in function %s", __FUNCTION__);
+
+  if (sPrecision == QUDA_DOUBLE_PRECISION) {
+    if (gPrecision == QUDA_DOUBLE_PRECISION) {
+      staggeredDslashReference((double *)out.V(), (double **)fatlink, (double **)longlink, (double *)in.V(), oddBit,
+                               daggerBit, nSrc, dslash_type);
+    } else {
+      staggeredDslashReference((double *)out.V(), (float **)fatlink, (float **)longlink, (double *)in.V(), oddBit,
+                               daggerBit, nSrc, dslash_type);
+    }
+  } else {
+    if (gPrecision == QUDA_DOUBLE_PRECISION) {
+      staggeredDslashReference((float *)out.V(), (double **)fatlink, (double **)longlink, (float *)in.V(), oddBit,
+                               daggerBit, nSrc, dslash_type);
+    } else {
+      staggeredDslashReference((float *)out.V(), (float **)fatlink, (float **)longlink, (float *)in.V(), oddBit,
+                               daggerBit, nSrc, dslash_type);
+    }
+  }
+}
 
-  for (int xs = 0; xs < nSrc; xs++) {
-
-    for (int i = 0; i < Vh; i++) {
-      int sid = i + xs * Vh;
-      int offset = stag_spinor_site_size * sid;
-
-      for (int dir = 0; dir < 8; dir++) {
-#ifdef MULTI_GPU
-        const int nFace = dslash_type == QUDA_ASQTAD_DSLASH ? 3 : 1;
-        gFloat *fatlnk
-          = gaugeLink_mg4dir(i, dir, oddBit, fatlinkEven, fatlinkOdd, ghostFatlinkEven, ghostFatlinkOdd, 1, 1);
-        gFloat *longlnk = dslash_type == QUDA_ASQTAD_DSLASH ?
-          gaugeLink_mg4dir(i, dir, oddBit, longlinkEven, longlinkOdd, ghostLonglinkEven, ghostLonglinkOdd, 3, 3) :
-          nullptr;
-        sFloat *first_neighbor_spinor = spinorNeighbor_5d_mgpu<QUDA_4D_PC>(
-          sid, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 1, nFace, stag_spinor_site_size);
-        sFloat *third_neighbor_spinor = dslash_type == QUDA_ASQTAD_DSLASH ?
-          spinorNeighbor_5d_mgpu<QUDA_4D_PC>(sid, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 3, nFace,
-                                             stag_spinor_site_size) :
-          nullptr;
 #else
-        gFloat *fatlnk = gaugeLink(i, dir, oddBit, fatlinkEven, fatlinkOdd, 1);
-        gFloat *longlnk
-          = dslash_type == QUDA_ASQTAD_DSLASH ? gaugeLink(i, dir, oddBit, longlinkEven, longlinkOdd, 3) : nullptr;
-        sFloat *first_neighbor_spinor
-          = spinorNeighbor_5d<QUDA_4D_PC>(sid, dir, oddBit, spinorField, 1, stag_spinor_site_size);
-        sFloat *third_neighbor_spinor = dslash_type == QUDA_ASQTAD_DSLASH ?
-          spinorNeighbor_5d<QUDA_4D_PC>(sid, dir, oddBit, spinorField, 3, stag_spinor_site_size) :
-          nullptr;
+
+// Multi-process variant: the fat links, the long links and every
+// source of the input spinor are extended by a halo of depth nFace (three
+// for the long links of the improved operator) in every dimension, so
+// all neighbors at both hop distances are addressed directly in the
+// extended lattice.
+template <typename sFloat, typename gFloat>
+void staggeredDslashReference(sFloat *res, const ExtendedGaugeField &fat_ex, const ExtendedGaugeField &long_ex,
+                              const sFloat *spinor_ex, int oddBit, int daggerBit, int nSrc, QudaDslashType dslash_type)
+{
+  const bool improved = dslash_type == QUDA_ASQTAD_DSLASH;
+  const int *R = fat_ex.R;
+
+  int E[4], stride[4];
+  for (int d = 0; d < 4; d++) {
+    E[d] = Z[d] + 2 * R[d];
+    stride[d] = d == 0 ? 1 : stride[d - 1] * E[d - 1];
+  }
+  const size_t volume_cb_ex = static_cast<size_t>(stride[3]) * E[3] / 2;
+  const int parity_ex = (oddBit + R[0] + R[1] + R[2] + R[3]) & 1;
+
+  const gFloat *fatSame[4], *fatOther[4];
+  const gFloat *longSame[4], *longOther[4];
+  for (int mu = 0; mu < 4; mu++) {
+    const gFloat *fat = reinterpret_cast<const gFloat *>(fat_ex.field_ex[mu].data());
+    fatSame[mu] = fat + parity_ex * volume_cb_ex * gauge_site_size;
+    fatOther[mu] = fat + (1 - parity_ex) * volume_cb_ex * gauge_site_size;
+    const gFloat *lng = improved ? reinterpret_cast<const gFloat *>(long_ex.field_ex[mu].data()) : nullptr;
+    longSame[mu] = improved ? lng + parity_ex * volume_cb_ex * gauge_site_size : nullptr;
+    longOther[mu] = improved ? lng + (1 - parity_ex) * volume_cb_ex * gauge_site_size : nullptr;
+  }
+
+  const bool laplace = dslash_type == QUDA_LAPLACE_DSLASH;
+
+#ifdef _OPENMP
+#pragma omp parallel for
 #endif
-        sFloat gaugedSpinor[stag_spinor_site_size];
+  for (int sid = 0; sid < nSrc * Vh; sid++) {
+    const int xs = sid / Vh;
+    const int i = sid - xs * Vh;
+    const int Y = fullLatticeIndex(i, oddBit);
+    const int x[4] = {Y % Z[0], (Y / Z[0]) % Z[1], (Y / (Z[1] * Z[0])) % Z[2], Y / (Z[2] * Z[1] * Z[0])};
+    size_t lex = 0;
+    for (int d = 0; d < 4; d++) lex += static_cast<size_t>(x[d] + R[d]) * stride[d];
+    const sFloat *spinorField = spinor_ex + xs * volume_cb_ex * stag_spinor_site_size;
 
-        if (dir % 2 == 0) {
-          su3Mul(gaugedSpinor, fatlnk, first_neighbor_spinor);
-          sum(&res[offset], &res[offset], gaugedSpinor, stag_spinor_site_size);
+    sFloat out[stag_spinor_site_size];
+    for (int c = 0; c < stag_spinor_site_size; c++) out[c] = 0.0;
 
-          if (dslash_type == QUDA_ASQTAD_DSLASH) {
-            su3Mul(gaugedSpinor, longlnk, third_neighbor_spinor);
-            sum(&res[offset], &res[offset], gaugedSpinor, stag_spinor_site_size);
-          }
+    for (int dir = 0; dir < 8; dir++) {
+      const int mu = dir / 2;
+      const bool fwd = dir % 2 == 0;
+
+      for (int n = 0; n < (improved ? 2 : 1); n++) {
+        const size_t hop = (n == 0 ? 1 : 3) * static_cast<size_t>(stride[mu]);
+        const size_t nbr = fwd ? lex + hop : lex - hop;
+
+        const sFloat *spinor = spinorField + (nbr / 2) * stag_spinor_site_size;
+        const gFloat *link;
+        if (fwd)
+          link = (n == 0 ? fatSame[mu] : longSame[mu]) + (lex / 2) * gauge_site_size;
+        else
+          link = (n == 0 ? fatOther[mu] : longOther[mu]) + (nbr / 2) * gauge_site_size;
+
+        sFloat gaugedSpinor[stag_spinor_site_size];
+        if (fwd) {
+          su3Mul(gaugedSpinor, link, spinor);
+          for (int c = 0; c < stag_spinor_site_size; c++) out[c] += gaugedSpinor[c];
         } else {
-          su3Tmul(gaugedSpinor, fatlnk, first_neighbor_spinor);
-          if (dslash_type == QUDA_LAPLACE_DSLASH) {
-            sum(&res[offset], &res[offset], gaugedSpinor, stag_spinor_site_size);
-          } else {
-            sub(&res[offset], &res[offset], gaugedSpinor, stag_spinor_site_size);
-          }
-
-          if (dslash_type == QUDA_ASQTAD_DSLASH) {
-            su3Tmul(gaugedSpinor, longlnk, third_neighbor_spinor);
-            sub(&res[offset], &res[offset], gaugedSpinor, stag_spinor_site_size);
-          }
+          su3Tmul(gaugedSpinor, link, spinor);
+          if (laplace)
+            for (int c = 0; c < stag_spinor_site_size; c++) out[c] += gaugedSpinor[c];
+          else
+            for (int c = 0; c < stag_spinor_site_size; c++) out[c] -= gaugedSpinor[c];
         }
       }
+    }
 
-      if (daggerBit) negx(&res[offset], stag_spinor_site_size);
-    } // 4-d volume
-  }   // right-hand-side
+    if (daggerBit)
+      for (int c = 0; c < stag_spinor_site_size; c++) out[c] = -out[c];
+    for (int c = 0; c < stag_spinor_site_size; c++) res[sid * stag_spinor_site_size + c] = out[c];
+  }
 }
 
-void staggeredDslash(ColorSpinorField &out, void **fatlink, void **longlink, void **ghost_fatlink,
-                     void **ghost_longlink, const ColorSpinorField &in, int oddBit, int daggerBit,
-                     QudaPrecision sPrecision, QudaPrecision gPrecision, QudaDslashType dslash_type)
+void staggeredDslash(ColorSpinorField &out, void **fatlink, void **longlink, const ColorSpinorField &in, int oddBit,
+                     int daggerBit, QudaPrecision sPrecision, QudaPrecision gPrecision, QudaDslashType dslash_type)
 {
   const int nSrc = in.X(4);
 
-  QudaParity otherparity = QUDA_INVALID_PARITY;
-  if (oddBit == QUDA_EVEN_PARITY) {
-    otherparity = QUDA_ODD_PARITY;
-  } else if (oddBit == QUDA_ODD_PARITY) {
-    otherparity = QUDA_EVEN_PARITY;
-  } else {
+  if (oddBit != QUDA_EVEN_PARITY && oddBit != QUDA_ODD_PARITY)
     errorQuda("ERROR: full parity not supported in function %s", __FUNCTION__);
-  }
-  const int nFace = dslash_type == QUDA_ASQTAD_DSLASH ? 3 : 1;
 
-  in.exchangeGhost(otherparity, nFace, daggerBit);
+  const bool improved = dslash_type == QUDA_ASQTAD_DSLASH;
+  const int nFace = improved ? 3 : 1;
+  const int R[4] = {nFace, nFace, nFace, nFace};
 
-  void **fwd_nbr_spinor = in.fwdGhostFaceBuffer;
-  void **back_nbr_spinor = in.backGhostFaceBuffer;
+  // the extended links are only rebuilt when the links change
+  static ExtendedGaugeField fat_ex, long_ex;
+  extend_cpu_gauge(fat_ex, fatlink, R, gPrecision);
+  if (improved) extend_cpu_gauge(long_ex, longlink, R, gPrecision);
+
+  // extend every source of the input spinor, which has the opposite parity to the output
+  size_t volume_cb_ex = 1;
+  for (int d = 0; d < 4; d++) volume_cb_ex *= Z[d] + 2 * R[d];
+  volume_cb_ex /= 2;
+  const size_t src_bytes = Vh * stag_spinor_site_size * sPrecision;
+  const size_t src_bytes_ex = volume_cb_ex * stag_spinor_site_size * sPrecision;
+  std::vector<char> in_ex(nSrc * src_bytes_ex);
+  for (int s = 0; s < nSrc; s++)
+    exchange_cpu_field_ex(in_ex.data() + s * src_bytes_ex, static_cast<const char *>(in.V()) + s * src_bytes, Z, R,
+                          stag_spinor_site_size, 1, 1 - oddBit, sPrecision);
 
   if (sPrecision == QUDA_DOUBLE_PRECISION) {
     if (gPrecision == QUDA_DOUBLE_PRECISION) {
-      staggeredDslashReference((double *)out.V(), (double **)fatlink, (double **)longlink, (double **)ghost_fatlink,
-                               (double **)ghost_longlink, (double *)in.V(), (double **)fwd_nbr_spinor,
-                               (double **)back_nbr_spinor, oddBit, daggerBit, nSrc, dslash_type);
+      staggeredDslashReference<double, double>((double *)out.V(), fat_ex, long_ex, (double *)in_ex.data(), oddBit,
+                                               daggerBit, nSrc, dslash_type);
     } else {
-      staggeredDslashReference((double *)out.V(), (float **)fatlink, (float **)longlink, (float **)ghost_fatlink,
-                               (float **)ghost_longlink, (double *)in.V(), (double **)fwd_nbr_spinor,
-                               (double **)back_nbr_spinor, oddBit, daggerBit, nSrc, dslash_type);
+      staggeredDslashReference<double, float>((double *)out.V(), fat_ex, long_ex, (double *)in_ex.data(), oddBit,
+                                              daggerBit, nSrc, dslash_type);
     }
   } else {
     if (gPrecision == QUDA_DOUBLE_PRECISION) {
-      staggeredDslashReference((float *)out.V(), (double **)fatlink, (double **)longlink, (double **)ghost_fatlink,
-                               (double **)ghost_longlink, (float *)in.V(), (float **)fwd_nbr_spinor,
-                               (float **)back_nbr_spinor, oddBit, daggerBit, nSrc, dslash_type);
+      staggeredDslashReference<float, double>((float *)out.V(), fat_ex, long_ex, (float *)in_ex.data(), oddBit,
+                                              daggerBit, nSrc, dslash_type);
     } else {
-      staggeredDslashReference((float *)out.V(), (float **)fatlink, (float **)longlink, (float **)ghost_fatlink,
-                               (float **)ghost_longlink, (float *)in.V(), (float **)fwd_nbr_spinor,
-                               (float **)back_nbr_spinor, oddBit, daggerBit, nSrc, dslash_type);
+      staggeredDslashReference<float, float>((float *)out.V(), fat_ex, long_ex, (float *)in_ex.data(), oddBit,
+                                             daggerBit, nSrc, dslash_type);
     }
   }
 }
 
-void staggeredMatDagMat(ColorSpinorField &out, void **fatlink, void **longlink, void **ghost_fatlink,
-                        void **ghost_longlink, const ColorSpinorField &in, double mass, int dagger_bit,
-                        QudaPrecision sPrecision, QudaPrecision gPrecision, ColorSpinorField &tmp, QudaParity parity,
-                        QudaDslashType dslash_type)
+#endif
+
+void staggeredMatDagMat(ColorSpinorField &out, void **fatlink, void **longlink, const ColorSpinorField &in,
+                        double mass, int dagger_bit, QudaPrecision sPrecision, QudaPrecision gPrecision,
+                        ColorSpinorField &tmp, QudaParity parity, QudaDslashType dslash_type)
 {
   // assert sPrecision and gPrecision must be the same
   if (sPrecision != gPrecision) { errorQuda("Spinor precision and gPrecison is not the same"); }
@@ -187,11 +283,9 @@ void staggeredMatDagMat(ColorSpinorField &out, void **fatlink, void **longlink,
     errorQuda("ERROR: full parity not supported in function %s\n", __FUNCTION__);
   }
 
-  staggeredDslash(tmp, fatlink, longlink, ghost_fatlink, ghost_longlink, in, otherparity, dagger_bit, sPrecision,
-                  gPrecision, dslash_type);
+  staggeredDslash(tmp, fatlink, longlink, in, otherparity, dagger_bit, sPrecision, gPrecision, dslash_type);
 
-  staggeredDslash(out, fatlink, longlink, ghost_fatlink, ghost_longlink, tmp, parity, dagger_bit, sPrecision,
-                  gPrecision, dslash_type);
+  staggeredDslash(out, fatlink, longlink, tmp, parity, dagger_bit, sPrecision, gPrecision, dslash_type);
 
   double msq_x4 = mass * mass * 4;
   if (sPrecision == QUDA_DOUBLE_PRECISION) {
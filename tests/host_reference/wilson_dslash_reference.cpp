@@ -12,6 +12,7 @@
 
 #include <dslash_reference.h>
 #include <string.h>
+#include <vector>
 
 using namespace quda;
 
@@ -67,26 +68,86 @@ static const double projector[8][4][4][2] = {
 };
 
 
-// todo pass projector
-template <typename Float> void multiplySpinorByDiracProjector(Float *res, int projIdx, const Float *spinorIn)
+/**
+   @brief Sparse form of the spin projectors.  Each projector 1 +/- gamma_mu
+   has rank two: rows 0 and 1 are psi_s + coeff_s * psi_{col_s}, and rows 2
+   and 3 are mult_s times row src_s.  This allows the dslash to project onto
+   half spinors, so that only two SU(3) matrix-vector products are needed
+   per direction, and to reconstruct the full spinor afterwards.
+ */
+struct SpinProjector {
+  int col[2];
+  double coeff[2][2];
+  int src[2];
+  double mult[2][2];
+};
+
+static const SpinProjector *spinProjectors()
 {
-  for (int i=0; i<4*3*2; i++) res[i] = 0.0;
-
-  for (int s = 0; s < 4; s++) {
-    for (int t = 0; t < 4; t++) {
-      Float projRe = projector[projIdx][s][t][0];
-      Float projIm = projector[projIdx][s][t][1];
-      
-      for (int m = 0; m < 3; m++) {
-	Float spinorRe = spinorIn[t*(3*2) + m*(2) + 0];
-	Float spinorIm = spinorIn[t*(3*2) + m*(2) + 1];
-	res[s*(3*2) + m*(2) + 0] += projRe*spinorRe - projIm*spinorIm;
-	res[s*(3*2) + m*(2) + 1] += projRe*spinorIm + projIm*spinorRe;
+  static SpinProjector proj[8];
+  static bool init = false;
+
+  if (!init) {
+    for (int p = 0; p < 8; p++) {
+      for (int s = 0; s < 2; s++) {
+        for (int t = 0; t < 4; t++) {
+          if (t == s || (projector[p][s][t][0] == 0.0 && projector[p][s][t][1] == 0.0)) continue;
+          proj[p].col[s] = t;
+          proj[p].coeff[s][0] = projector[p][s][t][0];
+          proj[p].coeff[s][1] = projector[p][s][t][1];
+        }
+        for (int r = 0; r < 2; r++) {
+          if (projector[p][2 + s][r][0] == 0.0 && projector[p][2 + s][r][1] == 0.0) continue;
+          proj[p].src[s] = r;
+          proj[p].mult[s][0] = projector[p][2 + s][r][0];
+          proj[p].mult[s][1] = projector[p][2 + s][r][1];
+        }
       }
     }
+    init = true;
   }
+  return proj;
 }
 
+// Accumulate the hop from a neighboring spinor: project it onto a half
+// spinor, multiply its two spin components by the link (or its
+// adjoint for backward hops) and reconstruct the full spinor.
+template <typename sFloat, typename gFloat>
+static inline void accumulateHop(sFloat *out, const sFloat *spinor, const gFloat *gauge, bool fwd,
+                                 const SpinProjector &P)
+{
+  // project onto the half spinor
+  sFloat half[2][6], gauged[2][6];
+  for (int s = 0; s < 2; s++) {
+    const sFloat *psi = spinor + s * 6;
+    const sFloat *chi = spinor + P.col[s] * 6;
+    const sFloat re = P.coeff[s][0], im = P.coeff[s][1];
+    for (int c = 0; c < 3; c++) {
+      half[s][2 * c + 0] = psi[2 * c + 0] + (re * chi[2 * c + 0] - im * chi[2 * c + 1]);
+      half[s][2 * c + 1] = psi[2 * c + 1] + (re * chi[2 * c + 1] + im * chi[2 * c + 0]);
+    }
+  }
+
+  for (int s = 0; s < 2; s++) {
+    if (fwd)
+      su3Mul(gauged[s], gauge, half[s]);
+    else
+      su3Tmul(gauged[s], gauge, half[s]);
+  }
+
+  // reconstruct the full spinor and accumulate
+  for (int s = 0; s < 2; s++) {
+    const sFloat *g = gauged[P.src[s]];
+    const sFloat re = P.mult[s][0], im = P.mult[s][1];
+    for (int k = 0; k < 6; k++) out[s * 6 + k] += gauged[s][k];
+    for (int c = 0; c < 3; c++) {
+      out[(2 + s) * 6 + 2 * c + 0] += re * g[2 * c + 0] - im * g[2 * c + 1];
+      out[(2 + s) * 6 + 2 * c + 1] += re * g[2 * c + 1] + im * g[2 * c + 0];
+    }
+  }
+}
+
+#ifndef MULTI_GPU
 //
 // dslashReference()
 //
@@ -96,144 +157,132 @@ template <typename Float> void multiplySpinorByDiracProjector(Float *res, int pr
 // if daggerBit is zero: perform ordinary dslash operator
 // if daggerBit is one:  perform hermitian conjugate of dslash
 //
-
-#ifndef MULTI_GPU
-
+// Sites are distributed over threads, and each writes only its own
+// output site.
+//
 template <typename sFloat, typename gFloat>
-void dslashReference(sFloat *res, gFloat **gaugeFull, sFloat *spinorField, int oddBit, int daggerBit)
+void dslashReference(sFloat *res, gFloat **gaugeFull, const sFloat *spinorField, int oddBit, int daggerBit)
 {
-  for (int i = 0; i < Vh * spinor_site_size; i++) res[i] = 0.0;
-
-  gFloat *gaugeEven[4], *gaugeOdd[4];
-  for (int dir = 0; dir < 4; dir++) {  
-    gaugeEven[dir] = gaugeFull[dir];
-    gaugeOdd[dir] = gaugeFull[dir] + Vh * gauge_site_size;
+  const SpinProjector *proj = spinProjectors();
+  const NeighborTable &table = neighborTable(1);
+  const int *nbr_index = table.spinor_index[oddBit].data();
+  const int *link_index = table.link_index[oddBit].data();
+
+  const gFloat *gaugeSame[4], *gaugeOther[4];
+  for (int mu = 0; mu < 4; mu++) {
+    gaugeSame[mu] = gaugeFull[mu] + (oddBit ? Vh : 0) * gauge_site_size;
+    gaugeOther[mu] = gaugeFull[mu] + (oddBit ? 0 : Vh) * gauge_site_size;
   }
-  
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < Vh; i++) {
-    for (int dir = 0; dir < 8; dir++) {
-      gFloat *gauge = gaugeLink(i, dir, oddBit, gaugeEven, gaugeOdd, 1);
-      const sFloat *spinor = spinorNeighbor(i, dir, oddBit, spinorField, 1);
-
-      sFloat projectedSpinor[spinor_site_size], gaugedSpinor[spinor_site_size];
-      int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
-      multiplySpinorByDiracProjector(projectedSpinor, projIdx, spinor);
-      
-      for (int s = 0; s < 4; s++) {
-	if (dir % 2 == 0) su3Mul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-	else su3Tmul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-      }
+    sFloat out[spinor_site_size];
+    for (int j = 0; j < spinor_site_size; j++) out[j] = 0.0;
 
-      sum(&res[i * spinor_site_size], &res[i * spinor_site_size], gaugedSpinor, spinor_site_size);
+    for (int dir = 0; dir < 8; dir++) {
+      const int mu = dir / 2;
+      const bool fwd = dir % 2 == 0;
+      const sFloat *spinor = spinorField + nbr_index[i * 8 + dir] * spinor_site_size;
+      const gFloat *gauge = (fwd ? gaugeSame[mu] : gaugeOther[mu]) + link_index[i * 8 + dir] * gauge_site_size;
+      accumulateHop(out, spinor, gauge, fwd, proj[2 * mu + (dir + daggerBit) % 2]);
     }
+
+    for (int j = 0; j < spinor_site_size; j++) res[i * spinor_site_size + j] = out[j];
   }
 }
 
+// this actually applies the preconditioned dslash, e.g., D_ee^{-1} D_eo or D_oo^{-1} D_oe
+void wil_dslash(void *out, void **gauge, void *in, int oddBit, int daggerBit, QudaPrecision precision, QudaGaugeParam &)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    dslashReference((double *)out, (double **)gauge, (double *)in, oddBit, daggerBit);
+  else
+    dslashReference((float *)out, (float **)gauge, (float *)in, oddBit, daggerBit);
+}
+
 #else
 
+// halo depth of the extended fields used by the multi-process reference
+static const int halo_depth[4] = {1, 1, 1, 1};
+
+//
+// dslashReference()
+//
+// Multi-process variant of the dslash reference: the gauge and spinor
+// fields are extended by a halo of depth one in every dimension, so all
+// neighbors are addressed directly in the extended lattice.
+//
 template <typename sFloat, typename gFloat>
-void dslashReference(sFloat *res, gFloat **gaugeFull, gFloat **ghostGauge, sFloat *spinorField, sFloat **fwdSpinor,
-                     sFloat **backSpinor, int oddBit, int daggerBit)
+void dslashReference(sFloat *res, const ExtendedGaugeField &gauge_ex, const sFloat *spinor_ex, int oddBit, int daggerBit)
 {
-  for (int i = 0; i < Vh * spinor_site_size; i++) res[i] = 0.0;
-
-  gFloat *gaugeEven[4], *gaugeOdd[4];
-  gFloat *ghostGaugeEven[4], *ghostGaugeOdd[4];
-  for (int dir = 0; dir < 4; dir++) {  
-    gaugeEven[dir] = gaugeFull[dir];
-    gaugeOdd[dir] = gaugeFull[dir] + Vh * gauge_site_size;
+  const SpinProjector *proj = spinProjectors();
 
-    ghostGaugeEven[dir] = ghostGauge[dir];
-    ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir] / 2) * gauge_site_size;
+  int E[4], stride[4];
+  for (int d = 0; d < 4; d++) {
+    E[d] = Z[d] + 2 * halo_depth[d];
+    stride[d] = d == 0 ? 1 : stride[d - 1] * E[d - 1];
   }
-  
+  const size_t volume_cb_ex = static_cast<size_t>(stride[3]) * E[3] / 2;
+  const int parity_ex = (oddBit + halo_depth[0] + halo_depth[1] + halo_depth[2] + halo_depth[3]) & 1;
+
+  const gFloat *gaugeSame[4], *gaugeOther[4];
+  for (int mu = 0; mu < 4; mu++) {
+    const gFloat *g = reinterpret_cast<const gFloat *>(gauge_ex.field_ex[mu].data());
+    gaugeSame[mu] = g + parity_ex * volume_cb_ex * gauge_site_size;
+    gaugeOther[mu] = g + (1 - parity_ex) * volume_cb_ex * gauge_site_size;
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < Vh; i++) {
+    const int Y = fullLatticeIndex(i, oddBit);
+    const int x[4] = {Y % Z[0], (Y / Z[0]) % Z[1], (Y / (Z[1] * Z[0])) % Z[2], Y / (Z[2] * Z[1] * Z[0])};
+    size_t lex = 0;
+    for (int d = 0; d < 4; d++) lex += static_cast<size_t>(x[d] + halo_depth[d]) * stride[d];
 
-    for (int dir = 0; dir < 8; dir++) {
-      gFloat *gauge = gaugeLink_mg4dir(i, dir, oddBit, gaugeEven, gaugeOdd, ghostGaugeEven, ghostGaugeOdd, 1, 1);
-      const sFloat *spinor = spinorNeighbor_mg4dir(i, dir, oddBit, spinorField, fwdSpinor, backSpinor, 1, 1);
-
-      sFloat projectedSpinor[spinor_site_size], gaugedSpinor[spinor_site_size];
-      int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
-      multiplySpinorByDiracProjector(projectedSpinor, projIdx, spinor);
-      
-      for (int s = 0; s < 4; s++) {
-	if (dir % 2 == 0) su3Mul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-	else su3Tmul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-      }
+    sFloat out[spinor_site_size];
+    for (int j = 0; j < spinor_site_size; j++) out[j] = 0.0;
 
-      sum(&res[i * spinor_site_size], &res[i * spinor_site_size], gaugedSpinor, spinor_site_size);
+    for (int dir = 0; dir < 8; dir++) {
+      const int mu = dir / 2;
+      const bool fwd = dir % 2 == 0;
+      const size_t nbr = fwd ? lex + stride[mu] : lex - stride[mu];
+      const sFloat *spinor = spinor_ex + (nbr / 2) * spinor_site_size;
+      const gFloat *gauge = fwd ? gaugeSame[mu] + (lex / 2) * gauge_site_size : gaugeOther[mu] + (nbr / 2) * gauge_site_size;
+      accumulateHop(out, spinor, gauge, fwd, proj[2 * mu + (dir + daggerBit) % 2]);
     }
 
+    for (int j = 0; j < spinor_site_size; j++) res[i * spinor_site_size + j] = out[j];
   }
 }
 
-#endif
-
-#ifndef MULTI_GPU
 // this actually applies the preconditioned dslash, e.g., D_ee^{-1} D_eo or D_oo^{-1} D_oe
 void wil_dslash(void *out, void **gauge, void *in, int oddBit, int daggerBit, QudaPrecision precision, QudaGaugeParam &)
-#else
-void wil_dslash(void *out, void **gauge, void *in, int oddBit, int daggerBit, QudaPrecision precision,
-                QudaGaugeParam &gauge_param)
-#endif
 {
-#ifndef MULTI_GPU
-  if (precision == QUDA_DOUBLE_PRECISION)
-    dslashReference((double*)out, (double**)gauge, (double*)in, oddBit, daggerBit);
-  else
-    dslashReference((float*)out, (float**)gauge, (float*)in, oddBit, daggerBit);
-#else
+  if (oddBit != QUDA_EVEN_PARITY && oddBit != QUDA_ODD_PARITY)
+    errorQuda("ERROR: full parity not supported in function %s", __FUNCTION__);
 
-  GaugeFieldParam gauge_field_param(gauge_param, gauge);
-  gauge_field_param.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
-  cpuGaugeField cpu(gauge_field_param);
-  void **ghostGauge = (void**)cpu.Ghost();
-
-  // Get spinor ghost fields
-  // First wrap the input spinor into a ColorSpinorField
-  ColorSpinorParam csParam;
-  csParam.location = QUDA_CPU_FIELD_LOCATION;
-  csParam.v = in;
-  csParam.nColor = 3;
-  csParam.nSpin = 4;
-  csParam.nDim = 4;
-  for (int d=0; d<4; d++) csParam.x[d] = Z[d];
-  csParam.setPrecision(precision);
-  csParam.pad = 0;
-  csParam.siteSubset = QUDA_PARITY_SITE_SUBSET;
-  csParam.x[0] /= 2;
-  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
-  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
-  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
-  csParam.create = QUDA_REFERENCE_FIELD_CREATE;
-  csParam.pc_type = QUDA_4D_PC;
-
-  ColorSpinorField inField(csParam);
-
-  {  // Now do the exchange
-    QudaParity otherParity = QUDA_INVALID_PARITY;
-    if (oddBit == QUDA_EVEN_PARITY) otherParity = QUDA_ODD_PARITY;
-    else if (oddBit == QUDA_ODD_PARITY) otherParity = QUDA_EVEN_PARITY;
-    else errorQuda("ERROR: full parity not supported in function %s", __FUNCTION__);
-    const int nFace = 1;
-
-    inField.exchangeGhost(otherParity, nFace, daggerBit);
-  }
-  void** fwd_nbr_spinor = inField.fwdGhostFaceBuffer;
-  void** back_nbr_spinor = inField.backGhostFaceBuffer;
+  // the extended gauge field is only rebuilt when the gauge field changes
+  static ExtendedGaugeField gauge_ex;
+  extend_cpu_gauge(gauge_ex, gauge, halo_depth, precision);
 
-  if (precision == QUDA_DOUBLE_PRECISION) {
-    dslashReference((double*)out, (double**)gauge, (double**)ghostGauge, (double*)in, 
-		    (double**)fwd_nbr_spinor, (double**)back_nbr_spinor, oddBit, daggerBit);
-  } else{
-    dslashReference((float*)out, (float**)gauge, (float**)ghostGauge, (float*)in, 
-		    (float**)fwd_nbr_spinor, (float**)back_nbr_spinor, oddBit, daggerBit);
-  }
+  // extend the input spinor, which has the opposite parity to the output
+  size_t volume_ex = 1;
+  for (int d = 0; d < 4; d++) volume_ex *= Z[d] + 2 * halo_depth[d];
+  std::vector<char> in_ex(volume_ex / 2 * spinor_site_size * precision);
+  exchange_cpu_field_ex(in_ex.data(), in, Z, halo_depth, spinor_site_size, 1, 1 - oddBit, precision);
 
-#endif
+  if (precision == QUDA_DOUBLE_PRECISION)
+    dslashReference<double, double>((double *)out, gauge_ex, (double *)in_ex.data(), oddBit, daggerBit);
+  else
+    dslashReference<float, float>((float *)out, gauge_ex, (float *)in_ex.data(), oddBit, daggerBit);
 }
 
+#endif
+
 // applies b*(1 + i*a*gamma_5)
 template <typename sFloat>
 void twistGamma5(sFloat *out, sFloat *in, const int dagger, const sFloat kappa, const sFloat mu, 
@@ -253,6 +302,9 @@ void twistGamma5(sFloat *out, sFloat *in, const int dagger, const sFloat kappa,
 
   if (dagger) a *= -1.0;
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(int i = 0; i < V; i++) {
     sFloat tmp[24];
     for(int s = 0; s < 4; s++)
@@ -432,6 +484,9 @@ void ndegTwistGamma5(sFloat *out1, sFloat *out2, sFloat *in1, sFloat *in2, const
 
   if (dagger) a *= -1.0;
   
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(int i = 0; i < V; i++) {
     sFloat tmp1[24];
     sFloat tmp2[24];    
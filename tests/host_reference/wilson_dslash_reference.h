@@ -60,6 +60,11 @@ extern "C" {
 
   void apply_clover(void *out, void *clover, void *in, int parity, QudaPrecision precision);
 
+  void apply_twist_clover(void *out1, void *out2, void *clover, void *cInv, void *in1, void *in2, int parity, double a,
+                          double b, QudaPrecision precision);
+
+  void compute_clover_inverse(void *cInv, void *clover, bool twisted, double mu2, QudaPrecision precision);
+
   void clover_dslash(void *res, void **gauge, void *clover, void *spinorField, int oddBit,
 		     int daggerBit, QudaPrecision precision, QudaGaugeParam &param);
 
@@ -54,9 +54,6 @@ struct StaggeredDslashTestWrapper {
   void *milc_fatlink_gpu;
   void *milc_longlink_gpu;
 
-  cpuGaugeField *cpuFat = nullptr;
-  cpuGaugeField *cpuLong = nullptr;
-
   std::unique_ptr<ColorSpinorField> spinor;
   std::unique_ptr<ColorSpinorField> spinorOut;
   std::unique_ptr<ColorSpinorField> spinorRef;
@@ -71,7 +68,6 @@ struct StaggeredDslashTestWrapper {
   // In the HISQ case, we include building fat/long links in this unit test
   void *qdp_fatlink_cpu[4] = {nullptr, nullptr, nullptr, nullptr};
   void *qdp_longlink_cpu[4] = {nullptr, nullptr, nullptr, nullptr};
-  void **ghost_fatlink_cpu, **ghost_longlink_cpu;
 
   QudaParity parity = QUDA_EVEN_PARITY;
 
@@ -92,19 +88,19 @@ struct StaggeredDslashTestWrapper {
     printfQuda("Calculating reference implementation...");
     switch (dtest_type) {
     case dslash_test_type::Dslash:
-      staggeredDslash(*spinorRef, qdp_fatlink_cpu, qdp_longlink_cpu, ghost_fatlink_cpu, ghost_longlink_cpu, *spinor,
-                      parity, dagger, inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
+      staggeredDslash(*spinorRef, qdp_fatlink_cpu, qdp_longlink_cpu, *spinor, parity, dagger, inv_param.cpu_prec,
+                      gauge_param.cpu_prec, dslash_type);
       break;
     case dslash_test_type::MatPC:
-      staggeredMatDagMat(*spinorRef, qdp_fatlink_cpu, qdp_longlink_cpu, ghost_fatlink_cpu, ghost_longlink_cpu, *spinor,
-                         mass, 0, inv_param.cpu_prec, gauge_param.cpu_prec, *tmpCpu, parity, dslash_type);
+      staggeredMatDagMat(*spinorRef, qdp_fatlink_cpu, qdp_longlink_cpu, *spinor, mass, 0, inv_param.cpu_prec,
+                         gauge_param.cpu_prec, *tmpCpu, parity, dslash_type);
       break;
     case dslash_test_type::Mat:
       // the !dagger is to reconcile the QUDA convention of D_stag = {{ 2m, -D_{eo}}, -D_{oe}, 2m}} vs the host convention without the minus signs
-      staggeredDslash(spinorRef->Even(), qdp_fatlink_cpu, qdp_longlink_cpu, ghost_fatlink_cpu, ghost_longlink_cpu,
-                      spinor->Odd(), QUDA_EVEN_PARITY, !dagger, inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
-      staggeredDslash(spinorRef->Odd(), qdp_fatlink_cpu, qdp_longlink_cpu, ghost_fatlink_cpu, ghost_longlink_cpu,
-                      spinor->Even(), QUDA_ODD_PARITY, !dagger, inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
+      staggeredDslash(spinorRef->Even(), qdp_fatlink_cpu, qdp_longlink_cpu, spinor->Odd(), QUDA_EVEN_PARITY, !dagger,
+                      inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
+      staggeredDslash(spinorRef->Odd(), qdp_fatlink_cpu, qdp_longlink_cpu, spinor->Even(), QUDA_ODD_PARITY, !dagger,
+                      inv_param.cpu_prec, gauge_param.cpu_prec, dslash_type);
       if (dslash_type == QUDA_LAPLACE_DSLASH) {
         xpay(spinor->V(), kappa, spinorRef->V(), spinor->Length(), gauge_param.cpu_prec);
       } else {
@@ -186,9 +182,6 @@ struct StaggeredDslashTestWrapper {
     }
 
     // Allocate a lot of memory because I'm very confused
-    void *milc_fatlink_cpu = safe_malloc(4 * V * gauge_site_size * host_gauge_data_type_size);
-    void *milc_longlink_cpu = safe_malloc(4 * V * gauge_site_size * host_gauge_data_type_size);
-
     milc_fatlink_gpu = safe_malloc(4 * V * gauge_site_size * host_gauge_data_type_size);
     milc_longlink_gpu = safe_malloc(4 * V * gauge_site_size * host_gauge_data_type_size);
 
@@ -212,28 +205,9 @@ struct StaggeredDslashTestWrapper {
     // Alright, we've created all the void** links.
     // Create the void* pointers
     reorderQDPtoMILC(milc_fatlink_gpu, qdp_fatlink_gpu, V, gauge_site_size, gauge_param.cpu_prec, gauge_param.cpu_prec);
-    reorderQDPtoMILC(milc_fatlink_cpu, qdp_fatlink_cpu, V, gauge_site_size, gauge_param.cpu_prec, gauge_param.cpu_prec);
     reorderQDPtoMILC(milc_longlink_gpu, qdp_longlink_gpu, V, gauge_site_size, gauge_param.cpu_prec, gauge_param.cpu_prec);
-    reorderQDPtoMILC(milc_longlink_cpu, qdp_longlink_cpu, V, gauge_site_size, gauge_param.cpu_prec, gauge_param.cpu_prec);
-    // Create ghost zones for CPU fields,
-    // prepare and load the GPU fields
-
-#ifdef MULTI_GPU
-    gauge_param.type = (dslash_type == QUDA_ASQTAD_DSLASH) ? QUDA_ASQTAD_FAT_LINKS : QUDA_SU3_LINKS;
-    gauge_param.reconstruct = QUDA_RECONSTRUCT_NO;
-    GaugeFieldParam cpuFatParam(gauge_param, milc_fatlink_cpu);
-    cpuFatParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
-    cpuFat = new cpuGaugeField(cpuFatParam);
-    ghost_fatlink_cpu = cpuFat->Ghost();
-
-    if (dslash_type == QUDA_ASQTAD_DSLASH) {
-      gauge_param.type = QUDA_ASQTAD_LONG_LINKS;
-      GaugeFieldParam cpuLongParam(gauge_param, milc_longlink_cpu);
-      cpuLongParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
-      cpuLong = new cpuGaugeField(cpuLongParam);
-      ghost_longlink_cpu = cpuLong ? cpuLong->Ghost() : nullptr;
-    }
-#endif
+    // Prepare and load the GPU fields; the host reference extends the
+    // QDP-order CPU links itself, so no CPU ghost zones are needed
 
     gauge_param.type = (dslash_type == QUDA_ASQTAD_DSLASH) ? QUDA_ASQTAD_FAT_LINKS : QUDA_SU3_LINKS;
     if (dslash_type == QUDA_STAGGERED_DSLASH) {
@@ -332,8 +306,6 @@ struct StaggeredDslashTestWrapper {
       host_free(qdp_longlink_gpu[dir]);
       host_free(qdp_inlink[dir]);
     }
-    host_free(milc_fatlink_cpu);
-    host_free(milc_longlink_cpu);
   }
 
   void end()
@@ -375,14 +347,6 @@ struct StaggeredDslashTestWrapper {
 
     freeGaugeQuda();
 
-    if (cpuFat) {
-      delete cpuFat;
-      cpuFat = nullptr;
-    }
-    if (cpuLong) {
-      delete cpuLong;
-      cpuLong = nullptr;
-    }
     commDimPartitionedReset();
   }
 
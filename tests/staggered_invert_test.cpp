@@ -220,8 +220,6 @@ int main(int argc, char **argv)
   void* qdp_longlink[4] = {nullptr,nullptr,nullptr,nullptr};
   void *milc_fatlink = nullptr;
   void *milc_longlink = nullptr;
-  GaugeField *cpuFat = nullptr;
-  GaugeField *cpuLong = nullptr;
 
   for (int dir = 0; dir < 4; dir++) {
     qdp_inlink[dir] = safe_malloc(V * gauge_site_size * host_gauge_data_type_size);
@@ -252,22 +250,9 @@ int main(int argc, char **argv)
     printfQuda("Computed fat link plaquette is %e (spatial = %e, temporal = %e)\n", plaq[0], plaq[1], plaq[2]);
   }
 
-  // Create ghost gauge fields in case of multi GPU builds.
-  gauge_param.type = (dslash_type == QUDA_STAGGERED_DSLASH || dslash_type == QUDA_LAPLACE_DSLASH) ?
-    QUDA_SU3_LINKS :
-    QUDA_ASQTAD_FAT_LINKS;
-  gauge_param.reconstruct = QUDA_RECONSTRUCT_NO;
+  // The host reference extends the QDP-order links itself, so no ghost
+  // gauge fields are needed in multi GPU builds.
   gauge_param.location = QUDA_CPU_FIELD_LOCATION;
-
-  GaugeFieldParam cpuFatParam(gauge_param, milc_fatlink);
-  cpuFatParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
-  cpuFat = GaugeField::Create(cpuFatParam);
-
-  gauge_param.type = QUDA_ASQTAD_LONG_LINKS;
-  GaugeFieldParam cpuLongParam(gauge_param, milc_longlink);
-  cpuLongParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
-  cpuLong = GaugeField::Create(cpuLongParam);
-
   loadFatLongGaugeQuda(milc_fatlink, milc_longlink, gauge_param);
 
   // Staggered Gauge construct END
@@ -301,6 +286,12 @@ int main(int argc, char **argv)
   // Prepare rng
   auto *rng = new quda::RNG(*ref, 1234);
 
+  // the sources are drawn with the counter-based generator, so they do not depend on the process grid
+  auto random_source = [&](quda::ColorSpinorField &v, int k) {
+    constructRandomSpinorSource(v.V(), v.Nspin(), v.Ncolor(), v.Precision(), inv_param.solution_type, gauge_param.X,
+                                4, *rng, k);
+  };
+
   // Performance measuring
   std::vector<double> time(Nsrc);
   std::vector<double> gflops(Nsrc);
@@ -330,7 +321,7 @@ int main(int argc, char **argv)
       exit(0);
     }
 
-    for (int k = 0; k < Nsrc; k++) { quda::spinorNoise(*in[k], *rng, QUDA_NOISE_UNIFORM); }
+    for (int k = 0; k < Nsrc; k++) { random_source(*in[k], k); }
 
     if (!use_split_grid) {
       for (int k = 0; k < Nsrc; k++) {
@@ -364,8 +355,8 @@ int main(int argc, char **argv)
 
     for (int k = 0; k < Nsrc; k++) {
       if (verify_results)
-        verifyStaggeredInversion(*tmp, *ref, *in[k], *out[k], mass, qdp_fatlink, qdp_longlink, (void **)cpuFat->Ghost(),
-                                 (void **)cpuLong->Ghost(), gauge_param, inv_param, 0);
+        verifyStaggeredInversion(*tmp, *ref, *in[k], *out[k], mass, qdp_fatlink, qdp_longlink, gauge_param, inv_param,
+                                 0);
     }
     break;
 
@@ -394,7 +385,7 @@ int main(int argc, char **argv)
     }
 
     for (int k = 0; k < Nsrc; k++) {
-      quda::spinorNoise(*in[k], *rng, QUDA_NOISE_UNIFORM);
+      random_source(*in[k], k);
       invertMultiShiftQuda((void **)outArray, in[k]->V(), &inv_param);
 
       time[k] = inv_param.secs;
@@ -406,7 +397,7 @@ int main(int argc, char **argv)
       for (int i = 0; i < multishift; i++) {
         printfQuda("%dth solution: mass=%f, ", i, masses[i]);
         verifyStaggeredInversion(*tmp, *ref, *in[k], *qudaOutArray[i], masses[i], qdp_fatlink, qdp_longlink,
-                                 (void **)cpuFat->Ghost(), (void **)cpuLong->Ghost(), gauge_param, inv_param, i);
+                                 gauge_param, inv_param, i);
       }
     }
 
@@ -435,9 +426,6 @@ int main(int argc, char **argv)
   host_free(milc_fatlink);
   host_free(milc_longlink);
 
-  if (cpuFat != nullptr) { delete cpuFat; cpuFat = nullptr; }
-  if (cpuLong != nullptr) { delete cpuLong; cpuLong = nullptr; }
-
   for (auto in_vec : in) { delete in_vec; }
   for (auto out_vec : out) { delete out_vec; }
   delete ref;
@@ -533,10 +533,11 @@ std::shared_ptr<QUDAApp> make_app(std::string app_description, std::string app_n
   quda_app->add_option("--precon-schwarz-cycle", precon_schwarz_cycle,
                        "The number of Schwarz cycles to apply per smoother application (default=1)");
 
-  CLI::TransformPairs<int> rank_order_map {{"col", 0}, {"row", 1}};
+  CLI::TransformPairs<int> rank_order_map {{"col", 0}, {"row", 1}, {"topo", 2}};
   quda_app
     ->add_option("--rank-order", rank_order,
-                 "Set the [t][z][y][x] rank order as either column major (t fastest, default) or row major (x fastest)")
+                 "Set the [t][z][y][x] rank order as either column major (t fastest, default), row major (x fastest), "
+                 "or topology aware (ranks on the same node are assigned a block minimizing inter-node faces, MPI only)")
     ->transform(CLI::QUDACheckedTransformer(rank_order_map));
 
   quda_app->add_option("--recon", link_recon, "Link reconstruction type")
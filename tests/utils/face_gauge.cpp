@@ -1007,4 +1007,225 @@ void exchange_llfat_cleanup(void)
   }
 }
 
+/**
+   Slab of the extended lattice exchanged in dimension dim: R[dim]
+   layers from layer start in dimension dim, the full extended extent
+   of the dimensions exchanged before dim (so that corners are filled)
+   and the body of the others.  The slab sites are linearized with
+   dimension dim running slowest, so that the fastest running
+   dimension always has an even extent and consecutive pairs of sites
+   have opposite parity.
+ */
+struct ExtendedSlab {
+  int lo[4];
+  int n[4];
+  int order[4];
+  size_t volume;
+
+  ExtendedSlab(const int *X, const int *R, int dim, int start) : volume(1)
+  {
+    for (int d = 0, k = 0; d < 4; d++) {
+      if (d == dim) continue;
+      order[k++] = d;
+      lo[d] = d < dim ? 0 : R[d];
+      n[d] = d < dim ? X[d] + 2 * R[d] : X[d];
+    }
+    order[3] = dim;
+    lo[dim] = start;
+    n[dim] = R[dim];
+    for (int d = 0; d < 4; d++) volume *= n[d];
+  }
+};
+
+// copy the sites of a slab of the extended field to (pack) or from
+// (unpack) a contiguous buffer; single-parity fields only hold the
+// sites of parity parity_ex, which fill half of the buffer
+template <typename Float>
+static void copyExtendedSlab(Float *buf, Float *field_ex, const ExtendedSlab &slab, const int *E, int site_size,
+                             int nParity, int parity_ex, bool pack)
+{
+  const size_t volume_cb_ex = static_cast<size_t>(E[0]) * E[1] * E[2] * E[3] / 2;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (size_t s = 0; s < slab.volume; s++) {
+    int x[4];
+    size_t r = s;
+    for (int k = 0; k < 4; k++) {
+      const int d = slab.order[k];
+      x[d] = slab.lo[d] + r % slab.n[d];
+      r /= slab.n[d];
+    }
+    const int parity = (x[0] + x[1] + x[2] + x[3]) & 1;
+    if (nParity == 1 && parity != parity_ex) continue;
+
+    const size_t lex = ((static_cast<size_t>(x[3]) * E[2] + x[2]) * E[1] + x[1]) * E[0] + x[0];
+    Float *site_ex = field_ex + ((nParity == 2 ? parity * volume_cb_ex : 0) + lex / 2) * site_size;
+    Float *site_buf = buf + (nParity == 2 ? s : s / 2) * site_size;
+    if (pack)
+      memcpy(site_buf, site_ex, site_size * sizeof(Float));
+    else
+      memcpy(site_ex, site_buf, site_size * sizeof(Float));
+  }
+}
+
+template <typename Float>
+static void exchangeFieldEx(Float *field_ex, const Float *field, const int *X, const int *R, int site_size, int nParity,
+                            int parity)
+{
+  int E[4];
+  for (int d = 0; d < 4; d++) {
+    if (R[d] > X[d]) errorQuda("Halo depth R[%d] = %d exceeds the local extent %d", d, R[d], X[d]);
+    // the single-parity buffers hold every other site of each slab
+    if (X[d] % 2) errorQuda("Local extent X[%d] = %d must be even", d, X[d]);
+    E[d] = X[d] + 2 * R[d];
+  }
+  const size_t volume_cb = static_cast<size_t>(X[0]) * X[1] * X[2] * X[3] / 2;
+  const size_t volume_cb_ex = static_cast<size_t>(E[0]) * E[1] * E[2] * E[3] / 2;
+  const int parity_ex = (parity + R[0] + R[1] + R[2] + R[3]) & 1;
+
+  // copy the body
+  for (int p = 0; p < nParity; p++) {
+    const int src_parity = nParity == 2 ? p : parity;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < volume_cb; i++) {
+      int za = i / (X[0] / 2);
+      int zb = za / X[1];
+      int x[4];
+      x[1] = za - zb * X[1];
+      x[3] = zb / X[2];
+      x[2] = zb - x[3] * X[2];
+      x[0] = 2 * (i - za * (X[0] / 2)) + ((x[1] + x[2] + x[3] + src_parity) & 1);
+
+      const size_t lex
+        = ((static_cast<size_t>(x[3] + R[3]) * E[2] + x[2] + R[2]) * E[1] + x[1] + R[1]) * E[0] + x[0] + R[0];
+      const int dst_parity = (src_parity + R[0] + R[1] + R[2] + R[3]) & 1;
+      memcpy(field_ex + ((nParity == 2 ? dst_parity * volume_cb_ex : 0) + lex / 2) * site_size,
+             field + ((nParity == 2 ? src_parity * volume_cb : 0) + i) * site_size, site_size * sizeof(Float));
+    }
+  }
+
+  // fill the halo one dimension at a time, so that the slabs of later
+  // dimensions carry the corners filled by the earlier ones
+  for (int dim = 0; dim < 4; dim++) {
+    if (R[dim] == 0) continue;
+
+    const ExtendedSlab send_fwd(X, R, dim, X[dim]);          // top layers of the body
+    const ExtendedSlab send_back(X, R, dim, R[dim]);         // bottom layers of the body
+    const ExtendedSlab recv_back(X, R, dim, 0);              // backward halo
+    const ExtendedSlab recv_fwd(X, R, dim, X[dim] + R[dim]); // forward halo
+
+    const size_t bytes = (nParity == 2 ? send_fwd.volume : send_fwd.volume / 2) * site_size * sizeof(Float);
+    Float *send_fwd_buf = static_cast<Float *>(safe_malloc(bytes));
+    Float *send_back_buf = static_cast<Float *>(safe_malloc(bytes));
+
+    copyExtendedSlab(send_fwd_buf, field_ex, send_fwd, E, site_size, nParity, parity_ex, true);
+    copyExtendedSlab(send_back_buf, field_ex, send_back, E, site_size, nParity, parity_ex, true);
+
+    if (comm_dim_partitioned(dim)) {
+      Float *recv_back_buf = static_cast<Float *>(safe_malloc(bytes));
+      Float *recv_fwd_buf = static_cast<Float *>(safe_malloc(bytes));
+
+      MsgHandle *mh_recv_back = comm_declare_receive_relative(recv_back_buf, dim, -1, bytes);
+      MsgHandle *mh_recv_fwd = comm_declare_receive_relative(recv_fwd_buf, dim, +1, bytes);
+      MsgHandle *mh_send_fwd = comm_declare_send_relative(send_fwd_buf, dim, +1, bytes);
+      MsgHandle *mh_send_back = comm_declare_send_relative(send_back_buf, dim, -1, bytes);
+
+      comm_start(mh_recv_back);
+      comm_start(mh_recv_fwd);
+      comm_start(mh_send_fwd);
+      comm_start(mh_send_back);
+
+      comm_wait(mh_send_fwd);
+      comm_wait(mh_send_back);
+      comm_wait(mh_recv_back);
+      comm_wait(mh_recv_fwd);
+
+      comm_free(mh_send_fwd);
+      comm_free(mh_send_back);
+      comm_free(mh_recv_back);
+      comm_free(mh_recv_fwd);
+
+      copyExtendedSlab(recv_back_buf, field_ex, recv_back, E, site_size, nParity, parity_ex, false);
+      copyExtendedSlab(recv_fwd_buf, field_ex, recv_fwd, E, site_size, nParity, parity_ex, false);
+
+      host_free(recv_back_buf);
+      host_free(recv_fwd_buf);
+    } else {
+      // periodic boundary within this process
+      copyExtendedSlab(send_fwd_buf, field_ex, recv_back, E, site_size, nParity, parity_ex, false);
+      copyExtendedSlab(send_back_buf, field_ex, recv_fwd, E, site_size, nParity, parity_ex, false);
+    }
+
+    host_free(send_fwd_buf);
+    host_free(send_back_buf);
+  }
+}
+
+void exchange_cpu_field_ex(void *field_ex, const void *field, const int *X, const int *R, int site_size, int nParity,
+                           int parity, QudaPrecision precision)
+{
+  if (nParity != 1 && nParity != 2) errorQuda("Invalid number of parities %d", nParity);
+
+  if (precision == QUDA_DOUBLE_PRECISION) {
+    exchangeFieldEx(static_cast<double *>(field_ex), static_cast<const double *>(field), X, R, site_size, nParity,
+                    parity);
+  } else if (precision == QUDA_SINGLE_PRECISION) {
+    exchangeFieldEx(static_cast<float *>(field_ex), static_cast<const float *>(field), X, R, site_size, nParity,
+                    parity);
+  } else {
+    errorQuda("Unsupported precision %d", precision);
+  }
+}
+
+// order-independent 64-bit checksum of the local gauge field
+static uint64_t gaugeChecksum(void **gauge, QudaPrecision precision)
+{
+  const size_t words = V * gauge_site_size * precision / sizeof(uint64_t);
+  uint64_t checksum = 0;
+  for (int mu = 0; mu < 4; mu++) {
+    const uint64_t *g = static_cast<const uint64_t *>(gauge[mu]);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(^ : checksum)
+#endif
+    for (size_t i = 0; i < words; i++) {
+      // splitmix64 finalizer of the word and its position
+      uint64_t z = g[i] + (mu * words + i) * 0x9E3779B97F4A7C15ull;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      checksum ^= z ^ (z >> 31);
+    }
+  }
+  return checksum;
+}
+
+void extend_cpu_gauge(ExtendedGaugeField &ex, void **gauge, const int *R, QudaPrecision precision)
+{
+  const uint64_t checksum = gaugeChecksum(gauge, precision);
+  bool valid = ex.precision == precision && ex.checksum == checksum;
+  for (int d = 0; d < 4; d++) valid = valid && ex.gauge[d] == gauge[d] && ex.dims[d] == Z[d] && ex.R[d] == R[d];
+
+  // the rebuild is collective, so it is done if the cache is stale on any rank
+  int stale = valid ? 0 : 1;
+  comm_allreduce_int(&stale);
+  if (stale == 0) return;
+
+  size_t volume_ex = 1;
+  for (int d = 0; d < 4; d++) volume_ex *= Z[d] + 2 * R[d];
+  for (int mu = 0; mu < 4; mu++) {
+    ex.field_ex[mu].resize(volume_ex * gauge_site_size * precision);
+    exchange_cpu_field_ex(ex.field_ex[mu].data(), gauge[mu], Z, R, gauge_site_size, 2, 0, precision);
+    ex.gauge[mu] = gauge[mu];
+  }
+  for (int d = 0; d < 4; d++) {
+    ex.dims[d] = Z[d];
+    ex.R[d] = R[d];
+  }
+  ex.precision = precision;
+  ex.checksum = checksum;
+}
+
 #undef gauge_site_size
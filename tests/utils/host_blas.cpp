@@ -1,10 +1,18 @@
+#include <algorithm>
+#include <vector>
 #include <host_utils.h>
 #include <stdio.h>
 #include <comm_quda.h>
 
+// number of complex elements per cache block in the multi-vector kernels
+static constexpr int host_blas_block = 2048;
+
 template <typename Float>
 inline void aXpY(Float a, Float *x, Float *y, int len)
 {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for(int i=0; i < len; i++){ y[i] += a*x[i]; }
 }
 
@@ -16,6 +24,9 @@ void axpy(double a, void *x, void *y, int len, QudaPrecision precision) {
 // performs the operation x[i] *= a
 template <typename Float>
 inline void aX(Float a, Float *x, int len) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i=0; i<len; i++) x[i] *= a;
 }
 
@@ -27,6 +38,9 @@ void ax(double a, void *x, int len, QudaPrecision precision) {
 // performs the operation y[i] -= x[i] (minus x plus y)
 template <typename Float>
 inline void mXpY(Float *x, Float *y, int len) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i=0; i<len; i++) y[i] -= x[i];
 }
 
@@ -40,6 +54,9 @@ void mxpy(void* x, void* y, int len, QudaPrecision precision) {
 template <typename Float>
 inline double norm2(Float *v, int len) {
   double sum=0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : sum)
+#endif
   for (int i=0; i<len; i++) sum += v[i]*v[i];
   comm_allreduce(&sum);
   return sum;
@@ -53,6 +70,9 @@ double norm_2(void *v, int len, QudaPrecision precision) {
 // performs the operation y[i] = x[i] + a*y[i]
 template <typename Float>
 static inline void xpay(Float *x, Float a, Float *y, int len) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i=0; i<len; i++) y[i] = x[i] + a*y[i];
 }
 
@@ -61,25 +81,141 @@ void xpay(void *x, double a, void *y, int length, QudaPrecision precision) {
   else xpay((float*)x, (float)a, (float*)y, length);
 }
 
+// performs the operation y[i] = x[i] + a*y[i] for complex a, x and y
+// stored as interleaved real and imaginary parts
+template <typename Float>
+static void cxpay(const Float *x, double _Complex a, Float *y, int len)
+{
+  const Float a_re = ((double *)&a)[0], a_im = ((double *)&a)[1];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < len / 2; i++) {
+    Float y_re = y[2 * i + 0], y_im = y[2 * i + 1];
+    y[2 * i + 0] = x[2 * i + 0] + a_re * y_re - a_im * y_im;
+    y[2 * i + 1] = x[2 * i + 1] + a_re * y_im + a_im * y_re;
+  }
+}
+
 void cxpay(void *x, double _Complex a, void *y, int length, QudaPrecision precision)
 {
   if (precision == QUDA_DOUBLE_PRECISION) {
-    xpay((double _Complex *)x, (double _Complex)a, (double _Complex *)y, length / 2);
+    cxpay((double *)x, a, (double *)y, length);
   } else {
-    xpay((float _Complex *)x, (float _Complex)a, (float _Complex *)y, length / 2);
+    cxpay((float *)x, a, (float *)y, length);
+  }
+}
+
+// performs the operation y[j] += sum_i a[i * ny + j] * x[i] over the
+// sets of complex vectors x and y, processing the sites in cache blocks
+// so that each y[j] block is updated by all x[i] while resident
+template <typename Float>
+static void caxpyBlock(const double _Complex *a, Float **x, Float **y, int nx, int ny, int len)
+{
+  const double *a_ri = (const double *)a;
+  const int n = len / 2;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int b = 0; b < n; b += host_blas_block) {
+    const int end = std::min(b + host_blas_block, n);
+    for (int j = 0; j < ny; j++) {
+      Float *yj = y[j];
+      for (int i = 0; i < nx; i++) {
+        const Float *xi = x[i];
+        const Float a_re = a_ri[2 * (i * ny + j) + 0], a_im = a_ri[2 * (i * ny + j) + 1];
+        for (int k = b; k < end; k++) {
+          yj[2 * k + 0] += a_re * xi[2 * k + 0] - a_im * xi[2 * k + 1];
+          yj[2 * k + 1] += a_re * xi[2 * k + 1] + a_im * xi[2 * k + 0];
+        }
+      }
+    }
   }
 }
 
+void caxpy_block(const double _Complex *a, void **x, void **y, int nx, int ny, int len, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION) caxpyBlock(a, (double **)x, (double **)y, nx, ny, len);
+  else caxpyBlock(a, (float **)x, (float **)y, nx, ny, len);
+}
+
+void caxpy(double _Complex a, void *x, void *y, int len, QudaPrecision precision)
+{
+  caxpy_block(&a, &x, &y, 1, 1, len, precision);
+}
+
+// computes result[i * ny + j] = (x[i], y[j]) over the sets of complex
+// vectors x and y, processing the sites in cache blocks.  The partial
+// sums of each block are added in block order, so that the result does
+// not depend on the number of threads.
+template <typename Float>
+static void cDotBlock(double _Complex *result, Float **x, Float **y, int nx, int ny, int len)
+{
+  const int n = len / 2;
+  const int n_block = (n + host_blas_block - 1) / host_blas_block;
+  const int m = 2 * nx * ny;
+  std::vector<double> partial(static_cast<size_t>(n_block) * m);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int b = 0; b < n_block; b++) {
+    const int begin = b * host_blas_block;
+    const int end = std::min(begin + host_blas_block, n);
+    double *p = partial.data() + static_cast<size_t>(b) * m;
+    for (int i = 0; i < nx; i++) {
+      const Float *xi = x[i];
+      for (int j = 0; j < ny; j++) {
+        const Float *yj = y[j];
+        double re = 0.0, im = 0.0;
+        for (int k = begin; k < end; k++) {
+          re += xi[2 * k + 0] * yj[2 * k + 0] + xi[2 * k + 1] * yj[2 * k + 1];
+          im += xi[2 * k + 0] * yj[2 * k + 1] - xi[2 * k + 1] * yj[2 * k + 0];
+        }
+        p[2 * (i * ny + j) + 0] = re;
+        p[2 * (i * ny + j) + 1] = im;
+      }
+    }
+  }
+
+  std::vector<double> sum(m, 0.0);
+  for (int b = 0; b < n_block; b++)
+    for (int k = 0; k < m; k++) sum[k] += partial[static_cast<size_t>(b) * m + k];
+
+  comm_allreduce_array(sum.data(), sum.size());
+  double *result_ri = (double *)result;
+  for (int k = 0; k < m; k++) result_ri[k] = sum[k];
+}
+
+void cdot_block(double _Complex *result, void **x, void **y, int nx, int ny, int len, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION) cDotBlock(result, (double **)x, (double **)y, nx, ny, len);
+  else cDotBlock(result, (float **)x, (float **)y, nx, ny, len);
+}
+
+double _Complex cdot(void *x, void *y, int len, QudaPrecision precision)
+{
+  double _Complex result;
+  cdot_block(&result, &x, &y, 1, 1, len, precision);
+  return result;
+}
+
 // CPU-style BLAS routines for staggered
 void cpu_axy(QudaPrecision prec, double a, void *x, void *y, int size)
 {
   if (prec == QUDA_DOUBLE_PRECISION) {
     double *dst = (double *)y;
     double *src = (double *)x;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < size; i++) { dst[i] = a * src[i]; }
   } else { // QUDA_SINGLE_PRECISION
     float *dst = (float *)y;
     float *src = (float *)x;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < size; i++) { dst[i] = a * src[i]; }
   }
 }
@@ -89,10 +225,16 @@ void cpu_xpy(QudaPrecision prec, void *x, void *y, int size)
   if (prec == QUDA_DOUBLE_PRECISION) {
     double *dst = (double *)y;
     double *src = (double *)x;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < size; i++) { dst[i] += src[i]; }
   } else { // QUDA_SINGLE_PRECISION
     float *dst = (float *)y;
     float *src = (float *)x;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < size; i++) { dst[i] += src[i]; }
   }
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <limits>
 #include <complex>
 #include <stdlib.h>
@@ -22,6 +23,7 @@
 
 #include <misc.h>
 #include <qio_field.h>
+#include <wilson_dslash_reference.h>
 
 template <typename T> using complex = std::complex<T>;
 
@@ -49,6 +51,61 @@ double kappa5;
 
 extern float fat_link_max;
 
+// Random streams used by the counter-based generator, so that the
+// different fields built from the same seed are independent
+static constexpr uint32_t unitary_link_stream = 0;    // 0-3: one per direction
+static constexpr uint32_t fat_link_stream = 4;        // 4-7: one per direction
+static constexpr uint32_t spinor_stream = 8;          // 8-: one per source index
+
+// seed used for the host gauge fields
+static constexpr uint64_t host_gauge_seed = 137;
+
+void philox4x32(uint32_t ctr[4], uint32_t key[2])
+{
+  constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+  constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+  for (int r = 0; r < 10; r++) {
+    if (r > 0) {
+      key[0] += W0;
+      key[1] += W1;
+    }
+    uint64_t p0 = static_cast<uint64_t>(M0) * ctr[0];
+    uint64_t p1 = static_cast<uint64_t>(M1) * ctr[2];
+    uint32_t c1 = ctr[1], c3 = ctr[3];
+    ctr[0] = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ key[0];
+    ctr[1] = static_cast<uint32_t>(p1);
+    ctr[2] = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ key[1];
+    ctr[3] = static_cast<uint32_t>(p0);
+  }
+}
+
+void counterRandomUniform(double *r, int n, uint64_t seed, uint64_t site, uint32_t stream)
+{
+  for (int b = 0; 4 * b < n; b++) {
+    uint32_t ctr[4] = {static_cast<uint32_t>(site), static_cast<uint32_t>(site >> 32), stream, static_cast<uint32_t>(b)};
+    uint32_t key[2] = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    philox4x32(ctr, key);
+    for (int i = 0; i < 4 && 4 * b + i < n; i++) r[4 * b + i] = (ctr[i] + 0.5) / 4294967296.0;
+  }
+}
+
+uint64_t globalSiteIndex(const int x[4], int index, int oddBit)
+{
+  int za = index / (x[0] / 2);
+  int x1h = index - za * (x[0] / 2);
+  int zb = za / x[1];
+  int x2 = za - zb * x[1];
+  int x4 = zb / x[2];
+  int x3 = zb - x4 * x[2];
+  int x1 = 2 * x1h + ((x2 + x3 + x4 + oddBit) & 1);
+
+  int coord[4] = {x1, x2, x3, x4};
+  uint64_t site = 0;
+  for (int d = 3; d >= 0; d--) site = site * (x[d] * comm_dim(d)) + coord[d] + comm_coord(d) * x[d];
+  return site;
+}
+
 // Set some local QUDA precision variables
 QudaPrecision local_prec = QUDA_DOUBLE_PRECISION;
 QudaPrecision &cpu_prec = local_prec;
@@ -183,7 +240,7 @@ void constructHostGaugeField(void **gauge, QudaGaugeParam &gauge_param, int argc
   constructQudaGaugeField(gauge, construct_type, gauge_param.cpu_prec, &gauge_param);
 }
 
-void constructHostCloverField(void *clover, void *, QudaInvertParam &inv_param)
+void constructHostCloverField(void *clover, void *clover_inv, QudaInvertParam &inv_param)
 {
   double norm = 0.01; // clover components are random numbers in the range (-norm, norm)
   double diag = 1.0;  // constant added to the diagonal
@@ -194,6 +251,20 @@ void constructHostCloverField(void *clover, void *, QudaInvertParam &inv_param)
   if (compute_clover) inv_param.return_clover = 1;
   inv_param.compute_clover_inverse = 1;
   inv_param.return_clover_inverse = 1;
+
+  // if the clover field is constructed on the host then so is its inverse,
+  // rather than having it copied back from the device
+  if (!compute_clover && clover_inv) {
+    bool twisted = inv_param.dslash_type == QUDA_TWISTED_CLOVER_DSLASH && inv_param.twist_flavor != QUDA_TWIST_NO;
+    double mu2 = 0.0;
+    if (twisted) {
+      mu2 = 4.0 * inv_param.kappa * inv_param.kappa * inv_param.mu * inv_param.mu;
+      if (inv_param.twist_flavor == QUDA_TWIST_NONDEG_DOUBLET)
+        mu2 -= 4.0 * inv_param.kappa * inv_param.kappa * inv_param.epsilon * inv_param.epsilon;
+    }
+    compute_clover_inverse(clover_inv, clover, twisted, mu2, inv_param.clover_cpu_prec);
+    inv_param.return_clover_inverse = 0;
+  }
 }
 
 void constructQudaCloverField(void *clover, double norm, double diag, QudaPrecision precision)
@@ -237,25 +308,51 @@ void constructWilsonTestSpinorParam(quda::ColorSpinorParam *cs_param, const Quda
   cs_param->location = QUDA_CPU_FIELD_LOCATION;
 }
 
+template <typename Float>
+static void constructRandomSpinorSource(Float *v, int nSpin, int nColor, int nParity, const int x[4], int Ls,
+                                        uint64_t seed, uint32_t stream)
+{
+  const int site_size = 2 * nSpin * nColor;
+  const int volume_cb = x[0] * x[1] * x[2] * x[3] / 2;
+  uint64_t global_volume = 1;
+  for (int d = 0; d < 4; d++) global_volume *= x[d] * comm_dim(d);
+
+  for (int parity = 0; parity < nParity; parity++) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < Ls * volume_cb; i++) {
+      int s = i / volume_cb;
+      uint64_t site = s * global_volume + globalSiteIndex(x, i - s * volume_cb, parity);
+      std::vector<double> r(site_size);
+      counterRandomUniform(r.data(), site_size, seed, site, stream);
+      Float *vi = v + (static_cast<size_t>(parity) * Ls * volume_cb + i) * site_size;
+      for (int j = 0; j < site_size; j++) vi[j] = r[j];
+    }
+  }
+}
+
 void constructRandomSpinorSource(void *v, int nSpin, int nColor, QudaPrecision precision, QudaSolutionType sol_type,
-                                 const int *const x, int nDim, quda::RNG &rng)
-{
-  quda::ColorSpinorParam param;
-  param.v = v;
-  param.nColor = nColor;
-  param.nSpin = nSpin;
-  param.setPrecision(precision);
-  param.create = QUDA_REFERENCE_FIELD_CREATE;
-  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
-  param.nDim = nDim;
-  param.pc_type = QUDA_4D_PC;
-  param.siteSubset = isPCSolution(sol_type) ? QUDA_PARITY_SITE_SUBSET : QUDA_FULL_SITE_SUBSET;
-  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
-  param.location = QUDA_CPU_FIELD_LOCATION; // DMH FIXME so one can construct device noise
-  for (int d = 0; d < nDim; d++) param.x[d] = x[d];
-  if (isPCSolution(sol_type)) param.x[0] /= 2;
-  quda::ColorSpinorField spinor_in(param);
-  quda::spinorNoise(spinor_in, rng, QUDA_NOISE_UNIFORM);
+                                 const int *const x, int nDim, quda::RNG &rng, int source)
+{
+  // the field is filled on the host with the counter-based generator
+  // keyed by the seed of rng, so the source is independent of the
+  // process grid and of the number of threads.  Each source index
+  // draws from its own stream, so that the sources of a test differ.
+  if (source < 0) errorQuda("Invalid source index %d", source);
+  const uint32_t stream = spinor_stream + source;
+
+  const int X[4] = {x[0], x[1], x[2], x[3]};
+  const int Ls = nDim == 5 ? x[4] : 1;
+  const int nParity = isPCSolution(sol_type) ? 1 : 2;
+
+  if (precision == QUDA_DOUBLE_PRECISION) {
+    constructRandomSpinorSource(static_cast<double *>(v), nSpin, nColor, nParity, X, Ls, rng.Seed(), stream);
+  } else if (precision == QUDA_SINGLE_PRECISION) {
+    constructRandomSpinorSource(static_cast<float *>(v), nSpin, nColor, nParity, X, Ls, rng.Seed(), stream);
+  } else {
+    errorQuda("Unsupported precision %d", precision);
+  }
 }
 
 void initComms(int argc, char **argv, std::array<int, 4> &commDims) { initComms(argc, argv, commDims.data()); }
@@ -273,7 +370,11 @@ void initComms(int, char **, int *const commDims)
   QMP_thread_level_t tl;
   QMP_init_msg_passing(&argc, &argv, QMP_THREAD_SINGLE, &tl);
 
-  // make sure the QMP logical ordering matches QUDA's
+  // make sure the QMP logical ordering matches QUDA's.  QMP can only
+  // permute the dimensions, so it cannot express the topology-aware
+  // rank assignment, which is only available with MPI
+  if (rank_order == 2) errorQuda("Topology-aware rank order is not supported with QMP");
+
   if (rank_order == 0) {
     int map[] = {3, 2, 1, 0};
     QMP_declare_logical_topology_map(commDims, 4, map, 4);
@@ -285,9 +386,13 @@ void initComms(int, char **, int *const commDims)
   MPI_Init(&argc, &argv);
 #endif
 
-  QudaCommsMap func = rank_order == 0 ? lex_rank_from_coords_t : lex_rank_from_coords_x;
-
-  initCommsGridQuda(4, commDims, func, NULL);
+  if (rank_order == 2) {
+    // topology-aware mapping, weighting each dimension by the local face volume
+    initCommsGridTopologyQuda(4, commDims, dim.data());
+  } else {
+    QudaCommsMap func = rank_order == 0 ? lex_rank_from_coords_t : lex_rank_from_coords_x;
+    initCommsGridQuda(4, commDims, func, NULL);
+  }
 
   for (int d = 0; d < 4; d++) {
     if (dim_partitioned[d]) { commDimPartitionedSet(d); }
@@ -295,8 +400,11 @@ void initComms(int, char **, int *const commDims)
 
   initRand();
 
-  printfQuda("Rank order is %s major (%s running fastest)\n", rank_order == 0 ? "column" : "row",
-             rank_order == 0 ? "t" : "x");
+  if (rank_order == 2)
+    printfQuda("Rank order is topology aware\n");
+  else
+    printfQuda("Rank order is %s major (%s running fastest)\n", rank_order == 0 ? "column" : "row",
+               rank_order == 0 ? "t" : "x");
 }
 
 void finalizeComms()
@@ -885,15 +993,180 @@ void su3_reconstruct(void *mat, int dir, int ga_idx, QudaReconstructType reconst
   }
 }
 
-template <typename Float> static int compareFloats(Float *a, Float *b, int len, double epsilon)
+FieldCompareStats::FieldCompareStats(int site_size, double epsilon) :
+  site_size(site_size), epsilon(epsilon), max_abs(site_size, 0.0), fails(site_size, 0)
 {
-  for (int i = 0; i < len; i++) {
-    double diff = fabs(a[i] - b[i]);
-    if (diff > epsilon || std::isnan(diff)) {
-      printfQuda("ERROR: i=%d, a[%d]=%f, b[%d]=%f\n", i, i, a[i], i, b[i]);
-      return 0;
+}
+
+// order sites by decreasing deviation, breaking ties by site index so
+// that the selection does not depend on the number of threads
+static bool worseSite(const FieldCompareStats::Site &a, const FieldCompareStats::Site &b)
+{
+  return a.diff > b.diff || (a.diff == b.diff && a.site < b.site);
+}
+
+static void insertWorstSite(std::vector<FieldCompareStats::Site> &worst, const FieldCompareStats::Site &site)
+{
+  if (worst.size() == FieldCompareStats::n_worst && !worseSite(site, worst.back())) return;
+  worst.insert(std::upper_bound(worst.begin(), worst.end(), site, worseSite), site);
+  if (worst.size() > FieldCompareStats::n_worst) worst.pop_back();
+}
+
+void FieldCompareStats::merge(const FieldCompareStats &other)
+{
+  count += other.count;
+  for (int j = 0; j < site_size; j++) {
+    max_abs[j] = std::max(max_abs[j], other.max_abs[j]);
+    fails[j] += other.fails[j];
+  }
+  for (int f = 0; f < n_dev; f++) dev_fails[f] += other.dev_fails[f];
+  for (int k = 0; k < n_ulp; k++) ulp_hist[k] += other.ulp_hist[k];
+  norm2_diff += other.norm2_diff;
+  norm2_ref += other.norm2_ref;
+  for (auto &site : other.worst) insertWorstSite(worst, site);
+}
+
+size_t FieldCompareStats::total_fails() const
+{
+  size_t total = 0;
+  for (auto f : fails) total += f;
+  return total;
+}
+
+double FieldCompareStats::rel_l2() const { return norm2_ref > 0.0 ? sqrt(norm2_diff / norm2_ref) : sqrt(norm2_diff); }
+
+// distance in units in the last place, i.e., the number of
+// representable values between a and b
+template <typename Float> static uint64_t ulpDistance(Float a, Float b)
+{
+  using Int = typename std::conditional<sizeof(Float) == sizeof(int64_t), int64_t, int32_t>::type;
+  Int ia, ib;
+  memcpy(&ia, &a, sizeof(Float));
+  memcpy(&ib, &b, sizeof(Float));
+  // map the sign-magnitude representation onto a monotonic integer scale
+  if (ia < 0) ia = std::numeric_limits<Int>::min() - ia;
+  if (ib < 0) ib = std::numeric_limits<Int>::min() - ib;
+  uint64_t ua = static_cast<uint64_t>(static_cast<int64_t>(ia));
+  uint64_t ub = static_cast<uint64_t>(static_cast<int64_t>(ib));
+  return ia >= ib ? ua - ub : ub - ua;
+}
+
+template <typename Float>
+static FieldCompareStats compareFields(const Float *a, const Float *b, size_t n_sites, int site_size, double epsilon)
+{
+  double threshold[FieldCompareStats::n_dev];
+  for (int f = 0; f < FieldCompareStats::n_dev; f++) threshold[f] = pow(10.0, -(f + 1));
+  constexpr double inf = std::numeric_limits<double>::infinity();
+
+  // the sites are split into blocks of fixed size whose statistics
+  // are merged in order, so that the result does not depend on the
+  // number of threads
+  constexpr size_t block = 4096;
+  const size_t n_blocks = (n_sites + block - 1) / block;
+  std::vector<FieldCompareStats> partial(n_blocks, FieldCompareStats(site_size, epsilon));
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (size_t k = 0; k < n_blocks; k++) {
+    FieldCompareStats &local = partial[k];
+    for (size_t s = k * block; s < std::min(n_sites, (k + 1) * block); s++) {
+      FieldCompareStats::Site site = {0.0, s, 0};
+      for (int j = 0; j < site_size; j++) {
+        Float ai = a[s * site_size + j];
+        Float bi = b[s * site_size + j];
+        double diff = fabs(static_cast<double>(ai) - static_cast<double>(bi));
+        bool nan = std::isnan(diff);
+        if (nan) diff = inf;
+
+        local.max_abs[j] = std::max(local.max_abs[j], diff);
+        if (diff > epsilon) local.fails[j]++;
+        for (int f = 0; f < FieldCompareStats::n_dev && diff > threshold[f]; f++) local.dev_fails[f]++;
+
+        if (nan) {
+          local.ulp_hist[FieldCompareStats::n_ulp - 1]++;
+        } else {
+          int bin = 0;
+          for (uint64_t ulp = ulpDistance(ai, bi); ulp; ulp >>= 1) bin++;
+          local.ulp_hist[bin]++;
+          local.norm2_diff += diff * diff;
+          local.norm2_ref += static_cast<double>(bi) * bi;
+        }
+
+        if (diff > site.diff) {
+          site.diff = diff;
+          site.component = j;
+        }
+      }
+      local.count += site_size;
+      if (site.diff > 0.0) insertWorstSite(local.worst, site);
     }
   }
+
+  FieldCompareStats stats(site_size, epsilon);
+  for (auto &p : partial) stats.merge(p);
+
+  return stats;
+}
+
+FieldCompareStats compare_fields(const void *a, const void *b, size_t n_sites, int site_size, double epsilon,
+                                 QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    return compareFields((const double *)a, (const double *)b, n_sites, site_size, epsilon);
+  else
+    return compareFields((const float *)a, (const float *)b, n_sites, site_size, epsilon);
+}
+
+void print_field_compare_stats(const FieldCompareStats &stats, bool lattice_sites)
+{
+  printfQuda("Failures = %zu / %zu (epsilon = %e), relative L2 deviation = %e\n", stats.total_fails(), stats.count,
+             stats.epsilon, stats.rel_l2());
+
+  if (stats.site_size > 1) {
+    printfQuda("Component max deviation:\n");
+    for (int j = 0; j < stats.site_size; j++) printfQuda("%3d: %e (%zu fails)\n", j, stats.max_abs[j], stats.fails[j]);
+  }
+
+  printfQuda("ULP distance histogram:\n");
+  for (int k = 0; k < FieldCompareStats::n_ulp; k++) {
+    if (stats.ulp_hist[k] == 0) continue;
+    if (k == 0)
+      printfQuda("  0 ulp: %zu\n", stats.ulp_hist[k]);
+    else if (k == FieldCompareStats::n_ulp - 1)
+      printfQuda("  NaN: %zu\n", stats.ulp_hist[k]);
+    else
+      printfQuda("  [2^%d, 2^%d) ulp: %zu\n", k - 1, k, stats.ulp_hist[k]);
+  }
+
+  if (stats.worst.size() > 0) printfQuda("Worst sites:\n");
+  for (auto &w : stats.worst) {
+    if (lattice_sites) {
+      int parity = w.site / Vh;
+      int full_idx = fullLatticeIndex(w.site - parity * Vh, parity);
+      int x[4];
+      for (int d = 0; d < 4; d++) {
+        x[d] = full_idx % Z[d] + comm_coord(d) * Z[d];
+        full_idx /= Z[d];
+      }
+      printfQuda("  site %zu (%d, %d, %d, %d) component %d: deviation = %e\n", w.site, x[0], x[1], x[2], x[3],
+                 w.component, w.diff);
+    } else {
+      printfQuda("  site %zu component %d: deviation = %e\n", w.site, w.component, w.diff);
+    }
+  }
+}
+
+template <typename Float> static int compareFloats(Float *a, Float *b, int len, double epsilon)
+{
+  auto stats = compareFields(a, b, len, 1, epsilon);
+  if (stats.total_fails() > 0) {
+    size_t i = stats.worst[0].site;
+    printfQuda("ERROR: i=%zu, a[%zu]=%f, b[%zu]=%f\n", i, i, a[i], i, b[i]);
+    print_field_compare_stats(stats, false);
+    return 0;
+  }
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) print_field_compare_stats(stats, false);
   return 1;
 }
 
@@ -905,6 +1178,37 @@ int compare_floats(void *a, void *b, int len, double epsilon, QudaPrecision prec
     return compareFloats((float *)a, (float *)b, len, epsilon);
 }
 
+void compare_spinor(void *spinor_cpu, void *spinor_gpu, int len, QudaPrecision precision)
+{
+  const int fail_check = 16;
+
+  auto stats = compare_fields(spinor_gpu, spinor_cpu, len, spinor_site_size, getTolerance(precision), precision);
+
+  for (int f = 0; f < fail_check; f++) {
+    printfQuda("%e Failures: %zu / %zu  = %e\n", pow(10.0, -(f + 1)), stats.dev_fails[f], stats.count,
+               stats.dev_fails[f] / (double)stats.count);
+  }
+
+  print_field_compare_stats(stats, len == V);
+}
+
+void strong_check(void *spinor, void *spinorGPU, int len, QudaPrecision precision)
+{
+  printfQuda("Reference:\n");
+  printSpinorElement(spinor, 0, precision);
+  printfQuda("...\n");
+  printSpinorElement(spinor, len - 1, precision);
+  printfQuda("\n");
+
+  printfQuda("\nCUDA:\n");
+  printSpinorElement(spinorGPU, 0, precision);
+  printfQuda("...\n");
+  printSpinorElement(spinorGPU, len - 1, precision);
+  printfQuda("\n");
+
+  compare_spinor(spinor, spinorGPU, len, precision);
+}
+
 // 4d checkerboard.
 // given a "half index" i into either an even or odd half lattice (corresponding
 // to oddBit = {0, 1}), returns the corresponding full lattice index.
@@ -1057,63 +1361,50 @@ template <typename Float> static void orthogonalize(complex<Float> *a, complex<F
   for (int i = 0; i < len; i++) b[i] -= (complex<Float>)dot * a[i];
 }
 
-template <typename Float> void constructRandomGaugeField(Float **res, QudaGaugeParam *param, QudaDslashType dslash_type)
+// fill the link with a random SU(3) matrix: the last two rows are
+// drawn from the generator and orthonormalized, and the first row is
+// their conjugate cross product
+template <typename Float> static void constructRandomSU3(Float *link, uint64_t site, uint32_t stream)
 {
-  Float *resOdd[4], *resEven[4];
-  for (int dir = 0; dir < 4; dir++) {
-    resEven[dir] = res[dir];
-    resOdd[dir] = res[dir] + Vh * gauge_site_size;
-  }
+  double r[12];
+  counterRandomUniform(r, 12, host_gauge_seed, site, stream);
+  for (int j = 0; j < 12; j++) link[6 + j] = r[j];
 
-  for (int dir = 0; dir < 4; dir++) {
-    for (int i = 0; i < Vh; i++) {
-      for (int m = 1; m < 3; m++) {   // last 2 rows
-        for (int n = 0; n < 3; n++) { // 3 columns
-          resEven[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 0] = rand() / (Float)RAND_MAX;
-          resEven[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 1] = rand() / (Float)RAND_MAX;
-          resOdd[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 0] = rand() / (Float)RAND_MAX;
-          resOdd[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 1] = rand() / (Float)RAND_MAX;
-        }
-      }
-      normalize((complex<Float> *)(resEven[dir] + (i * 3 + 1) * 3 * 2), 3);
-      orthogonalize((complex<Float> *)(resEven[dir] + (i * 3 + 1) * 3 * 2),
-                    (complex<Float> *)(resEven[dir] + (i * 3 + 2) * 3 * 2), 3);
-      normalize((complex<Float> *)(resEven[dir] + (i * 3 + 2) * 3 * 2), 3);
-
-      normalize((complex<Float> *)(resOdd[dir] + (i * 3 + 1) * 3 * 2), 3);
-      orthogonalize((complex<Float> *)(resOdd[dir] + (i * 3 + 1) * 3 * 2),
-                    (complex<Float> *)(resOdd[dir] + (i * 3 + 2) * 3 * 2), 3);
-      normalize((complex<Float> *)(resOdd[dir] + (i * 3 + 2) * 3 * 2), 3);
-
-      {
-        Float *w = resEven[dir] + (i * 3 + 0) * 3 * 2;
-        Float *u = resEven[dir] + (i * 3 + 1) * 3 * 2;
-        Float *v = resEven[dir] + (i * 3 + 2) * 3 * 2;
-
-        for (int n = 0; n < 6; n++) w[n] = 0.0;
-        accumulateConjugateProduct(w + 0 * (2), u + 1 * (2), v + 2 * (2), +1);
-        accumulateConjugateProduct(w + 0 * (2), u + 2 * (2), v + 1 * (2), -1);
-        accumulateConjugateProduct(w + 1 * (2), u + 2 * (2), v + 0 * (2), +1);
-        accumulateConjugateProduct(w + 1 * (2), u + 0 * (2), v + 2 * (2), -1);
-        accumulateConjugateProduct(w + 2 * (2), u + 0 * (2), v + 1 * (2), +1);
-        accumulateConjugateProduct(w + 2 * (2), u + 1 * (2), v + 0 * (2), -1);
-      }
+  normalize((complex<Float> *)(link + 1 * 3 * 2), 3);
+  orthogonalize((complex<Float> *)(link + 1 * 3 * 2), (complex<Float> *)(link + 2 * 3 * 2), 3);
+  normalize((complex<Float> *)(link + 2 * 3 * 2), 3);
+
+  Float *w = link + 0 * 3 * 2;
+  Float *u = link + 1 * 3 * 2;
+  Float *v = link + 2 * 3 * 2;
 
-      {
-        Float *w = resOdd[dir] + (i * 3 + 0) * 3 * 2;
-        Float *u = resOdd[dir] + (i * 3 + 1) * 3 * 2;
-        Float *v = resOdd[dir] + (i * 3 + 2) * 3 * 2;
-
-        for (int n = 0; n < 6; n++) w[n] = 0.0;
-        accumulateConjugateProduct(w + 0 * (2), u + 1 * (2), v + 2 * (2), +1);
-        accumulateConjugateProduct(w + 0 * (2), u + 2 * (2), v + 1 * (2), -1);
-        accumulateConjugateProduct(w + 1 * (2), u + 2 * (2), v + 0 * (2), +1);
-        accumulateConjugateProduct(w + 1 * (2), u + 0 * (2), v + 2 * (2), -1);
-        accumulateConjugateProduct(w + 2 * (2), u + 0 * (2), v + 1 * (2), +1);
-        accumulateConjugateProduct(w + 2 * (2), u + 1 * (2), v + 0 * (2), -1);
+  for (int n = 0; n < 6; n++) w[n] = 0.0;
+  accumulateConjugateProduct(w + 0 * (2), u + 1 * (2), v + 2 * (2), +1);
+  accumulateConjugateProduct(w + 0 * (2), u + 2 * (2), v + 1 * (2), -1);
+  accumulateConjugateProduct(w + 1 * (2), u + 2 * (2), v + 0 * (2), +1);
+  accumulateConjugateProduct(w + 1 * (2), u + 0 * (2), v + 2 * (2), -1);
+  accumulateConjugateProduct(w + 2 * (2), u + 0 * (2), v + 1 * (2), +1);
+  accumulateConjugateProduct(w + 2 * (2), u + 1 * (2), v + 0 * (2), -1);
+}
+
+template <typename Float> void constructUnitaryGaugeField(Float **res)
+{
+  for (int dir = 0; dir < 4; dir++) {
+    for (int parity = 0; parity < 2; parity++) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (int i = 0; i < Vh; i++) {
+        constructRandomSU3(res[dir] + (parity * Vh + i) * gauge_site_size, globalSiteIndex(Z, i, parity),
+                           unitary_link_stream + dir);
       }
     }
   }
+}
+
+template <typename Float> void constructRandomGaugeField(Float **res, QudaGaugeParam *param, QudaDslashType dslash_type)
+{
+  constructUnitaryGaugeField(res);
 
   if (param->type == QUDA_WILSON_LINKS) {
     applyGaugeFieldScaling(res, Vh, param);
@@ -1121,13 +1412,22 @@ template <typename Float> void constructRandomGaugeField(Float **res, QudaGaugeP
     applyGaugeFieldScaling_long(res, Vh, param, dslash_type);
   } else if (param->type == QUDA_ASQTAD_FAT_LINKS) {
     for (int dir = 0; dir < 4; dir++) {
-      for (int i = 0; i < Vh; i++) {
-        for (int m = 0; m < 3; m++) {   // last 2 rows
-          for (int n = 0; n < 3; n++) { // 3 columns
-            resEven[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 0] = 1.0 * rand() / (Float)RAND_MAX;
-            resEven[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 1] = 2.0 * rand() / (Float)RAND_MAX;
-            resOdd[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 0] = 3.0 * rand() / (Float)RAND_MAX;
-            resOdd[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 1] = 4.0 * rand() / (Float)RAND_MAX;
+      for (int parity = 0; parity < 2; parity++) {
+        // fat links are not unitary: use a different scale for each of
+        // the real and imaginary parts on each parity
+        const double re_scale = parity ? 3.0 : 1.0;
+        const double im_scale = parity ? 4.0 : 2.0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < Vh; i++) {
+          double r[gauge_site_size];
+          counterRandomUniform(r, gauge_site_size, host_gauge_seed, globalSiteIndex(Z, i, parity),
+                               fat_link_stream + dir);
+          Float *link = res[dir] + (parity * Vh + i) * gauge_site_size;
+          for (int j = 0; j < gauge_site_size / 2; j++) {
+            link[2 * j + 0] = re_scale * r[2 * j + 0];
+            link[2 * j + 1] = im_scale * r[2 * j + 1];
           }
         }
       }
@@ -1138,65 +1438,6 @@ template <typename Float> void constructRandomGaugeField(Float **res, QudaGaugeP
 template void constructRandomGaugeField(float **res, QudaGaugeParam *param, QudaDslashType dslash_type);
 template void constructRandomGaugeField(double **res, QudaGaugeParam *param, QudaDslashType dslash_type);
 
-template <typename Float> void constructUnitaryGaugeField(Float **res)
-{
-  Float *resOdd[4], *resEven[4];
-  for (int dir = 0; dir < 4; dir++) {
-    resEven[dir] = res[dir];
-    resOdd[dir] = res[dir] + Vh * gauge_site_size;
-  }
-
-  for (int dir = 0; dir < 4; dir++) {
-    for (int i = 0; i < Vh; i++) {
-      for (int m = 1; m < 3; m++) {   // last 2 rows
-        for (int n = 0; n < 3; n++) { // 3 columns
-          resEven[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 0] = rand() / (Float)RAND_MAX;
-          resEven[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 1] = rand() / (Float)RAND_MAX;
-          resOdd[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 0] = rand() / (Float)RAND_MAX;
-          resOdd[dir][i * (3 * 3 * 2) + m * (3 * 2) + n * (2) + 1] = rand() / (Float)RAND_MAX;
-        }
-      }
-      normalize((complex<Float> *)(resEven[dir] + (i * 3 + 1) * 3 * 2), 3);
-      orthogonalize((complex<Float> *)(resEven[dir] + (i * 3 + 1) * 3 * 2),
-                    (complex<Float> *)(resEven[dir] + (i * 3 + 2) * 3 * 2), 3);
-      normalize((complex<Float> *)(resEven[dir] + (i * 3 + 2) * 3 * 2), 3);
-
-      normalize((complex<Float> *)(resOdd[dir] + (i * 3 + 1) * 3 * 2), 3);
-      orthogonalize((complex<Float> *)(resOdd[dir] + (i * 3 + 1) * 3 * 2),
-                    (complex<Float> *)(resOdd[dir] + (i * 3 + 2) * 3 * 2), 3);
-      normalize((complex<Float> *)(resOdd[dir] + (i * 3 + 2) * 3 * 2), 3);
-
-      {
-        Float *w = resEven[dir] + (i * 3 + 0) * 3 * 2;
-        Float *u = resEven[dir] + (i * 3 + 1) * 3 * 2;
-        Float *v = resEven[dir] + (i * 3 + 2) * 3 * 2;
-
-        for (int n = 0; n < 6; n++) w[n] = 0.0;
-        accumulateConjugateProduct(w + 0 * (2), u + 1 * (2), v + 2 * (2), +1);
-        accumulateConjugateProduct(w + 0 * (2), u + 2 * (2), v + 1 * (2), -1);
-        accumulateConjugateProduct(w + 1 * (2), u + 2 * (2), v + 0 * (2), +1);
-        accumulateConjugateProduct(w + 1 * (2), u + 0 * (2), v + 2 * (2), -1);
-        accumulateConjugateProduct(w + 2 * (2), u + 0 * (2), v + 1 * (2), +1);
-        accumulateConjugateProduct(w + 2 * (2), u + 1 * (2), v + 0 * (2), -1);
-      }
-
-      {
-        Float *w = resOdd[dir] + (i * 3 + 0) * 3 * 2;
-        Float *u = resOdd[dir] + (i * 3 + 1) * 3 * 2;
-        Float *v = resOdd[dir] + (i * 3 + 2) * 3 * 2;
-
-        for (int n = 0; n < 6; n++) w[n] = 0.0;
-        accumulateConjugateProduct(w + 0 * (2), u + 1 * (2), v + 2 * (2), +1);
-        accumulateConjugateProduct(w + 0 * (2), u + 2 * (2), v + 1 * (2), -1);
-        accumulateConjugateProduct(w + 1 * (2), u + 2 * (2), v + 0 * (2), +1);
-        accumulateConjugateProduct(w + 1 * (2), u + 0 * (2), v + 2 * (2), -1);
-        accumulateConjugateProduct(w + 2 * (2), u + 0 * (2), v + 1 * (2), +1);
-        accumulateConjugateProduct(w + 2 * (2), u + 1 * (2), v + 0 * (2), -1);
-      }
-    }
-  }
-}
-
 template <typename Float> void constructCloverField(Float *res, double norm, double diag)
 {
 
@@ -1227,39 +1468,26 @@ template <typename Float> void constructCloverField(Float *res, double norm, dou
 
 template <typename Float> static void checkGauge(Float **oldG, Float **newG, double epsilon)
 {
-
-  const int fail_check = 17;
-  int fail[4][fail_check];
-  int iter[4][18];
-  for (int d = 0; d < 4; d++)
-    for (int i = 0; i < fail_check; i++) fail[d][i] = 0;
-  for (int d = 0; d < 4; d++)
-    for (int i = 0; i < 18; i++) iter[d][i] = 0;
-
-  for (int d = 0; d < 4; d++) {
-    for (int eo = 0; eo < 2; eo++) {
-      for (int i = 0; i < Vh; i++) {
-        int ga_idx = (eo * Vh + i);
-        for (int j = 0; j < 18; j++) {
-          double diff = fabs(newG[d][ga_idx * 18 + j] - oldG[d][ga_idx * 18 + j]); /// fabs(oldG[d][ga_idx*18+j]);
-
-          for (int f = 0; f < fail_check; f++)
-            if (diff > pow(10.0, -(f + 1)) || std::isnan(diff)) fail[d][f]++;
-          if (diff > epsilon || std::isnan(diff)) iter[d][j]++;
-        }
-      }
-    }
-  }
+  FieldCompareStats stats[4];
+  for (int d = 0; d < 4; d++) stats[d] = compareFields(newG[d], oldG[d], V, gauge_site_size, epsilon);
 
   printf("Component fails (X, Y, Z, T)\n");
   for (int i = 0; i < 18; i++)
-    printf("%d fails = (%8d, %8d, %8d, %8d)\n", i, iter[0][i], iter[1][i], iter[2][i], iter[3][i]);
+    printf("%d fails = (%8zu, %8zu, %8zu, %8zu)\n", i, stats[0].fails[i], stats[1].fails[i], stats[2].fails[i],
+           stats[3].fails[i]);
 
   printf("\nDeviation Failures = (X, Y, Z, T)\n");
-  for (int f = 0; f < fail_check; f++) {
-    printf("%e Failures = (%9d, %9d, %9d, %9d) = (%6.5f, %6.5f, %6.5f, %6.5f)\n", pow(10.0, -(f + 1)), fail[0][f],
-           fail[1][f], fail[2][f], fail[3][f], fail[0][f] / (double)(V * 18), fail[1][f] / (double)(V * 18),
-           fail[2][f] / (double)(V * 18), fail[3][f] / (double)(V * 18));
+  for (int f = 0; f < FieldCompareStats::n_dev; f++) {
+    size_t fail[4];
+    for (int d = 0; d < 4; d++) fail[d] = stats[d].dev_fails[f];
+    printf("%e Failures = (%9zu, %9zu, %9zu, %9zu) = (%6.5f, %6.5f, %6.5f, %6.5f)\n", pow(10.0, -(f + 1)), fail[0],
+           fail[1], fail[2], fail[3], fail[0] / (double)(V * 18), fail[1] / (double)(V * 18),
+           fail[2] / (double)(V * 18), fail[3] / (double)(V * 18));
+  }
+
+  for (int d = 0; d < 4; d++) {
+    printfQuda("\nDirection %d: ", d);
+    print_field_compare_stats(stats[d], true);
   }
 }
 
@@ -1281,6 +1509,9 @@ void createSiteLinkCPU(void **link, QudaPrecision precision, int phase)
 
   if (phase) {
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int i = 0; i < V; i++) {
       for (int dir = XUP; dir <= TUP; dir++) {
         int idx = i;
@@ -1378,37 +1609,25 @@ void createSiteLinkCPU(void **link, QudaPrecision precision, int phase)
 template <typename Float> int compareLink(Float **linkA, Float **linkB, int len)
 {
   const int fail_check = 16;
-  int fail[fail_check];
-  for (int f = 0; f < fail_check; f++) fail[f] = 0;
 
-  int iter[18];
-  for (int i = 0; i < 18; i++) iter[i] = 0;
+  FieldCompareStats stats(gauge_site_size, 1e-3);
+  for (int dir = 0; dir < 4; dir++) stats.merge(compareFields(linkA[dir], linkB[dir], len, gauge_site_size, 1e-3));
 
-  for (int dir = 0; dir < 4; dir++) {
-    for (int i = 0; i < len; i++) {
-      for (int j = 0; j < 18; j++) {
-        int is = i * 18 + j;
-        double diff = fabs(linkA[dir][is] - linkB[dir][is]);
-        for (int f = 0; f < fail_check; f++)
-          if (diff > pow(10.0, -(f + 1)) || std::isnan(diff)) fail[f]++;
-        // if (diff > 1e-1) printf("%d %d %e\n", i, j, diff);
-        if (diff > 1e-3 || std::isnan(diff)) iter[j]++;
-      }
-    }
-  }
-
-  for (int i = 0; i < 18; i++) printfQuda("%d fails = %d\n", i, iter[i]);
+  for (int i = 0; i < 18; i++) printfQuda("%d fails = %zu\n", i, stats.fails[i]);
 
   int accuracy_level = 0;
   for (int f = 0; f < fail_check; f++) {
-    if (fail[f] == 0) { accuracy_level = f; }
+    if (stats.dev_fails[f] == 0) { accuracy_level = f; }
   }
 
   for (int f = 0; f < fail_check; f++) {
-    printfQuda("%e Failures: %d / %d  = %e\n", pow(10.0, -(f + 1)), fail[f], 4 * len * 18,
-               fail[f] / (double)(4 * len * 18));
+    printfQuda("%e Failures: %zu / %d  = %e\n", pow(10.0, -(f + 1)), stats.dev_fails[f], 4 * len * 18,
+               stats.dev_fails[f] / (double)(4 * len * 18));
   }
 
+  // worst sites are taken over all four directions
+  print_field_compare_stats(stats, len == V);
+
   return accuracy_level;
 }
 
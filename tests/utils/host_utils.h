@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <array>
 #include <quda.h>
@@ -87,6 +88,40 @@ void setQudaDefaultMgTestParams();
 
 // Wilson type gauge and clover fields
 //------------------------------------------------------
+/**
+   @brief Philox-4x32-10 bijection (Salmon et al, SC'11): maps the
+   128-bit counter and 64-bit key to four uniformly distributed 32-bit
+   words
+   @param[in,out] ctr The counter, overwritten with the output
+   @param[in,out] key The key, which is overwritten
+ */
+void philox4x32(uint32_t ctr[4], uint32_t key[2]);
+
+/**
+   @brief Fill r[0:n] with uniform random numbers in (0,1) from the
+   Philox-4x32-10 counter-based generator.  The numbers depend only on
+   (seed, site, stream, component), so a field filled site by site is
+   independent of the process grid, the site ordering and the number of
+   threads.
+   @param[out] r Output array
+   @param[in] n Number of random numbers (components) to generate
+   @param[in] seed Generator seed
+   @param[in] site Global site index, e.g., from globalSiteIndex
+   @param[in] stream Stream index, used to decorrelate different fields at the same site
+ */
+void counterRandomUniform(double *r, int n, uint64_t seed, uint64_t site, uint32_t stream);
+
+/**
+   @brief Return the global lexicographical site index of a local
+   checkerboard site, taking into account the position of this
+   process in the process grid
+   @param[in] x Local lattice dimensions
+   @param[in] index Local checkerboard site index
+   @param[in] oddBit Parity of the site
+   @return The global site index
+ */
+uint64_t globalSiteIndex(const int x[4], int index, int oddBit);
+
 void constructQudaGaugeField(void **gauge, int type, QudaPrecision precision, QudaGaugeParam *param);
 void constructHostGaugeField(void **gauge, QudaGaugeParam &gauge_param, int argc, char **argv);
 void constructHostCloverField(void *clover, void *clover_inv, QudaInvertParam &inv_param);
@@ -102,8 +137,25 @@ template <typename Float> void applyGaugeFieldScaling(Float **gauge, int Vh, Qud
 //------------------------------------------------------
 void constructWilsonTestSpinorParam(quda::ColorSpinorParam *csParam, const QudaInvertParam *inv_param,
                                     const QudaGaugeParam *gauge_param);
+/**
+   @brief Fill a host spinor field (even-odd, space-spin-color order,
+   4-d preconditioning) with uniform random numbers from the
+   counter-based generator, keyed by the seed of rng and the source
+   index.  The source is independent of the process grid and of the
+   number of threads, and distinct source indices give independent
+   sources.
+   @param[out] v The field data
+   @param[in] nSpin Number of spin components
+   @param[in] nColor Number of colors
+   @param[in] precision Precision of the field
+   @param[in] sol_type Solution type, which determines whether the field has one or two parities
+   @param[in] x Local lattice dimensions (the fifth is the extent of the fifth dimension)
+   @param[in] nDim Number of dimensions (4 or 5)
+   @param[in] rng Generator providing the seed
+   @param[in] source Index of the source
+ */
 void constructRandomSpinorSource(void *v, int nSpin, int nColor, QudaPrecision precision, QudaSolutionType sol_type,
-                                 const int *const x, int nDim, quda::RNG &rng);
+                                 const int *const x, int nDim, quda::RNG &rng, int source);
 //------------------------------------------------------
 
 // Helper functions
@@ -159,7 +211,93 @@ void su3_construct(void *mat, QudaReconstructType reconstruct, QudaPrecision pre
 void su3_reconstruct(void *mat, int dir, int ga_idx, QudaReconstructType reconstruct, QudaPrecision precision,
                      QudaGaugeParam *param);
 
+/**
+   @brief Statistics of the deviation between two host fields,
+   accumulated in a single threaded pass by compare_fields, and
+   independent of the number of threads.  NaN
+   deviations count as failures at every threshold, are binned
+   separately in the ULP histogram and rank as infinite when
+   selecting the worst sites.
+ */
+struct FieldCompareStats {
+  static constexpr int n_dev = 17;  /**< deviation thresholds 1e-1, 1e-2, ..., 1e-17 */
+  static constexpr int n_ulp = 66;  /**< ULP bins: 0, [2^(k-1), 2^k) for k = 1..64, NaN */
+  static constexpr int n_worst = 8; /**< number of worst sites retained */
+
+  struct Site {
+    double diff;   /**< maximum deviation over the site components */
+    size_t site;   /**< site index */
+    int component; /**< component with the maximum deviation */
+  };
+
+  int site_size;                            /**< number of components per site */
+  double epsilon;                           /**< tolerance used to count failures */
+  size_t count = 0;                         /**< number of components compared */
+  std::vector<double> max_abs;              /**< maximum |a - b| per component */
+  std::vector<size_t> fails;                /**< number of |a - b| > epsilon per component */
+  std::array<size_t, n_dev> dev_fails = {}; /**< number of |a - b| > 10^-(f+1) */
+  std::array<size_t, n_ulp> ulp_hist = {};  /**< histogram of ULP distances */
+  double norm2_diff = 0.0;                  /**< |a - b|^2 */
+  double norm2_ref = 0.0;                   /**< |b|^2 */
+  std::vector<Site> worst;                  /**< worst sites, ordered by decreasing deviation */
+
+  FieldCompareStats(int site_size = 1, double epsilon = 0.0);
+
+  /**
+     @brief Accumulate the statistics of another (disjoint) comparison
+   */
+  void merge(const FieldCompareStats &other);
+
+  /**
+     @return The total number of failures at tolerance epsilon
+   */
+  size_t total_fails() const;
+
+  /**
+     @return The relative L2 deviation |a - b| / |b|
+   */
+  double rel_l2() const;
+};
+
+/**
+   @brief Compare two host fields site by site in a single threaded
+   pass, accumulating the maximum deviation per component, the
+   relative L2 deviation, deviation and ULP histograms, and the worst
+   sites.
+   @param[in] a Field to check
+   @param[in] b Reference field
+   @param[in] n_sites Number of sites
+   @param[in] site_size Number of real components per site
+   @param[in] epsilon Tolerance used to count failures
+   @param[in] precision Precision of both fields
+   @return The comparison statistics
+ */
+FieldCompareStats compare_fields(const void *a, const void *b, size_t n_sites, int site_size, double epsilon,
+                                 QudaPrecision precision);
+
+/**
+   @brief Print a summary of a field comparison
+   @param[in] stats The comparison statistics
+   @param[in] lattice_sites Whether the sites are the even-odd ordered
+   sites of the local lattice, in which case the worst sites are
+   reported with their global coordinates
+ */
+void print_field_compare_stats(const FieldCompareStats &stats, bool lattice_sites);
+
+/**
+   @brief Compare a spinor field against a host reference with
+   compare_fields, printing the deviation table and summary
+   @param[in] spinor_cpu Reference spinor field
+   @param[in] spinor_gpu Spinor field to check
+   @param[in] len Number of sites
+   @param[in] precision Precision of both fields
+ */
 void compare_spinor(void *spinor_cpu, void *spinor_gpu, int len, QudaPrecision precision);
+
+/**
+   @brief Print the first and last sites of a spinor field and its
+   host reference, then compare them with compare_spinor
+ */
 void strong_check(void *spinor, void *spinorGPU, int len, QudaPrecision precision);
 int compare_floats(void *a, void *b, int len, double epsilon, QudaPrecision precision);
 
@@ -197,6 +335,52 @@ void exchange_cpu_sitelink(int *X, void **sitelink, void **ghost_sitelink, void
 void exchange_cpu_sitelink_ex(int *X, int *R, void **sitelink, QudaGaugeFieldOrder cpu_order, QudaPrecision gPrecision,
                               int optflag, int geometry);
 void exchange_cpu_staple(int *X, void *staple, void **ghost_staple, QudaPrecision gPrecision);
+/**
+   @brief Copy a host field with even-odd site order into an extended
+   field, padded by R[d] sites on both sides of each dimension, and
+   fill the halo (including corners) with one exchange per dimension.
+   The extended field has even-odd site order over the extended
+   lattice; halos of dimensions that are not partitioned are filled
+   periodically from this process.
+   @param[out] field_ex Extended field of nParity * V_ex / 2 sites
+   @param[in] field Local field of nParity * V / 2 sites
+   @param[in] X Local lattice dimensions
+   @param[in] R Halo depth in each dimension
+   @param[in] site_size Number of real numbers per site
+   @param[in] nParity Number of parities of the field (1 or 2)
+   @param[in] parity Parity (in local coordinates) of a single-parity field
+   @param[in] precision Precision of the field
+ */
+void exchange_cpu_field_ex(void *field_ex, const void *field, const int *X, const int *R, int site_size, int nParity,
+                           int parity, QudaPrecision precision);
+
+/**
+   @brief Host gauge field (QDP order) extended by a halo of depth R,
+   as cached by extend_cpu_gauge.
+ */
+struct ExtendedGaugeField {
+  void *gauge[4] = {nullptr, nullptr, nullptr, nullptr};
+  QudaPrecision precision = QUDA_INVALID_PRECISION;
+  int dims[4] = {0, 0, 0, 0};
+  int R[4] = {0, 0, 0, 0};
+  uint64_t checksum = 0;
+  std::vector<char> field_ex[4];
+};
+
+/**
+   @brief Make ex hold the host gauge field extended by R sites in
+   every dimension (see exchange_cpu_field_ex).  The halo exchange is
+   only repeated when the cached field is stale on any process, i.e.,
+   when the gauge field address, precision, contents, local volume or
+   halo depth has changed, so repeated dslash applications of a host
+   reference only exchange the spinor halo.  This function is
+   collective.
+   @param[in,out] ex Extended field cache
+   @param[in] gauge Local gauge field, one array per direction
+   @param[in] R Halo depth in each dimension
+   @param[in] precision Precision of the gauge field
+ */
+void extend_cpu_gauge(ExtendedGaugeField &ex, void **gauge, const int *R, QudaPrecision precision);
 void exchange_llfat_init(QudaPrecision prec);
 void exchange_llfat_cleanup(void);
 
@@ -207,6 +391,18 @@ void ax(double a, void *x, int len, QudaPrecision precision);
 void axpy(double a, void *x, void *y, int len, QudaPrecision precision);
 void xpay(void *x, double a, void *y, int len, QudaPrecision precision);
 void cxpay(void *x, double _Complex a, void *y, int len, QudaPrecision precision);
+void caxpy(double _Complex a, void *x, void *y, int len, QudaPrecision precision);
+double _Complex cdot(void *x, void *y, int len, QudaPrecision precision);
+/**
+   @brief Host block caxpy, matching blas::caxpy for sets of fields:
+   y[j] += sum_i a[i * ny + j] * x[i]
+ */
+void caxpy_block(const double _Complex *a, void **x, void **y, int nx, int ny, int len, QudaPrecision precision);
+/**
+   @brief Host block inner product, matching blas::cDotProduct for
+   sets of fields: result[i * ny + j] = (x[i], y[j])
+ */
+void cdot_block(double _Complex *result, void **x, void **y, int nx, int ny, int len, QudaPrecision precision);
 void cpu_axy(QudaPrecision prec, double a, void *x, void *y, int size);
 void cpu_xpy(QudaPrecision prec, void *x, void *y, int size);
 
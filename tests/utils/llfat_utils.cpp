@@ -27,8 +27,9 @@ static int Vsh[4];
 
 template <typename su3_matrix, typename Real>
 void llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu, su3_matrix *mulink, su3_matrix **sitelink,
-                                    void **fatlink, Real coef, int use_staple)
+                                    void **fatlink, Real coef, int use_staple, int dim[4])
 {
+  const int volume = dim[0] * dim[1] * dim[2] * dim[3];
   su3_matrix tmat1, tmat2;
   int i;
   su3_matrix *fat1;
@@ -50,14 +51,14 @@ void llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu, su3_matr
 
   /* upper staple */
 
-  for (i = 0; i < V; i++) {
+  for (i = 0; i < volume; i++) {
 
     fat1 = ((su3_matrix *)fatlink[mu]) + i;
     su3_matrix *A = sitelink[nu] + i;
 
     memset(dx, 0, sizeof(dx));
     dx[nu] = 1;
-    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+    int nbr_idx = neighborIndexFullLattice(dim, i, dx);
     su3_matrix *B;
     if (use_staple) {
       B = mulink + nbr_idx;
@@ -67,7 +68,7 @@ void llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu, su3_matr
 
     memset(dx, 0, sizeof(dx));
     dx[mu] = 1;
-    nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+    nbr_idx = neighborIndexFullLattice(dim, i, dx);
     su3_matrix *C = sitelink[nu] + nbr_idx;
 
     llfat_mult_su3_nn(A, B, &tmat1);
@@ -89,13 +90,13 @@ void llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu, su3_matr
    *
    *********************************************/
 
-  for (i = 0; i < V; i++) {
+  for (i = 0; i < volume; i++) {
 
     fat1 = ((su3_matrix *)fatlink[mu]) + i;
     memset(dx, 0, sizeof(dx));
     dx[nu] = -1;
-    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
-    if (nbr_idx >= V || nbr_idx < 0) {
+    int nbr_idx = neighborIndexFullLattice(dim, i, dx);
+    if (nbr_idx >= volume || nbr_idx < 0) {
       fprintf(stderr, "ERROR: invliad nbr_idx(%d), line=%d\n", nbr_idx, __LINE__);
       exit(1);
     }
@@ -110,7 +111,7 @@ void llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu, su3_matr
 
     memset(dx, 0, sizeof(dx));
     dx[mu] = 1;
-    nbr_idx = neighborIndexFullLattice(nbr_idx, dx[3], dx[2], dx[1], dx[0]);
+    nbr_idx = neighborIndexFullLattice(dim, nbr_idx, dx);
     su3_matrix *C = sitelink[nu] + nbr_idx;
 
     llfat_mult_su3_an(A, B, &tmat1);
@@ -137,10 +138,11 @@ void llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu, su3_matr
  *
  */
 template <typename su3_matrix, typename Float>
-void llfat_cpu(void **fatlink, su3_matrix **sitelink, Float *act_path_coeff)
+void llfat_cpu(void **fatlink, su3_matrix **sitelink, Float *act_path_coeff, int dim[4])
 {
-  su3_matrix *staple = (su3_matrix *)safe_malloc(V * sizeof(su3_matrix));
-  su3_matrix *tempmat1 = (su3_matrix *)safe_malloc(V * sizeof(su3_matrix));
+  const int volume = dim[0] * dim[1] * dim[2] * dim[3];
+  su3_matrix *staple = (su3_matrix *)safe_malloc(volume * sizeof(su3_matrix));
+  su3_matrix *tempmat1 = (su3_matrix *)safe_malloc(volume * sizeof(su3_matrix));
 
   // to fix up the Lepage term, included by a trick below
   Float one_link = (act_path_coeff[0] - 6.0 * act_path_coeff[5]);
@@ -148,7 +150,7 @@ void llfat_cpu(void **fatlink, su3_matrix **sitelink, Float *act_path_coeff)
   for (int dir = XUP; dir <= TUP; dir++) {
 
     // Intialize fat links with c_1*U_\mu(x)
-    for (int i = 0; i < V; i++) {
+    for (int i = 0; i < volume; i++) {
       su3_matrix *fat1 = ((su3_matrix *)fatlink[dir]) + i;
       llfat_scalar_mult_su3_matrix(sitelink[dir] + i, one_link, fat1);
     }
@@ -157,21 +159,21 @@ void llfat_cpu(void **fatlink, su3_matrix **sitelink, Float *act_path_coeff)
   for (int dir = XUP; dir <= TUP; dir++) {
     for (int nu = XUP; nu <= TUP; nu++) {
       if (nu != dir) {
-        llfat_compute_gen_staple_field(staple, dir, nu, sitelink[dir], sitelink, fatlink, act_path_coeff[2], 0);
+        llfat_compute_gen_staple_field(staple, dir, nu, sitelink[dir], sitelink, fatlink, act_path_coeff[2], 0, dim);
 
         // The Lepage term
         // Note this also involves modifying c_1 (above)
 
-        llfat_compute_gen_staple_field((su3_matrix *)NULL, dir, nu, staple, sitelink, fatlink, act_path_coeff[5], 1);
+        llfat_compute_gen_staple_field((su3_matrix *)NULL, dir, nu, staple, sitelink, fatlink, act_path_coeff[5], 1, dim);
 
         for (int rho = XUP; rho <= TUP; rho++) {
           if ((rho != dir) && (rho != nu)) {
-            llfat_compute_gen_staple_field(tempmat1, dir, rho, staple, sitelink, fatlink, act_path_coeff[3], 1);
+            llfat_compute_gen_staple_field(tempmat1, dir, rho, staple, sitelink, fatlink, act_path_coeff[3], 1, dim);
 
             for (int sig = XUP; sig <= TUP; sig++) {
               if ((sig != dir) && (sig != nu) && (sig != rho)) {
                 llfat_compute_gen_staple_field((su3_matrix *)NULL, dir, sig, tempmat1, sitelink, fatlink,
-                                               act_path_coeff[4], 1);
+                                               act_path_coeff[4], 1, dim);
               }
             } // sig
           }
@@ -188,11 +190,61 @@ void llfat_reference(void **fatlink, void **sitelink, QudaPrecision prec, void *
 {
   switch (prec) {
   case QUDA_DOUBLE_PRECISION:
-    llfat_cpu((void **)fatlink, (su3_matrix<double> **)sitelink, (double *)act_path_coeff);
+    llfat_cpu((void **)fatlink, (su3_matrix<double> **)sitelink, (double *)act_path_coeff, Z);
+    break;
+
+  case QUDA_SINGLE_PRECISION:
+    llfat_cpu((void **)fatlink, (su3_matrix<float> **)sitelink, (float *)act_path_coeff, Z);
+    break;
+
+  default:
+    fprintf(stderr, "ERROR: unsupported precision(%d)\n", prec);
+    exit(1);
+    break;
+  }
+  return;
+}
+
+/*  Fattening from a site link field extended by two sites in every
+ *  dimension.  The paths are evaluated over the whole extended lattice,
+ *  periodically in the extended dimensions, and the fat links of the
+ *  local sites are copied out: no path from a local site reaches
+ *  further than two sites, so the wrap-around only affects the
+ *  discarded halo fat links.
+ */
+template <typename su3_matrix, typename Float>
+void llfat_cpu_ex(void **fatlink, su3_matrix **sitelink_ex, Float *act_path_coeff)
+{
+  int E[4];
+  for (int d = 0; d < 4; d++) E[d] = Z[d] + 4;
+  const int volume_ex = E[0] * E[1] * E[2] * E[3];
+
+  void *fatlink_ex[4];
+  for (int dir = 0; dir < 4; dir++) fatlink_ex[dir] = safe_malloc(volume_ex * sizeof(su3_matrix));
+
+  llfat_cpu(fatlink_ex, sitelink_ex, act_path_coeff, E);
+
+  for (int i = 0; i < V; i++) {
+    const int oddBit = i >= Vh ? 1 : 0;
+    const int Y = fullLatticeIndex(i - oddBit * Vh, oddBit);
+    const int x[4] = {Y % Z[0], (Y / Z[0]) % Z[1], (Y / (Z[1] * Z[0])) % Z[2], Y / (Z[2] * Z[1] * Z[0])};
+    const int i_ex
+      = (((((x[3] + 2) * E[2] + x[2] + 2) * E[1] + x[1] + 2) * E[0] + x[0] + 2) / 2) + oddBit * (volume_ex / 2);
+    for (int dir = 0; dir < 4; dir++) ((su3_matrix *)fatlink[dir])[i] = ((su3_matrix *)fatlink_ex[dir])[i_ex];
+  }
+
+  for (int dir = 0; dir < 4; dir++) host_free(fatlink_ex[dir]);
+}
+
+void llfat_reference_ex(void **fatlink, void **sitelink_ex, QudaPrecision prec, void *act_path_coeff)
+{
+  switch (prec) {
+  case QUDA_DOUBLE_PRECISION:
+    llfat_cpu_ex((void **)fatlink, (su3_matrix<double> **)sitelink_ex, (double *)act_path_coeff);
     break;
 
   case QUDA_SINGLE_PRECISION:
-    llfat_cpu((void **)fatlink, (su3_matrix<float> **)sitelink, (float *)act_path_coeff);
+    llfat_cpu_ex((void **)fatlink, (su3_matrix<float> **)sitelink_ex, (float *)act_path_coeff);
     break;
 
   default:
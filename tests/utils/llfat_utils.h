@@ -8,6 +8,8 @@ template <typename real> struct su3_vector {
 };
 
 void llfat_reference(void **fatlink, void **sitelink, QudaPrecision prec, void *act_path_coeff);
+// fattening from a site link field extended by two sites in every dimension (V_ex sites per direction)
+void llfat_reference_ex(void **fatlink, void **sitelink_ex, QudaPrecision prec, void *act_path_coeff);
 void llfat_reference_mg(void **fatlink, void **sitelink, void **ghost_sitelink, void **ghost_sitelink_diag,
                         QudaPrecision prec, void *act_path_coeff);
 
@@ -351,11 +351,6 @@ void computeHISQLinksCPU(void **fatlink, void **longlink, void **fatlink_eps, vo
   void *sitelink_ex[4];
   for (int i = 0; i < 4; i++) sitelink_ex[i] = pinned_malloc(V_ex * gauge_site_size * gSize);
 
-#ifdef MULTI_GPU
-  void *ghost_sitelink[4];
-  void *ghost_sitelink_diag[16];
-#endif
-
   int X1 = Z[0];
   int X2 = Z[1];
   int X3 = Z[2];
@@ -411,11 +406,6 @@ void computeHISQLinksCPU(void **fatlink, void **longlink, void **fatlink_eps, vo
     w_reflink_ex[i] = safe_malloc(V_ex * gauge_site_size * gSize);
   }
 
-#ifdef MULTI_GPU
-  void *ghost_wlink[4];
-  void *ghost_wlink_diag[16];
-#endif
-
   // Copy of V link needed for CPU unitarization routines
   void *v_sitelink = pinned_malloc(4 * V * gauge_site_size * gSize);
 
@@ -434,36 +424,10 @@ void computeHISQLinksCPU(void **fatlink, void **longlink, void **fatlink_eps, vo
 
   // Only need fat links.
 #ifdef MULTI_GPU
-  int optflag = 0;
-  // we need x,y,z site links in the back and forward T slice
-  // so it is 3*2*Vs_t
-  int Vs[4] = {Vs_x, Vs_y, Vs_z, Vs_t};
-  for (int i = 0; i < 4; i++) ghost_sitelink[i] = safe_malloc(8 * Vs[i] * gauge_site_size * gSize);
-
-  // nu |     |
-  //   |_____|
-  //     mu
-
-  for (int nu = 0; nu < 4; nu++) {
-    for (int mu = 0; mu < 4; mu++) {
-      if (nu == mu) {
-        ghost_sitelink_diag[nu * 4 + mu] = NULL;
-      } else {
-        // the other directions
-        int dir1, dir2;
-        for (dir1 = 0; dir1 < 4; dir1++) {
-          if (dir1 != nu && dir1 != mu) { break; }
-        }
-        for (dir2 = 0; dir2 < 4; dir2++) {
-          if (dir2 != nu && dir2 != mu && dir2 != dir1) { break; }
-        }
-        ghost_sitelink_diag[nu * 4 + mu] = safe_malloc(Z[dir1] * Z[dir2] * gauge_site_size * gSize);
-        memset(ghost_sitelink_diag[nu * 4 + mu], 0, Z[dir1] * Z[dir2] * gauge_site_size * gSize);
-      }
-    }
-  }
-  exchange_cpu_sitelink(gParam.x, sitelink, ghost_sitelink, ghost_sitelink_diag, prec, &qudaGaugeParam, optflag);
-  llfat_reference_mg(v_reflink, sitelink, ghost_sitelink, ghost_sitelink_diag, prec, coeff);
+  // the fattening paths reach two sites from the local volume
+  int R[4] = {2, 2, 2, 2};
+  exchange_cpu_sitelink_ex(qudaGaugeParam.X, R, sitelink_ex, QUDA_QDP_GAUGE_ORDER, prec, 0, 4);
+  llfat_reference_ex(v_reflink, sitelink_ex, prec, coeff);
 #else
   llfat_reference(v_reflink, sitelink, prec, coeff);
 #endif
@@ -542,33 +506,7 @@ void computeHISQLinksCPU(void **fatlink, void **longlink, void **fatlink_eps, vo
   //////////////////////////////
 
 #ifdef MULTI_GPU
-  optflag = 0;
-  // we need x,y,z site links in the back and forward T slice
-  // so it is 3*2*Vs_t
-  for (int i = 0; i < 4; i++) ghost_wlink[i] = safe_malloc(8 * Vs[i] * gauge_site_size * gSize);
-
-  // nu |     |
-  //   |_____|
-  //     mu
-
-  for (int nu = 0; nu < 4; nu++) {
-    for (int mu = 0; mu < 4; mu++) {
-      if (nu == mu) {
-        ghost_wlink_diag[nu * 4 + mu] = NULL;
-      } else {
-        // the other directions
-        int dir1, dir2;
-        for (dir1 = 0; dir1 < 4; dir1++) {
-          if (dir1 != nu && dir1 != mu) { break; }
-        }
-        for (dir2 = 0; dir2 < 4; dir2++) {
-          if (dir2 != nu && dir2 != mu && dir2 != dir1) { break; }
-        }
-        ghost_wlink_diag[nu * 4 + mu] = safe_malloc(Z[dir1] * Z[dir2] * gauge_site_size * gSize);
-        memset(ghost_wlink_diag[nu * 4 + mu], 0, Z[dir1] * Z[dir2] * gauge_site_size * gSize);
-      }
-    }
-  }
+  exchange_cpu_sitelink_ex(qudaGaugeParam.X, R, w_reflink_ex, QUDA_QDP_GAUGE_ORDER, qudaGaugeParam.cpu_prec, 0, 4);
 #endif
 
   ////////////////////////////////////////////
@@ -581,16 +519,8 @@ void computeHISQLinksCPU(void **fatlink, void **longlink, void **fatlink_eps, vo
     coeff = (prec == QUDA_DOUBLE_PRECISION) ? (void *)coeff_dp : (void *)coeff_sp;
 
 #ifdef MULTI_GPU
-
-    exchange_cpu_sitelink(qudaGaugeParam.X, w_reflink, ghost_wlink, ghost_wlink_diag, qudaGaugeParam.cpu_prec,
-                          &qudaGaugeParam, optflag);
-    llfat_reference_mg(fatlink, w_reflink, ghost_wlink, ghost_wlink_diag, qudaGaugeParam.cpu_prec, coeff);
-
-    {
-      int R[4] = {2, 2, 2, 2};
-      exchange_cpu_sitelink_ex(qudaGaugeParam.X, R, w_reflink_ex, QUDA_QDP_GAUGE_ORDER, qudaGaugeParam.cpu_prec, 0, 4);
-      computeLongLinkCPU(longlink, w_reflink_ex, qudaGaugeParam.cpu_prec, coeff);
-    }
+    llfat_reference_ex(fatlink, w_reflink_ex, qudaGaugeParam.cpu_prec, coeff);
+    computeLongLinkCPU(longlink, w_reflink_ex, qudaGaugeParam.cpu_prec, coeff);
 #else
     llfat_reference(fatlink, w_reflink, qudaGaugeParam.cpu_prec, coeff);
     computeLongLinkCPU(longlink, w_reflink, qudaGaugeParam.cpu_prec, coeff);
@@ -611,19 +541,9 @@ void computeHISQLinksCPU(void **fatlink, void **longlink, void **fatlink_eps, vo
   coeff = (prec == QUDA_DOUBLE_PRECISION) ? (void *)coeff_dp : (void *)coeff_sp;
 
 #ifdef MULTI_GPU
-  optflag = 0;
-
   // We've already built the extended W fields.
-
-  exchange_cpu_sitelink(qudaGaugeParam.X, w_reflink, ghost_wlink, ghost_wlink_diag, qudaGaugeParam.cpu_prec,
-                        &qudaGaugeParam, optflag);
-  llfat_reference_mg(fatlink, w_reflink, ghost_wlink, ghost_wlink_diag, qudaGaugeParam.cpu_prec, coeff);
-
-  {
-    int R[4] = {2, 2, 2, 2};
-    exchange_cpu_sitelink_ex(qudaGaugeParam.X, R, w_reflink_ex, QUDA_QDP_GAUGE_ORDER, qudaGaugeParam.cpu_prec, 0, 4);
-    computeLongLinkCPU(longlink, w_reflink_ex, qudaGaugeParam.cpu_prec, coeff);
-  }
+  llfat_reference_ex(fatlink, w_reflink_ex, qudaGaugeParam.cpu_prec, coeff);
+  computeLongLinkCPU(longlink, w_reflink_ex, qudaGaugeParam.cpu_prec, coeff);
 #else
   llfat_reference(fatlink, w_reflink, qudaGaugeParam.cpu_prec, coeff);
   computeLongLinkCPU(longlink, w_reflink, qudaGaugeParam.cpu_prec, coeff);
@@ -648,18 +568,6 @@ void computeHISQLinksCPU(void **fatlink, void **longlink, void **fatlink_eps, vo
     host_free(w_reflink_ex[i]);
   }
   host_free(v_sitelink);
-
-#ifdef MULTI_GPU
-  for (int i = 0; i < 4; i++) {
-    host_free(ghost_sitelink[i]);
-    host_free(ghost_wlink[i]);
-    for (int j = 0; j < 4; j++) {
-      if (i == j) continue;
-      host_free(ghost_sitelink_diag[i * 4 + j]);
-      host_free(ghost_wlink_diag[i * 4 + j]);
-    }
-  }
-#endif
 }
 
 void constructStaggeredTestSpinorParam(quda::ColorSpinorParam *cs_param, const QudaInvertParam *inv_param,